@@ -96,11 +96,36 @@ public:
     {
         require(s);
     }
+    bool reserve_contiguous(std::size_t s)
+    {
+        if (pos() + s <= end())
+        {
+            return true;
+        }
+        return do_reserve_contiguous(s);
+    }
 
     virtual void recycle() = 0;
 
+    virtual std::size_t max_contiguous() const noexcept
+    {
+        return boost::min_size_after_recycle<char_type>();
+    }
+
 protected:
 
+    // Called by reserve_contiguous(s) when size() < s.
+    // Shall return whether size() >= s afterwards.
+    virtual bool do_reserve_contiguous(std::size_t s)
+    {
+        if (s <= max_contiguous())
+        {
+            recycle();
+            return pos() + s <= end();
+        }
+        return false;
+    }
+
     underlying_outbuf(char_type* pos_, char_type* end_) noexcept
         : _pos(pos_), _end(end_)
     { }
@@ -170,10 +195,29 @@ public:
     using _underlying_impl::good;
     using _underlying_impl::require;
     using _underlying_impl::ensure;
+    using _underlying_impl::reserve_contiguous;
     using _underlying_impl::recycle;
+    using _underlying_impl::max_contiguous;
+
+    // Tries to write [str, str + len) to the destination without
+    // copying it into the buffer. Returns false if nothing was done.
+    bool write_direct(const CharT* str, std::size_t len)
+    {
+        return do_write_direct(str, len);
+    }
 
 protected:
 
+    // Called by write_direct. Writers that can pass large blocks straight
+    // to their destination override it to first write the content of the
+    // buffer, as recycle() does, and then [str, str + len), and return true.
+    virtual bool do_write_direct(const CharT* str, std::size_t len)
+    {
+        (void) str;
+        (void) len;
+        return false;
+    }
+
     basic_outbuf(CharT* pos_, CharT* end_) noexcept
         : _underlying_impl( reinterpret_cast<_underlying_char_t*>(pos_)
                           , reinterpret_cast<_underlying_char_t*>(end_) )
@@ -202,9 +246,21 @@ public:
 
     virtual void recycle() noexcept = 0;
 
+    bool write_direct(const CharT* str, std::size_t len) noexcept
+    {
+        return do_write_direct(str, len);
+    }
+
 protected:
 
     using basic_outbuf<CharT>::basic_outbuf;
+
+    bool do_write_direct(const CharT* str, std::size_t len) noexcept override
+    {
+        (void) str;
+        (void) len;
+        return false;
+    }
 };
 
 // global functions
@@ -231,9 +287,26 @@ using basic_outbuf_noexcept_switch
     = typename basic_outbuf_noexcept_switch_impl<NoExcept, CharT>
    :: type;
 
+template <typename Outbuf, typename CharT>
+inline auto outbuf_try_write_direct(Outbuf& ob, const CharT* str, std::size_t len, int)
+    -> decltype(ob.write_direct(str, len))
+{
+    return ob.write_direct(str, len);
+}
+
+template <typename Outbuf, typename CharT>
+inline bool outbuf_try_write_direct(Outbuf&, const CharT*, std::size_t, long)
+{
+    return false;
+}
+
 template <typename Outbuf, typename CharT>
 void outbuf_write_continuation(Outbuf& ob, const CharT* str, std::size_t len)
 {
+    if (boost::detail::outbuf_try_write_direct(ob, str, len, 0))
+    {
+        return;
+    }
     auto space = ob.size();
     BOOST_ASSERT(space < len);
     std::memcpy(ob.pos(), str, space * sizeof(CharT));
@@ -292,6 +365,28 @@ void outbuf_put(Outbuf& ob, CharT c)
 
 } // namespace detail
 
+// A string literal whose length is part of the type, so that write
+// does not need to call strlen, and the compiler can copy it with
+// fixed-size moves. It is created by lit("...").
+template <typename CharT, std::size_t Len>
+struct basic_literal
+{
+    static constexpr std::size_t size() noexcept
+    {
+        return Len;
+    }
+
+    const CharT* str;
+};
+
+// str shall be a string literal, or an array whose
+// last element is the only null character
+template <typename CharT, std::size_t N>
+constexpr boost::basic_literal<CharT, N - 1> lit(const CharT (&str)[N]) noexcept
+{
+    return boost::basic_literal<CharT, N - 1>{str};
+}
+
 template <std::size_t CharSize>
 inline void write
     ( boost::underlying_outbuf<CharSize>& ob
@@ -369,6 +464,191 @@ inline void write( boost::basic_outbuf_noexcept<wchar_t>& ob
     boost::detail::outbuf_write(ob, str, std::wcslen(str));
 }
 
+template <typename CharT, std::size_t Len>
+inline void write( boost::basic_outbuf<CharT>& ob
+                 , boost::basic_literal<CharT, Len> literal )
+{
+    boost::detail::outbuf_write(ob, literal.str, Len);
+}
+
+template <typename CharT, std::size_t Len>
+inline void write( boost::basic_outbuf_noexcept<CharT>& ob
+                 , boost::basic_literal<CharT, Len> literal ) noexcept
+{
+    boost::detail::outbuf_write(ob, literal.str, Len);
+}
+
+namespace detail {
+
+template <typename CharT>
+struct outbuf_piece
+{
+    const CharT* str;
+    std::size_t len;
+};
+
+inline std::size_t outbuf_cstr_len(const char* str) noexcept
+{
+    return std::strlen(str);
+}
+
+inline std::size_t outbuf_cstr_len(const wchar_t* str) noexcept
+{
+    return std::wcslen(str);
+}
+
+template <typename CharT>
+inline std::size_t outbuf_cstr_len(const CharT* str) noexcept
+{
+    std::size_t len = 0;
+    while (str[len] != CharT())
+    {
+        ++len;
+    }
+    return len;
+}
+
+// The primary template handles the string views: any type
+// with data() and size() member functions, like std::basic_string
+template <typename CharT, typename Arg>
+struct outbuf_piece_maker
+{
+    static outbuf_piece<CharT> make(const Arg& s) noexcept
+    {
+        return outbuf_piece<CharT>{s.data(), s.size()};
+    }
+};
+
+template <typename CharT>
+struct outbuf_piece_maker<CharT, CharT>
+{
+    static outbuf_piece<CharT> make(const CharT& ch) noexcept
+    {
+        return outbuf_piece<CharT>{&ch, 1};
+    }
+};
+
+template <typename CharT>
+struct outbuf_piece_maker<CharT, const CharT*>
+{
+    static outbuf_piece<CharT> make(const CharT* str) noexcept
+    {
+        return outbuf_piece<CharT>{str, boost::detail::outbuf_cstr_len(str)};
+    }
+};
+
+template <typename CharT>
+struct outbuf_piece_maker<CharT, CharT*>
+    : outbuf_piece_maker<CharT, const CharT*>
+{
+};
+
+template <typename CharT, std::size_t N>
+struct outbuf_piece_maker<CharT, CharT[N]>
+    : outbuf_piece_maker<CharT, const CharT*>
+{
+};
+
+template <typename CharT, std::size_t Len>
+struct outbuf_piece_maker<CharT, boost::basic_literal<CharT, Len>>
+{
+    static outbuf_piece<CharT> make(boost::basic_literal<CharT, Len> literal) noexcept
+    {
+        return outbuf_piece<CharT>{literal.str, Len};
+    }
+};
+
+template <typename CharT>
+inline std::size_t outbuf_pieces_len() noexcept
+{
+    return 0;
+}
+
+template <typename CharT, typename... Pieces>
+inline std::size_t outbuf_pieces_len
+    ( outbuf_piece<CharT> piece
+    , Pieces... pieces ) noexcept
+{
+    return piece.len + boost::detail::outbuf_pieces_len<CharT>(pieces...);
+}
+
+// The pieces are copied by a recursion rather than by a loop over an
+// array, so that each memcpy is inlined, with a constant size when the
+// piece is a character or a literal.
+template <typename CharT>
+inline CharT* outbuf_copy_pieces(CharT* p) noexcept
+{
+    return p;
+}
+
+template <typename CharT, typename... Pieces>
+inline CharT* outbuf_copy_pieces
+    ( CharT* p
+    , outbuf_piece<CharT> piece
+    , Pieces... pieces ) noexcept
+{
+    std::memcpy(p, piece.str, piece.len * sizeof(CharT));
+    return boost::detail::outbuf_copy_pieces(p + piece.len, pieces...);
+}
+
+template <typename Outbuf, typename CharT, typename... Pieces>
+void outbuf_write_pieces_continuation(Outbuf& ob, Pieces... pieces)
+{
+    const outbuf_piece<CharT> arr[] = { pieces... };
+    for (const auto& piece : arr)
+    {
+        boost::detail::outbuf_write(ob, piece.str, piece.len);
+    }
+}
+
+// Checks the space only once for all the pieces. Only when they
+// don't fit altogether, they are written one by one.
+template <typename Outbuf, typename CharT, typename... Pieces>
+inline void outbuf_write_pieces
+    ( Outbuf& ob
+    , outbuf_piece<CharT> piece
+    , Pieces... pieces )
+{
+    auto p = ob.pos();
+    auto total_len = boost::detail::outbuf_pieces_len<CharT>(piece, pieces...);
+    if (p + total_len <= ob.end()) // the common case
+    {
+        ob.advance_to(boost::detail::outbuf_copy_pieces(p, piece, pieces...));
+    }
+    else
+    {
+        boost::detail::outbuf_write_pieces_continuation<Outbuf, CharT>
+            (ob, piece, pieces...);
+    }
+}
+
+} // namespace detail
+
+// Writes all the arguments, that can be characters, null-terminated
+// strings, literals created by lit(), and string views (objects
+// with data() and size() member functions).
+template <typename CharT, typename Arg, typename... Args>
+inline void write_all( boost::basic_outbuf<CharT>& ob
+                     , const Arg& arg
+                     , const Args&... args )
+{
+    boost::detail::outbuf_write_pieces
+        ( ob
+        , boost::detail::outbuf_piece_maker<CharT, Arg>::make(arg)
+        , boost::detail::outbuf_piece_maker<CharT, Args>::make(args)... );
+}
+
+template <typename CharT, typename Arg, typename... Args>
+inline void write_all( boost::basic_outbuf_noexcept<CharT>& ob
+                     , const Arg& arg
+                     , const Args&... args ) noexcept
+{
+    boost::detail::outbuf_write_pieces
+        ( ob
+        , boost::detail::outbuf_piece_maker<CharT, Arg>::make(arg)
+        , boost::detail::outbuf_piece_maker<CharT, Args>::make(args)... );
+}
+
 template <std::size_t CharSize>
 inline void put
     ( boost::underlying_outbuf<CharSize>& ob
@@ -483,6 +763,28 @@ public:
     {
     }
 
+    // Makes the object ready to write into another string,
+    // or again into the same one, as if it were constructed again
+    void reset(CharT* dest, CharT* dest_end) noexcept
+    {
+        BOOST_ASSERT(dest < dest_end);
+        this->set_good(true);
+        this->set_pos(dest);
+        this->set_end(dest_end - 1);
+    }
+
+    void reset(CharT* dest, std::size_t len) noexcept
+    {
+        BOOST_ASSERT(len != 0);
+        reset(dest, dest + len);
+    }
+
+    template <std::size_t N>
+    void reset(CharT (&dest)[N]) noexcept
+    {
+        reset(dest, dest + N);
+    }
+
     void recycle() noexcept override
     {
         if (this->good())
@@ -494,6 +796,11 @@ public:
         this->set_pos(outbuf_garbage_buf<CharT>());
     }
 
+    std::size_t max_contiguous() const noexcept override
+    {
+        return this->good() ? this->size() : min_size_after_recycle<CharT>();
+    }
+
     struct result
     {
         CharT* ptr;
@@ -550,6 +857,58 @@ public:
     }
 };
 
+// Like discarded_outbuf, but counts the characters written, and
+// good() is true, so that nothing is skipped by the writing functions.
+template <typename CharT>
+class size_counting_outbuf final
+    : public boost::basic_outbuf_noexcept<CharT>
+{
+public:
+
+    size_counting_outbuf()
+        : basic_outbuf_noexcept<CharT>
+            { boost::outbuf_garbage_buf<CharT>()
+            , boost::outbuf_garbage_buf_end<CharT>() }
+    {
+    }
+
+    ~size_counting_outbuf() = default;
+
+    void recycle() noexcept override
+    {
+        _count += this->pos() - boost::outbuf_garbage_buf<CharT>();
+        this->set_pos(boost::outbuf_garbage_buf<CharT>());
+    }
+
+    std::size_t count() const noexcept
+    {
+        return _count + (this->pos() - boost::outbuf_garbage_buf<CharT>());
+    }
+
+protected:
+
+    // Large blocks are only counted, not copied into the garbage buffer
+    bool do_write_direct(const CharT*, std::size_t len) noexcept override
+    {
+        _count += len;
+        return true;
+    }
+
+private:
+
+    std::size_t _count = 0;
+};
+
+// Returns the number of characters that f writes into
+// the basic_outbuf<CharT>& it receives as argument.
+template <typename CharT, typename F>
+inline std::size_t measure_size(F&& f)
+{
+    boost::size_counting_outbuf<CharT> ob;
+    f(static_cast<boost::basic_outbuf<CharT>&>(ob));
+    return ob.count();
+}
+
 } // namespace boost
 
 #endif  // BOOST_OUTBUF_HPP
@@ -0,0 +1,406 @@
+#ifndef BOOST_OUTBUF_ASYNC_HPP
+#define BOOST_OUTBUF_ASYNC_HPP
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <boost/outbuf.hpp>
+
+namespace boost {
+
+template <typename CharT>
+constexpr std::size_t async_writer_default_buffer_size()
+{
+    return (64 * 1024) / sizeof(CharT);
+}
+
+// What recycle() does when all buffers are waiting to be written
+enum class async_writer_overflow
+{
+    block, // waits until a buffer is written
+    drop,  // discards the content of the current buffer
+    grow   // allocates another buffer, or blocks if the maximum is reached
+};
+
+namespace detail {
+
+// Lock-free queue of indexes for a single producer and a single consumer
+class spsc_index_queue
+{
+public:
+
+    explicit spsc_index_queue(std::size_t capacity)
+        : _items(new std::size_t[capacity])
+        , _capacity(capacity)
+    {
+    }
+
+    bool push(std::size_t value) noexcept
+    {
+        const std::size_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail - _head.load(std::memory_order_acquire) == _capacity)
+        {
+            return false;
+        }
+        _items[tail % _capacity] = value;
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(std::size_t& value) noexcept
+    {
+        const std::size_t head = _head.load(std::memory_order_relaxed);
+        if (head == _tail.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        value = _items[head % _capacity];
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const noexcept
+    {
+        return _head.load(std::memory_order_acquire)
+            == _tail.load(std::memory_order_acquire);
+    }
+
+    std::size_t size() const noexcept
+    {
+        const std::size_t head = _head.load(std::memory_order_acquire);
+        return _tail.load(std::memory_order_acquire) - head;
+    }
+
+private:
+
+    std::unique_ptr<std::size_t[]> _items;
+    const std::size_t _capacity;
+    // In separate cache lines, since each one is written by a different thread
+    alignas(64) std::atomic<std::size_t> _head {0};
+    alignas(64) std::atomic<std::size_t> _tail {0};
+};
+
+} // namespace detail
+
+// Hands each filled buffer to a thread that writes it into another
+// outbuf object ( the sink ), and continues in a free buffer at once.
+// The sink shall not be used by other threads while this object
+// is not finished, and finish() does not call the sink's finish().
+template <typename CharT>
+class basic_async_writer final: public boost::basic_outbuf_noexcept<CharT>
+{
+public:
+
+    explicit basic_async_writer
+        ( boost::basic_outbuf<CharT>& sink
+        , std::size_t buf_size = boost::async_writer_default_buffer_size<CharT>()
+        , std::size_t buffers_count = 4
+        , boost::async_writer_overflow overflow = boost::async_writer_overflow::block
+        , std::size_t max_buffers_count = 0 )
+        : boost::basic_outbuf_noexcept<CharT>
+            ( boost::outbuf_garbage_buf<CharT>()
+            , boost::outbuf_garbage_buf_end<CharT>() )
+        , _sink(sink)
+        , _overflow(overflow)
+        , _buf_size( buf_size > boost::min_size_after_recycle<CharT>()
+                   ? buf_size : boost::min_size_after_recycle<CharT>() )
+        , _max_buffers_count(_calc_max_buffers_count(buffers_count, overflow, max_buffers_count))
+        , _buffers(new std::unique_ptr<CharT[]>[_max_buffers_count])
+        , _lengths(new std::size_t[_max_buffers_count])
+        , _filled(_max_buffers_count)
+        , _free(_max_buffers_count)
+    {
+        _buffers_count = buffers_count > 2 ? buffers_count : 2;
+        for (std::size_t i = 0; i < _buffers_count; ++i)
+        {
+            _buffers[i].reset(new CharT[_buf_size]);
+            if (i != 0)
+            {
+                _free.push(i);
+            }
+        }
+        this->set_pos(_buffers[0].get());
+        this->set_end(_buffers[0].get() + _buf_size);
+        _thread = std::thread([this]{ _run(); });
+    }
+
+    basic_async_writer(const basic_async_writer&) = delete;
+    basic_async_writer(basic_async_writer&&) = delete;
+
+    // The content written since the last call to recycle() is discarded
+    ~basic_async_writer()
+    {
+        if (_thread.joinable())
+        {
+            _stop_thread();
+        }
+    }
+
+    std::size_t buffer_size() const noexcept
+    {
+        return _buf_size;
+    }
+
+    std::size_t max_contiguous() const noexcept override
+    {
+        return _buf_size;
+    }
+
+    // The number of buffers allocated so far
+    std::size_t buffers_count() const noexcept
+    {
+        return _buffers_count;
+    }
+
+    // The number of filled buffers waiting to be written into the sink
+    std::size_t queue_depth() const noexcept
+    {
+        return _filled.size();
+    }
+
+    // How many times recycle() had to wait for a buffer to be written
+    std::size_t stalls() const noexcept
+    {
+        return _stalls;
+    }
+
+    // The number of characters discarded by the drop overflow policy
+    std::size_t dropped() const noexcept
+    {
+        return _dropped;
+    }
+
+    void recycle() noexcept override
+    {
+        CharT* data = _buffers[_current].get();
+        if (_sink_failed.load(std::memory_order_relaxed))
+        {
+            this->set_good(false);
+        }
+        if (this->good() && this->pos() != data)
+        {
+            _submit();
+        }
+        else
+        {
+            this->set_pos(data);
+        }
+    }
+
+    struct result
+    {
+        std::size_t count;
+        bool success;
+    };
+
+    // Waits until all the content is written into the sink
+    result finish() noexcept
+    {
+        if (this->good() && this->pos() != _buffers[_current].get())
+        {
+            _lengths[_current] = this->pos() - _buffers[_current].get();
+            _filled.push(_current);
+        }
+        if (_thread.joinable())
+        {
+            _stop_thread();
+        }
+        const bool g = this->good() && ! _sink_failed.load(std::memory_order_relaxed);
+        this->set_good(false);
+        this->set_pos(boost::outbuf_garbage_buf<CharT>());
+        this->set_end(boost::outbuf_garbage_buf_end<CharT>());
+        return {_count, g};
+    }
+
+private:
+
+    static std::size_t _calc_max_buffers_count
+        ( std::size_t buffers_count
+        , boost::async_writer_overflow overflow
+        , std::size_t max_buffers_count ) noexcept
+    {
+        buffers_count = buffers_count > 2 ? buffers_count : 2;
+        if (overflow != boost::async_writer_overflow::grow)
+        {
+            return buffers_count;
+        }
+        if (max_buffers_count == 0)
+        {
+            return 16 * buffers_count;
+        }
+        return max_buffers_count > buffers_count ? max_buffers_count : buffers_count;
+    }
+
+    // Called by the producer
+    void _submit() noexcept
+    {
+        const std::size_t len = this->pos() - _buffers[_current].get();
+        std::size_t next;
+        if ( ! _free.pop(next))
+        {
+            if (_overflow == boost::async_writer_overflow::drop)
+            {
+                _dropped += len;
+                this->set_pos(_buffers[_current].get());
+                return;
+            }
+            if ( _overflow == boost::async_writer_overflow::grow
+              && _buffers_count < _max_buffers_count )
+            {
+                next = _buffers_count;
+                _buffers[next].reset(new (std::nothrow) CharT[_buf_size]);
+                if (_buffers[next] != nullptr)
+                {
+                    ++_buffers_count;
+                    _push_filled(len);
+                    _set_current(next);
+                    return;
+                }
+            }
+            _push_filled(len);
+            next = _wait_free_buffer();
+        }
+        else
+        {
+            _push_filled(len);
+        }
+        _set_current(next);
+    }
+
+    void _push_filled(std::size_t len) noexcept
+    {
+        _lengths[_current] = len;
+        _filled.push(_current);
+        // Ensures that either the consumer sees the pushed buffer,
+        // or this thread sees that the consumer is waiting
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (_consumer_waiting.load(std::memory_order_relaxed))
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _consumer_cv.notify_one();
+        }
+    }
+
+    std::size_t _wait_free_buffer() noexcept
+    {
+        ++_stalls;
+        std::size_t index;
+        std::unique_lock<std::mutex> lock(_mutex);
+        _producer_waiting.store(true);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        _producer_cv.wait(lock, [&]{ return _free.pop(index); });
+        _producer_waiting.store(false, std::memory_order_relaxed);
+        return index;
+    }
+
+    void _set_current(std::size_t index) noexcept
+    {
+        _current = index;
+        this->set_pos(_buffers[index].get());
+        this->set_end(_buffers[index].get() + _buf_size);
+    }
+
+    void _stop_thread() noexcept
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop.store(true);
+            _consumer_cv.notify_one();
+        }
+        _thread.join();
+    }
+
+    // The consumer thread
+    void _run() noexcept
+    {
+        std::size_t index;
+        while (true)
+        {
+            if (_filled.pop(index))
+            {
+                _write_into_sink(index);
+                _free.push(index);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (_producer_waiting.load(std::memory_order_relaxed))
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    _producer_cv.notify_one();
+                }
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(_mutex);
+            _consumer_waiting.store(true);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            _consumer_cv.wait(lock, [&]{ return ! _filled.empty() || _stop.load(); });
+            _consumer_waiting.store(false, std::memory_order_relaxed);
+            if (_filled.empty())
+            {
+                return;
+            }
+        }
+    }
+
+    void _write_into_sink(std::size_t index) noexcept
+    {
+        if (_sink_failed.load(std::memory_order_relaxed))
+        {
+            return;
+        }
+        const std::size_t len = _lengths[index];
+#if defined(__cpp_exceptions)
+        try
+        {
+            boost::detail::outbuf_write(_sink, _buffers[index].get(), len);
+        }
+        catch(...)
+        {
+            _sink_failed.store(true, std::memory_order_relaxed);
+            return;
+        }
+#else
+        boost::detail::outbuf_write(_sink, _buffers[index].get(), len);
+#endif
+        if (_sink.good())
+        {
+            _count += len;
+        }
+        else
+        {
+            _sink_failed.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    boost::basic_outbuf<CharT>& _sink;
+    const boost::async_writer_overflow _overflow;
+    const std::size_t _buf_size;
+    const std::size_t _max_buffers_count;
+    std::unique_ptr<std::unique_ptr<CharT[]>[]> _buffers;
+    std::unique_ptr<std::size_t[]> _lengths;
+    std::size_t _buffers_count = 0;
+    std::size_t _current = 0;
+    std::size_t _count = 0; // only accessed by the consumer until it is joined
+    std::size_t _stalls = 0;
+    std::size_t _dropped = 0;
+    boost::detail::spsc_index_queue _filled;
+    boost::detail::spsc_index_queue _free;
+    std::atomic<bool> _sink_failed {false};
+    std::atomic<bool> _stop {false};
+    std::atomic<bool> _producer_waiting {false};
+    std::atomic<bool> _consumer_waiting {false};
+    std::mutex _mutex;
+    std::condition_variable _producer_cv;
+    std::condition_variable _consumer_cv;
+    std::thread _thread;
+};
+
+using async_writer = basic_async_writer<char>;
+
+} // namespace boost
+
+#endif  // BOOST_OUTBUF_ASYNC_HPP
@@ -0,0 +1,812 @@
+#ifndef BOOST_OUTBUF_BASE64_HPP
+#define BOOST_OUTBUF_BASE64_HPP
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <boost/outbuf.hpp>
+#include <boost/outbuf/detail/cpu_features.hpp>
+
+namespace boost {
+
+enum class base64_kernel
+{
+    scalar,
+    ssse3,
+    avx2,
+    avx512vbmi
+};
+
+namespace detail {
+
+template <typename T = void>
+struct base64_tables
+{
+    static const char encode[64];
+
+    // 0xFF for invalid characters
+    static const std::uint8_t decode[256];
+};
+
+template <typename T>
+const char base64_tables<T>::encode[64] =
+    { 'A','B','C','D','E','F','G','H','I','J','K','L','M'
+    , 'N','O','P','Q','R','S','T','U','V','W','X','Y','Z'
+    , 'a','b','c','d','e','f','g','h','i','j','k','l','m'
+    , 'n','o','p','q','r','s','t','u','v','w','x','y','z'
+    , '0','1','2','3','4','5','6','7','8','9','+','/' };
+
+#define BOOST_OUTBUF_B64_X16 \
+    0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF
+
+template <typename T>
+const std::uint8_t base64_tables<T>::decode[256] =
+    { BOOST_OUTBUF_B64_X16
+    , BOOST_OUTBUF_B64_X16
+    , 0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,  62,0xFF,0xFF,0xFF,  63
+    ,   52,  53,  54,  55,  56,  57,  58,  59,  60,  61,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF
+    , 0xFF,   0,   1,   2,   3,   4,   5,   6,   7,   8,   9,  10,  11,  12,  13,  14
+    ,   15,  16,  17,  18,  19,  20,  21,  22,  23,  24,  25,0xFF,0xFF,0xFF,0xFF,0xFF
+    , 0xFF,  26,  27,  28,  29,  30,  31,  32,  33,  34,  35,  36,  37,  38,  39,  40
+    ,   41,  42,  43,  44,  45,  46,  47,  48,  49,  50,  51,0xFF,0xFF,0xFF,0xFF,0xFF
+    , BOOST_OUTBUF_B64_X16, BOOST_OUTBUF_B64_X16, BOOST_OUTBUF_B64_X16
+    , BOOST_OUTBUF_B64_X16, BOOST_OUTBUF_B64_X16, BOOST_OUTBUF_B64_X16
+    , BOOST_OUTBUF_B64_X16, BOOST_OUTBUF_B64_X16 };
+
+#undef BOOST_OUTBUF_B64_X16
+
+// Each kernel encodes `groups` groups of 3 bytes into groups of 4
+// characters, or decodes `quads` groups of 4 characters ( without
+// padding ) into groups of 3 bytes. The decoding kernels stop at
+// the first invalid group and return the number of decoded groups.
+// The SIMD kernels never read or write outside the given ranges.
+
+inline void base64_encode_scalar
+    ( std::uint8_t* dest
+    , const std::uint8_t* src
+    , std::size_t groups ) noexcept
+{
+    const char* alphabet = base64_tables<>::encode;
+    for ( ; groups != 0; --groups, dest += 4, src += 3)
+    {
+        std::uint32_t v = ( static_cast<std::uint32_t>(src[0]) << 16 )
+                        | ( static_cast<std::uint32_t>(src[1]) << 8 )
+                        | src[2];
+        dest[0] = static_cast<std::uint8_t>(alphabet[v >> 18]);
+        dest[1] = static_cast<std::uint8_t>(alphabet[(v >> 12) & 0x3F]);
+        dest[2] = static_cast<std::uint8_t>(alphabet[(v >> 6) & 0x3F]);
+        dest[3] = static_cast<std::uint8_t>(alphabet[v & 0x3F]);
+    }
+}
+
+inline std::size_t base64_decode_scalar
+    ( std::uint8_t* dest
+    , const std::uint8_t* src
+    , std::size_t quads ) noexcept
+{
+    const std::uint8_t* table = base64_tables<>::decode;
+    std::size_t i = 0;
+    for ( ; i < quads; ++i, dest += 3, src += 4)
+    {
+        std::uint32_t a = table[src[0]];
+        std::uint32_t b = table[src[1]];
+        std::uint32_t c = table[src[2]];
+        std::uint32_t d = table[src[3]];
+        if ((a | b | c | d) & 0x80)
+        {
+            break;
+        }
+        std::uint32_t v = (a << 18) | (b << 12) | (c << 6) | d;
+        dest[0] = static_cast<std::uint8_t>(v >> 16);
+        dest[1] = static_cast<std::uint8_t>(v >> 8);
+        dest[2] = static_cast<std::uint8_t>(v);
+    }
+    return i;
+}
+
+#if defined(BOOST_OUTBUF_X86_SIMD)
+
+// The SSSE3 and AVX2 kernels follow the algorithms described by
+// Wojciech Muła and Daniel Lemire in "Faster Base64 Encoding and
+// Decoding Using AVX2 Instructions", and the AVX-512 VBMI kernels
+// the ones of "Base64 encoding and decoding at almost the speed
+// of a memory copy", by the same authors.
+
+__attribute__((target("ssse3")))
+inline __m128i base64_enc_translate_ssse3(__m128i indices) noexcept
+{
+    const __m128i shift_lut = _mm_setr_epi8
+        ( 'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52
+        , '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62
+        , '/' - 63, 'A', 0, 0 );
+    __m128i r = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    const __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+    r = _mm_or_si128(r, _mm_and_si128(less, _mm_set1_epi8(13)));
+    r = _mm_shuffle_epi8(shift_lut, r);
+    return _mm_add_epi8(r, indices);
+}
+
+__attribute__((target("ssse3")))
+inline void base64_encode_ssse3
+    ( std::uint8_t* dest
+    , const std::uint8_t* src
+    , std::size_t groups ) noexcept
+{
+    const __m128i shuf = _mm_set_epi8
+        (10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+    // 16 bytes are loaded to encode 12
+    for ( ; groups >= 6; groups -= 4, src += 12, dest += 16)
+    {
+        __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        in = _mm_shuffle_epi8(in, shuf);
+        const __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+        const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+        const __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+        const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+        const __m128i indices = _mm_or_si128(t1, t3);
+        _mm_storeu_si128( reinterpret_cast<__m128i*>(dest)
+                        , boost::detail::base64_enc_translate_ssse3(indices) );
+    }
+    boost::detail::base64_encode_scalar(dest, src, groups);
+}
+
+__attribute__((target("ssse3")))
+inline std::size_t base64_decode_ssse3
+    ( std::uint8_t* dest
+    , const std::uint8_t* src
+    , std::size_t quads ) noexcept
+{
+    const __m128i lut_lo = _mm_setr_epi8
+        ( 0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11
+        , 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A );
+    const __m128i lut_hi = _mm_setr_epi8
+        ( 0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08
+        , 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10 );
+    const __m128i lut_roll = _mm_setr_epi8
+        ( 0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0 );
+    const __m128i pack = _mm_setr_epi8
+        ( 2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1 );
+    const __m128i mask_2f = _mm_set1_epi8(0x2f);
+
+    std::size_t done = 0;
+    // 16 bytes are stored to decode 12
+    for ( ; quads - done >= 6; done += 4, src += 16, dest += 12)
+    {
+        __m128i str = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        const __m128i hi_nibbles = _mm_and_si128(_mm_srli_epi32(str, 4), mask_2f);
+        const __m128i lo_nibbles = _mm_and_si128(str, mask_2f);
+        const __m128i hi = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+        const __m128i lo = _mm_shuffle_epi8(lut_lo, lo_nibbles);
+        const __m128i valid = _mm_cmpeq_epi8
+            ( _mm_and_si128(lo, hi), _mm_setzero_si128() );
+        if (_mm_movemask_epi8(valid) != 0xFFFF)
+        {
+            break;
+        }
+        const __m128i eq_2f = _mm_cmpeq_epi8(str, mask_2f);
+        const __m128i roll = _mm_shuffle_epi8
+            ( lut_roll, _mm_add_epi8(eq_2f, hi_nibbles) );
+        str = _mm_add_epi8(str, roll);
+        __m128i out = _mm_maddubs_epi16(str, _mm_set1_epi32(0x01400140));
+        out = _mm_madd_epi16(out, _mm_set1_epi32(0x00011000));
+        out = _mm_shuffle_epi8(out, pack);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), out);
+    }
+    return done + boost::detail::base64_decode_scalar(dest, src, quads - done);
+}
+
+__attribute__((target("avx2")))
+inline void base64_encode_avx2
+    ( std::uint8_t* dest
+    , const std::uint8_t* src
+    , std::size_t groups ) noexcept
+{
+    const __m256i shuf = _mm256_set_epi8
+        ( 10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1
+        , 10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1 );
+    const __m256i shift_lut = _mm256_setr_epi8
+        ( 'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52
+        , '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62
+        , '/' - 63, 'A', 0, 0
+        , 'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52
+        , '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62
+        , '/' - 63, 'A', 0, 0 );
+    // 28 bytes are loaded to encode 24
+    for ( ; groups >= 10; groups -= 8, src += 24, dest += 32)
+    {
+        const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 12));
+        __m256i in = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+        in = _mm256_shuffle_epi8(in, shuf);
+        const __m256i t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+        const __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+        const __m256i t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+        const __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+        const __m256i indices = _mm256_or_si256(t1, t3);
+
+        __m256i r = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+        const __m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+        r = _mm256_or_si256(r, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+        r = _mm256_shuffle_epi8(shift_lut, r);
+        r = _mm256_add_epi8(r, indices);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest), r);
+    }
+    boost::detail::base64_encode_ssse3(dest, src, groups);
+}
+
+__attribute__((target("avx2")))
+inline std::size_t base64_decode_avx2
+    ( std::uint8_t* dest
+    , const std::uint8_t* src
+    , std::size_t quads ) noexcept
+{
+    const __m256i lut_lo = _mm256_setr_epi8
+        ( 0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11
+        , 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A
+        , 0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11
+        , 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A );
+    const __m256i lut_hi = _mm256_setr_epi8
+        ( 0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08
+        , 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10
+        , 0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08
+        , 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10 );
+    const __m256i lut_roll = _mm256_setr_epi8
+        ( 0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0
+        , 0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0 );
+    const __m256i pack = _mm256_setr_epi8
+        ( 2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1
+        , 2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1 );
+    const __m256i pack_lanes = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7);
+    const __m256i mask_2f = _mm256_set1_epi8(0x2f);
+
+    std::size_t done = 0;
+    // 32 bytes are stored to decode 24
+    for ( ; quads - done >= 11; done += 8, src += 32, dest += 24)
+    {
+        __m256i str = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+        const __m256i hi_nibbles = _mm256_and_si256(_mm256_srli_epi32(str, 4), mask_2f);
+        const __m256i lo_nibbles = _mm256_and_si256(str, mask_2f);
+        const __m256i hi = _mm256_shuffle_epi8(lut_hi, hi_nibbles);
+        const __m256i lo = _mm256_shuffle_epi8(lut_lo, lo_nibbles);
+        if (! _mm256_testz_si256(lo, hi))
+        {
+            break;
+        }
+        const __m256i eq_2f = _mm256_cmpeq_epi8(str, mask_2f);
+        const __m256i roll = _mm256_shuffle_epi8
+            ( lut_roll, _mm256_add_epi8(eq_2f, hi_nibbles) );
+        str = _mm256_add_epi8(str, roll);
+        __m256i out = _mm256_maddubs_epi16(str, _mm256_set1_epi32(0x01400140));
+        out = _mm256_madd_epi16(out, _mm256_set1_epi32(0x00011000));
+        out = _mm256_shuffle_epi8(out, pack);
+        out = _mm256_permutevar8x32_epi32(out, pack_lanes);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest), out);
+    }
+    return done + boost::detail::base64_decode_ssse3(dest, src, quads - done);
+}
+
+// Some versions of GCC emit false -Wmaybe-uninitialized warnings
+// from inside the AVX-512 intrinsics.
+#if defined(__GNUC__) && ! defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+template <typename T = void>
+struct base64_vbmi_tables
+{
+    // 0x80 for invalid characters
+    static const std::uint8_t decode[128];
+    static const std::uint8_t pack[64];
+};
+
+template <typename T>
+const std::uint8_t base64_vbmi_tables<T>::decode[128] =
+    { 0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80
+    , 0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80
+    , 0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,  62,0x80,0x80,0x80,  63
+    ,   52,  53,  54,  55,  56,  57,  58,  59,  60,  61,0x80,0x80,0x80,0x80,0x80,0x80
+    , 0x80,   0,   1,   2,   3,   4,   5,   6,   7,   8,   9,  10,  11,  12,  13,  14
+    ,   15,  16,  17,  18,  19,  20,  21,  22,  23,  24,  25,0x80,0x80,0x80,0x80,0x80
+    , 0x80,  26,  27,  28,  29,  30,  31,  32,  33,  34,  35,  36,  37,  38,  39,  40
+    ,   41,  42,  43,  44,  45,  46,  47,  48,  49,  50,  51,0x80,0x80,0x80,0x80,0x80 };
+
+template <typename T>
+const std::uint8_t base64_vbmi_tables<T>::pack[64] =
+    {  2,  1,  0,  6,  5,  4, 10,  9,  8, 14, 13, 12, 18, 17, 16, 22
+    , 21, 20, 26, 25, 24, 30, 29, 28, 34, 33, 32, 38, 37, 36, 42, 41
+    , 40, 46, 45, 44, 50, 49, 48, 54, 53, 52, 58, 57, 56, 62, 61, 60
+    ,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0 };
+
+__attribute__((target("avx512f,avx512bw,avx512vbmi")))
+inline void base64_encode_avx512vbmi
+    ( std::uint8_t* dest
+    , const std::uint8_t* src
+    , std::size_t groups ) noexcept
+{
+    const __m512i shuf = _mm512_setr_epi32
+        ( 0x01020001, 0x04050304, 0x07080607, 0x0a0b090a
+        , 0x0d0e0c0d, 0x10110f10, 0x13141213, 0x16171516
+        , 0x191a1819, 0x1c1d1b1c, 0x1f201e1f, 0x22232122
+        , 0x25262425, 0x28292728, 0x2b2c2a2b, 0x2e2f2d2e );
+    const __m512i alphabet = _mm512_loadu_si512(base64_tables<>::encode);
+    const __m512i shifts = _mm512_set1_epi64(0x3036242a1016040aLL);
+    const __mmask64 load_mask = 0x0000FFFFFFFFFFFFULL;
+    for ( ; groups >= 16; groups -= 16, src += 48, dest += 64)
+    {
+        const __m512i v = _mm512_maskz_loadu_epi8(load_mask, src);
+        const __m512i in = _mm512_permutexvar_epi8(shuf, v);
+        const __m512i indices = _mm512_multishift_epi64_epi8(shifts, in);
+        const __m512i r = _mm512_permutexvar_epi8(indices, alphabet);
+        _mm512_storeu_si512(dest, r);
+    }
+    boost::detail::base64_encode_avx2(dest, src, groups);
+}
+
+__attribute__((target("avx512f,avx512bw,avx512vbmi")))
+inline std::size_t base64_decode_avx512vbmi
+    ( std::uint8_t* dest
+    , const std::uint8_t* src
+    , std::size_t quads ) noexcept
+{
+    const __m512i lookup_0 = _mm512_loadu_si512(base64_vbmi_tables<>::decode);
+    const __m512i lookup_1 = _mm512_loadu_si512(base64_vbmi_tables<>::decode + 64);
+    const __m512i pack = _mm512_loadu_si512(base64_vbmi_tables<>::pack);
+    const __mmask64 store_mask = 0x0000FFFFFFFFFFFFULL;
+
+    std::size_t done = 0;
+    for ( ; quads - done >= 16; done += 16, src += 64, dest += 48)
+    {
+        const __m512i in = _mm512_loadu_si512(src);
+        const __m512i translated = _mm512_permutex2var_epi8(lookup_0, in, lookup_1);
+        if (_mm512_movepi8_mask(_mm512_or_si512(translated, in)) != 0)
+        {
+            break;
+        }
+        __m512i out = _mm512_maddubs_epi16(translated, _mm512_set1_epi32(0x01400140));
+        out = _mm512_madd_epi16(out, _mm512_set1_epi32(0x00011000));
+        out = _mm512_permutexvar_epi8(pack, out);
+        _mm512_mask_storeu_epi8(dest, store_mask, out);
+    }
+    return done + boost::detail::base64_decode_avx2(dest, src, quads - done);
+}
+
+#if defined(__GNUC__) && ! defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif // defined(BOOST_OUTBUF_X86_SIMD)
+
+struct base64_kernel_functions
+{
+    void (*encode)(std::uint8_t*, const std::uint8_t*, std::size_t);
+    std::size_t (*decode)(std::uint8_t*, const std::uint8_t*, std::size_t);
+};
+
+// Falls back to the scalar kernel when k is not supported
+inline base64_kernel_functions base64_functions(base64_kernel k) noexcept
+{
+#if defined(BOOST_OUTBUF_X86_SIMD)
+
+    const auto& cpu = boost::detail::get_cpu_features();
+    switch (k)
+    {
+        case base64_kernel::avx512vbmi:
+            if (cpu.avx512vbmi)
+            {
+                return { boost::detail::base64_encode_avx512vbmi
+                       , boost::detail::base64_decode_avx512vbmi };
+            }
+            break;
+        case base64_kernel::avx2:
+            if (cpu.avx2)
+            {
+                return { boost::detail::base64_encode_avx2
+                       , boost::detail::base64_decode_avx2 };
+            }
+            break;
+        case base64_kernel::ssse3:
+            if (cpu.ssse3)
+            {
+                return { boost::detail::base64_encode_ssse3
+                       , boost::detail::base64_decode_ssse3 };
+            }
+            break;
+        default:
+            break;
+    }
+
+#else
+
+    (void) k;
+
+#endif // defined(BOOST_OUTBUF_X86_SIMD)
+
+    return { boost::detail::base64_encode_scalar
+           , boost::detail::base64_decode_scalar };
+}
+
+inline void base64_encode_groups
+    ( boost::underlying_outbuf<1>& dest
+    , const std::uint8_t* src
+    , std::size_t groups
+    , void (*encode)(std::uint8_t*, const std::uint8_t*, std::size_t) )
+{
+    while (groups != 0)
+    {
+        std::size_t space = dest.size() / 4;
+        if (space == 0)
+        {
+            dest.recycle();
+            continue;
+        }
+        std::size_t n = space < groups ? space : groups;
+        encode(dest.pos(), src, n);
+        dest.advance(4 * n);
+        src += 3 * n;
+        groups -= n;
+    }
+}
+
+// Encodes the last 1 or 2 bytes, with padding
+inline void base64_encode_tail
+    ( boost::underlying_outbuf<1>& dest
+    , const std::uint8_t* src
+    , std::size_t len )
+{
+    BOOST_ASSERT(len == 1 || len == 2);
+    const char* alphabet = base64_tables<>::encode;
+    dest.require(4);
+    auto p = dest.pos();
+    std::uint32_t v = static_cast<std::uint32_t>(src[0]) << 16;
+    if (len == 2)
+    {
+        v |= static_cast<std::uint32_t>(src[1]) << 8;
+    }
+    p[0] = static_cast<std::uint8_t>(alphabet[v >> 18]);
+    p[1] = static_cast<std::uint8_t>(alphabet[(v >> 12) & 0x3F]);
+    p[2] = len == 2 ? static_cast<std::uint8_t>(alphabet[(v >> 6) & 0x3F]) : '=';
+    p[3] = '=';
+    dest.advance(4);
+}
+
+// Decodes the last group, that may end with one or two '='.
+inline bool base64_decode_tail
+    ( boost::underlying_outbuf<1>& dest
+    , const std::uint8_t* src )
+{
+    const std::uint8_t* table = base64_tables<>::decode;
+    std::uint32_t a = table[src[0]];
+    std::uint32_t b = table[src[1]];
+    if (((a | b) & 0x80) || src[3] != '=')
+    {
+        return false;
+    }
+    std::uint32_t v = (a << 18) | (b << 12);
+    if (src[2] == '=')
+    {
+        dest.require(1);
+        dest.pos()[0] = static_cast<std::uint8_t>(v >> 16);
+        dest.advance(1);
+        return true;
+    }
+    std::uint32_t c = table[src[2]];
+    if (c & 0x80)
+    {
+        return false;
+    }
+    v |= c << 6;
+    dest.require(2);
+    dest.pos()[0] = static_cast<std::uint8_t>(v >> 16);
+    dest.pos()[1] = static_cast<std::uint8_t>(v >> 8);
+    dest.advance(2);
+    return true;
+}
+
+enum class base64_decode_status { ok, padded, error };
+
+// Decodes `quads` groups of 4 characters. Only the last one may
+// contain padding, in which case base64_decode_status::padded is returned.
+inline base64_decode_status base64_decode_quads
+    ( boost::underlying_outbuf<1>& dest
+    , const std::uint8_t* src
+    , std::size_t quads
+    , std::size_t (*decode)(std::uint8_t*, const std::uint8_t*, std::size_t) )
+{
+    while (quads != 0)
+    {
+        std::size_t space = dest.size() / 3;
+        if (space == 0)
+        {
+            dest.recycle();
+            continue;
+        }
+        std::size_t n = space < quads ? space : quads;
+        std::size_t done = decode(dest.pos(), src, n);
+        dest.advance(3 * done);
+        src += 4 * done;
+        quads -= done;
+        if (done != n)
+        {
+            if (quads == 1 && boost::detail::base64_decode_tail(dest, src))
+            {
+                return base64_decode_status::padded;
+            }
+            return base64_decode_status::error;
+        }
+    }
+    return base64_decode_status::ok;
+}
+
+} // namespace detail
+
+inline bool base64_kernel_supported(boost::base64_kernel k) noexcept
+{
+#if defined(BOOST_OUTBUF_X86_SIMD)
+
+    const auto& cpu = boost::detail::get_cpu_features();
+    switch (k)
+    {
+        case base64_kernel::avx512vbmi: return cpu.avx512vbmi;
+        case base64_kernel::avx2:       return cpu.avx2;
+        case base64_kernel::ssse3:      return cpu.ssse3;
+        default:                        return true;
+    }
+
+#else
+
+    return k == base64_kernel::scalar;
+
+#endif // defined(BOOST_OUTBUF_X86_SIMD)
+}
+
+inline boost::base64_kernel base64_best_kernel() noexcept
+{
+    static const base64_kernel k
+        = boost::base64_kernel_supported(base64_kernel::avx512vbmi) ? base64_kernel::avx512vbmi
+        : boost::base64_kernel_supported(base64_kernel::avx2)       ? base64_kernel::avx2
+        : boost::base64_kernel_supported(base64_kernel::ssse3)      ? base64_kernel::ssse3
+        : base64_kernel::scalar;
+    return k;
+}
+
+inline void base64_encode
+    ( boost::underlying_outbuf<1>& dest
+    , const void* data
+    , std::size_t len
+    , boost::base64_kernel k = boost::base64_best_kernel() )
+{
+    auto src = static_cast<const std::uint8_t*>(data);
+    std::size_t groups = len / 3;
+    boost::detail::base64_encode_groups
+        ( dest, src, groups, boost::detail::base64_functions(k).encode );
+    if (len % 3 != 0)
+    {
+        boost::detail::base64_encode_tail(dest, src + 3 * groups, len % 3);
+    }
+}
+
+template <typename CharT>
+inline typename std::enable_if<sizeof(CharT) == 1>::type base64_encode
+    ( boost::basic_outbuf<CharT>& dest
+    , const void* data
+    , std::size_t len
+    , boost::base64_kernel k = boost::base64_best_kernel() )
+{
+    boost::base64_encode(dest.as_underlying(), data, len, k);
+}
+
+// Returns false if [str, str + len) is not valid base64 content.
+// In this case, part of it may have been already decoded.
+inline bool base64_decode
+    ( boost::underlying_outbuf<1>& dest
+    , const char* str
+    , std::size_t len
+    , boost::base64_kernel k = boost::base64_best_kernel() )
+{
+    if (len % 4 != 0)
+    {
+        return false;
+    }
+    auto status = boost::detail::base64_decode_quads
+        ( dest, reinterpret_cast<const std::uint8_t*>(str), len / 4
+        , boost::detail::base64_functions(k).decode );
+    return status != boost::detail::base64_decode_status::error;
+}
+
+template <typename CharT>
+inline typename std::enable_if<sizeof(CharT) == 1, bool>::type base64_decode
+    ( boost::basic_outbuf<CharT>& dest
+    , const char* str
+    , std::size_t len
+    , boost::base64_kernel k = boost::base64_best_kernel() )
+{
+    return boost::base64_decode(dest.as_underlying(), str, len, k);
+}
+
+// Encodes to base64 everything written into it.
+template <typename CharT>
+class basic_base64_encoder final: public boost::basic_outbuf<CharT>
+{
+    static_assert(sizeof(CharT) == 1, "CharT must be a single byte type");
+
+public:
+
+    explicit basic_base64_encoder
+        ( boost::underlying_outbuf<1>& dest
+        , boost::base64_kernel k = boost::base64_best_kernel() )
+        : boost::basic_outbuf<CharT>(reinterpret_cast<CharT*>(_buf), _buf_size)
+        , _dest(dest)
+        , _encode(boost::detail::base64_functions(k).encode)
+    {
+    }
+
+    template <typename DestCharT, typename = typename std::enable_if<sizeof(DestCharT) == 1>::type>
+    explicit basic_base64_encoder
+        ( boost::basic_outbuf<DestCharT>& dest
+        , boost::base64_kernel k = boost::base64_best_kernel() )
+        : basic_base64_encoder(dest.as_underlying(), k)
+    {
+    }
+
+    basic_base64_encoder() = delete;
+    basic_base64_encoder(const basic_base64_encoder&) = delete;
+    basic_base64_encoder(basic_base64_encoder&&) = delete;
+
+    // Encodes all complete groups of 3 bytes. The remaining
+    // 1 or 2 bytes are kept in the buffer.
+    void recycle() override
+    {
+        auto p = reinterpret_cast<std::uint8_t*>(this->pos());
+        this->set_pos(reinterpret_cast<CharT*>(_buf));
+        if (this->good())
+        {
+            std::size_t groups = (p - _buf) / 3;
+            boost::detail::base64_encode_groups(_dest, _buf, groups, _encode);
+            std::size_t remaining = (p - _buf) % 3;
+            std::memmove(_buf, _buf + 3 * groups, remaining);
+            this->set_pos(reinterpret_cast<CharT*>(_buf + remaining));
+        }
+    }
+
+    // Encodes the remaining content, with padding.
+    void finish()
+    {
+        auto p = reinterpret_cast<std::uint8_t*>(this->pos());
+        bool g = this->good();
+        this->set_pos(reinterpret_cast<CharT*>(_buf));
+        this->set_good(false);
+        if (g)
+        {
+            std::size_t groups = (p - _buf) / 3;
+            boost::detail::base64_encode_groups(_dest, _buf, groups, _encode);
+            std::size_t remaining = (p - _buf) % 3;
+            if (remaining != 0)
+            {
+                boost::detail::base64_encode_tail
+                    ( _dest, _buf + 3 * groups, remaining );
+            }
+        }
+    }
+
+private:
+
+    static constexpr std::size_t _buf_size = 3 * 512;
+
+    boost::underlying_outbuf<1>& _dest;
+    void (*_encode)(std::uint8_t*, const std::uint8_t*, std::size_t);
+    std::uint8_t _buf[_buf_size];
+};
+
+// Decodes the base64 content written into it.
+template <typename CharT>
+class basic_base64_decoder final: public boost::basic_outbuf<CharT>
+{
+    static_assert(sizeof(CharT) == 1, "CharT must be a single byte type");
+
+public:
+
+    explicit basic_base64_decoder
+        ( boost::underlying_outbuf<1>& dest
+        , boost::base64_kernel k = boost::base64_best_kernel() )
+        : boost::basic_outbuf<CharT>(reinterpret_cast<CharT*>(_buf), _buf_size)
+        , _dest(dest)
+        , _decode(boost::detail::base64_functions(k).decode)
+    {
+    }
+
+    template <typename DestCharT, typename = typename std::enable_if<sizeof(DestCharT) == 1>::type>
+    explicit basic_base64_decoder
+        ( boost::basic_outbuf<DestCharT>& dest
+        , boost::base64_kernel k = boost::base64_best_kernel() )
+        : basic_base64_decoder(dest.as_underlying(), k)
+    {
+    }
+
+    basic_base64_decoder() = delete;
+    basic_base64_decoder(const basic_base64_decoder&) = delete;
+    basic_base64_decoder(basic_base64_decoder&&) = delete;
+
+    // Decodes all complete groups of 4 characters. The remaining
+    // characters are kept in the buffer. Calls set_good(false)
+    // if the content is invalid.
+    void recycle() override
+    {
+        auto p = reinterpret_cast<std::uint8_t*>(this->pos());
+        this->set_pos(reinterpret_cast<CharT*>(_buf));
+        if (this->good())
+        {
+            std::size_t quads = (p - _buf) / 4;
+            std::size_t remaining = (p - _buf) % 4;
+            _decode_quads(quads);
+            std::memmove(_buf, _buf + 4 * quads, remaining);
+            this->set_pos(reinterpret_cast<CharT*>(_buf + remaining));
+        }
+    }
+
+    // Decodes the remaining content. Returns false if the whole
+    // content written into this object is not valid base64.
+    bool finish()
+    {
+        auto p = reinterpret_cast<std::uint8_t*>(this->pos());
+        bool g = this->good();
+        this->set_pos(reinterpret_cast<CharT*>(_buf));
+        this->set_good(false);
+        if (g)
+        {
+            std::size_t count = p - _buf;
+            if (count % 4 != 0)
+            {
+                return false;
+            }
+            this->set_good(true);
+            _decode_quads(count / 4);
+            g = this->good();
+            this->set_good(false);
+        }
+        return g;
+    }
+
+private:
+
+    void _decode_quads(std::size_t quads)
+    {
+        if (quads != 0)
+        {
+            if (_padded)
+            {
+                this->set_good(false);
+                return;
+            }
+            auto status = boost::detail::base64_decode_quads
+                ( _dest, _buf, quads, _decode );
+            if (status == boost::detail::base64_decode_status::error)
+            {
+                this->set_good(false);
+            }
+            _padded = (status == boost::detail::base64_decode_status::padded);
+        }
+    }
+
+    static constexpr std::size_t _buf_size = 4 * 512;
+
+    boost::underlying_outbuf<1>& _dest;
+    std::size_t (*_decode)(std::uint8_t*, const std::uint8_t*, std::size_t);
+    bool _padded = false;
+    std::uint8_t _buf[_buf_size];
+};
+
+using base64_encoder = basic_base64_encoder<char>;
+using base64_decoder = basic_base64_decoder<char>;
+
+#if defined(__cpp_lib_byte)
+using bin_base64_encoder = basic_base64_encoder<std::byte>;
+#endif
+
+} // namespace boost
+
+#endif  // BOOST_OUTBUF_BASE64_HPP
@@ -0,0 +1,427 @@
+#ifndef BOOST_OUTBUF_BUFFER_POOL_HPP
+#define BOOST_OUTBUF_BUFFER_POOL_HPP
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace boost {
+
+class outbuf_buffer_pool;
+
+namespace detail {
+
+// Size classes are the powers of two from 1 KiB to 64 MiB
+constexpr unsigned outbuf_pool_min_class_shift = 10;
+constexpr unsigned outbuf_pool_classes_count = 17;
+// Only the size classes up to 512 KiB are kept in the thread caches,
+// since their blocks are not counted in max_cached_bytes. So a thread
+// holds at most eight blocks of each, which is less than 8 MiB per pool.
+constexpr unsigned outbuf_pool_thread_cached_classes = 10;
+// How many blocks of each size class a thread keeps for itself
+constexpr unsigned outbuf_pool_thread_cache_depth = 8;
+
+// The blocks a thread keeps for one pool. It is only used by that
+// thread, except by the pool's destructor and statistics().
+struct outbuf_pool_thread_cache
+{
+    std::uint64_t pool_id;
+    boost::outbuf_buffer_pool* pool; // nullptr once the pool is destroyed
+    outbuf_pool_thread_cache* thread_next;
+    outbuf_pool_thread_cache* pool_prev;
+    outbuf_pool_thread_cache* pool_next;
+    unsigned counts[outbuf_pool_thread_cached_classes];
+    void* blocks[outbuf_pool_thread_cached_classes][outbuf_pool_thread_cache_depth];
+    // only written by the thread, hence loaded and stored without a lock prefix
+    std::atomic<std::size_t> hits;
+};
+
+// Guards the links between pools and thread caches
+inline std::mutex& outbuf_pool_registry_mutex()
+{
+    static std::mutex m;
+    return m;
+}
+
+// The thread caches of the current thread, one for each pool it used
+struct outbuf_pool_thread_caches
+{
+    outbuf_pool_thread_cache* first = nullptr;
+
+    ~outbuf_pool_thread_caches();
+};
+
+inline outbuf_pool_thread_caches& outbuf_pool_current_thread_caches()
+{
+    static thread_local outbuf_pool_thread_caches caches;
+    return caches;
+}
+
+} // namespace detail
+
+// Keeps the buffers of outbuf objects to be reused by others, so that
+// constructing a writer does not allocate memory in the steady state.
+// Blocks are grouped in size classes of powers of two and are aligned
+// to 64 bytes. Each thread first looks in its own cache, then in the
+// pool's shared lists, that are guarded by a mutex.
+class outbuf_buffer_pool
+{
+public:
+
+    static constexpr std::size_t alignment = 64;
+
+    // With huge_pages, blocks of 2 MiB or more are aligned to 2 MiB, and
+    // on Linux the kernel is advised to back them with transparent huge pages
+    explicit outbuf_buffer_pool
+        ( std::size_t max_cached_bytes = 64 * 1024 * 1024
+        , bool huge_pages = false ) noexcept
+        : _max_cached_bytes(max_cached_bytes)
+        , _huge_pages(huge_pages)
+        , _id(_next_id())
+    {
+        for (unsigned i = 0; i < _classes_count; ++i)
+        {
+            _shared[i] = nullptr;
+        }
+    }
+
+    outbuf_buffer_pool(const outbuf_buffer_pool&) = delete;
+    outbuf_buffer_pool(outbuf_buffer_pool&&) = delete;
+
+    // No thread shall be using the pool, and all blocks
+    // shall have been deallocated
+    ~outbuf_buffer_pool()
+    {
+        std::lock_guard<std::mutex> lock(boost::detail::outbuf_pool_registry_mutex());
+        for (auto c = _caches; c != nullptr; c = c->pool_next)
+        {
+            _free_thread_cache_blocks(c);
+            c->pool = nullptr;
+        }
+        for (unsigned i = 0; i < _classes_count; ++i)
+        {
+            void* p = _shared[i];
+            while (p != nullptr)
+            {
+                void* next = *static_cast<void**>(p);
+                _free_block(p, _class_size(i));
+                p = next;
+            }
+        }
+    }
+
+    // The size of the block returned by allocate(bytes), which may be used entirely
+    static std::size_t rounded_size(std::size_t bytes) noexcept
+    {
+        const unsigned c = _class_of(bytes);
+        return c < _classes_count ? _class_size(c) : _round_up(bytes, alignment);
+    }
+
+    // Returns nullptr on failure
+    void* allocate(std::size_t bytes) noexcept
+    {
+        const unsigned c = _class_of(bytes);
+        if (c >= _classes_count)
+        {
+            _misses.fetch_add(1, std::memory_order_relaxed);
+            return _allocate_block(_round_up(bytes, alignment));
+        }
+        auto cache = c < _thread_cached_classes ? _thread_cache() : nullptr;
+        if (cache != nullptr && cache->counts[c] != 0)
+        {
+            cache->hits.store( cache->hits.load(std::memory_order_relaxed) + 1
+                             , std::memory_order_relaxed );
+            return cache->blocks[c][--cache->counts[c]];
+        }
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            void* p = _shared[c];
+            if (p != nullptr)
+            {
+                _shared[c] = *static_cast<void**>(p);
+                _cached_bytes -= _class_size(c);
+                _shared_hits.fetch_add(1, std::memory_order_relaxed);
+                return p;
+            }
+        }
+        _misses.fetch_add(1, std::memory_order_relaxed);
+        return _allocate_block(_class_size(c));
+    }
+
+    // bytes shall be the value passed to allocate
+    void deallocate(void* p, std::size_t bytes) noexcept
+    {
+        if (p == nullptr)
+        {
+            return;
+        }
+        const unsigned c = _class_of(bytes);
+        if (c >= _classes_count)
+        {
+            _free_block(p, _round_up(bytes, alignment));
+            return;
+        }
+        auto cache = c < _thread_cached_classes ? _thread_cache() : nullptr;
+        if (cache != nullptr && cache->counts[c] < _thread_cache_depth)
+        {
+            cache->blocks[c][cache->counts[c]++] = p;
+            return;
+        }
+        _return_to_shared(p, c);
+    }
+
+    struct stats
+    {
+        std::size_t thread_cache_hits;
+        std::size_t shared_hits;
+        std::size_t misses;
+        std::size_t shared_cached_bytes;
+    };
+
+    stats statistics() const
+    {
+        stats s;
+        std::lock_guard<std::mutex> lock(boost::detail::outbuf_pool_registry_mutex());
+        s.thread_cache_hits = _retired_hits;
+        for (auto c = _caches; c != nullptr; c = c->pool_next)
+        {
+            s.thread_cache_hits += c->hits.load(std::memory_order_relaxed);
+        }
+        s.shared_hits = _shared_hits.load(std::memory_order_relaxed);
+        s.misses = _misses.load(std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock2(_mutex);
+        s.shared_cached_bytes = _cached_bytes;
+        return s;
+    }
+
+private:
+
+    friend struct boost::detail::outbuf_pool_thread_caches;
+
+    using thread_cache = boost::detail::outbuf_pool_thread_cache;
+
+    static constexpr unsigned _min_class_shift = boost::detail::outbuf_pool_min_class_shift;
+    static constexpr unsigned _classes_count = boost::detail::outbuf_pool_classes_count;
+    static constexpr unsigned _thread_cached_classes
+        = boost::detail::outbuf_pool_thread_cached_classes;
+    static constexpr unsigned _thread_cache_depth
+        = boost::detail::outbuf_pool_thread_cache_depth;
+    static constexpr std::size_t _huge_page_size = 2 * 1024 * 1024;
+
+    static std::uint64_t _next_id() noexcept
+    {
+        static std::atomic<std::uint64_t> id {0};
+        return ++id;
+    }
+
+    static std::size_t _round_up(std::size_t bytes, std::size_t a) noexcept
+    {
+        return (bytes + a - 1) / a * a;
+    }
+
+    static unsigned _class_of(std::size_t bytes) noexcept
+    {
+        unsigned c = 0;
+        while (c < _classes_count && _class_size(c) < bytes)
+        {
+            ++c;
+        }
+        return c;
+    }
+
+    static constexpr std::size_t _class_size(unsigned c) noexcept
+    {
+        return std::size_t(1) << (c + _min_class_shift);
+    }
+
+    void* _allocate_block(std::size_t size) noexcept
+    {
+        const bool huge = _huge_pages && size >= _huge_page_size;
+        std::size_t a = alignment;
+        if (huge)
+        {
+            a = _huge_page_size;
+        }
+#if defined(_WIN32)
+        void* p = ::_aligned_malloc(size, a);
+#else
+        void* p = nullptr;
+        if (::posix_memalign(&p, a, size) != 0)
+        {
+            return nullptr;
+        }
+#  if defined(MADV_HUGEPAGE)
+        if (huge)
+        {
+            (void) ::madvise(p, size, MADV_HUGEPAGE);
+        }
+#  endif
+#endif
+        return p;
+    }
+
+    static void _free_block(void* p, std::size_t) noexcept
+    {
+#if defined(_WIN32)
+        ::_aligned_free(p);
+#else
+        std::free(p);
+#endif
+    }
+
+    void _return_to_shared(void* p, unsigned c) noexcept
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_cached_bytes + _class_size(c) <= _max_cached_bytes)
+            {
+                *static_cast<void**>(p) = _shared[c];
+                _shared[c] = p;
+                _cached_bytes += _class_size(c);
+                return;
+            }
+        }
+        _free_block(p, _class_size(c));
+    }
+
+    void _free_thread_cache_blocks(thread_cache* cache) noexcept
+    {
+        for (unsigned i = 0; i < _thread_cached_classes; ++i)
+        {
+            for (unsigned j = 0; j < cache->counts[i]; ++j)
+            {
+                _free_block(cache->blocks[i][j], _class_size(i));
+            }
+            cache->counts[i] = 0;
+        }
+    }
+
+    thread_cache* _thread_cache() noexcept
+    {
+        auto& caches = boost::detail::outbuf_pool_current_thread_caches();
+        for (auto c = caches.first; c != nullptr; c = c->thread_next)
+        {
+            if (c->pool_id == _id)
+            {
+                return c;
+            }
+        }
+        return _new_thread_cache(caches);
+    }
+
+    thread_cache* _new_thread_cache(boost::detail::outbuf_pool_thread_caches& caches) noexcept
+    {
+        auto cache = new (std::nothrow) thread_cache;
+        if (cache == nullptr)
+        {
+            return nullptr;
+        }
+        cache->pool_id = _id;
+        cache->pool = this;
+        for (unsigned i = 0; i < _thread_cached_classes; ++i)
+        {
+            cache->counts[i] = 0;
+        }
+        cache->hits.store(0, std::memory_order_relaxed);
+
+        std::lock_guard<std::mutex> lock(boost::detail::outbuf_pool_registry_mutex());
+        // Drops the caches of the pools that no longer exist
+        auto link = &caches.first;
+        while (*link != nullptr)
+        {
+            auto c = *link;
+            if (c->pool == nullptr)
+            {
+                *link = c->thread_next;
+                delete c;
+            }
+            else
+            {
+                link = &c->thread_next;
+            }
+        }
+        cache->thread_next = caches.first;
+        caches.first = cache;
+        cache->pool_prev = nullptr;
+        cache->pool_next = _caches;
+        if (_caches != nullptr)
+        {
+            _caches->pool_prev = cache;
+        }
+        _caches = cache;
+        return cache;
+    }
+
+    // Called at the exit of the thread, with the registry mutex locked
+    void _release_thread_cache(thread_cache* cache) noexcept
+    {
+        for (unsigned i = 0; i < _thread_cached_classes; ++i)
+        {
+            for (unsigned j = 0; j < cache->counts[i]; ++j)
+            {
+                _return_to_shared(cache->blocks[i][j], i);
+            }
+        }
+        _retired_hits += cache->hits.load(std::memory_order_relaxed);
+        if (cache->pool_prev != nullptr)
+        {
+            cache->pool_prev->pool_next = cache->pool_next;
+        }
+        else
+        {
+            _caches = cache->pool_next;
+        }
+        if (cache->pool_next != nullptr)
+        {
+            cache->pool_next->pool_prev = cache->pool_prev;
+        }
+    }
+
+    const std::size_t _max_cached_bytes;
+    const bool _huge_pages;
+    const std::uint64_t _id;
+    // guarded by the registry mutex
+    thread_cache* _caches = nullptr;
+    std::size_t _retired_hits = 0;
+    std::atomic<std::size_t> _shared_hits {0};
+    std::atomic<std::size_t> _misses {0};
+    mutable std::mutex _mutex;
+    // guarded by _mutex
+    void* _shared[_classes_count];
+    std::size_t _cached_bytes = 0;
+};
+
+namespace detail {
+
+inline outbuf_pool_thread_caches::~outbuf_pool_thread_caches()
+{
+    std::lock_guard<std::mutex> lock(boost::detail::outbuf_pool_registry_mutex());
+    while (first != nullptr)
+    {
+        auto c = first;
+        first = c->thread_next;
+        if (c->pool != nullptr)
+        {
+            c->pool->_release_thread_cache(c);
+        }
+        delete c;
+    }
+}
+
+} // namespace detail
+
+} // namespace boost
+
+#endif  // BOOST_OUTBUF_BUFFER_POOL_HPP
@@ -5,21 +5,84 @@
 //  (See accompanying file LICENSE_1_0.txt or copy at
 //  http://www.boost.org/LICENSE_1_0.txt)
 
+#include <climits>
 #include <cstdio>
+#include <cwchar>
+#include <new>
 #include <boost/outbuf.hpp>
+#include <boost/outbuf/buffer_pool.hpp>
 
 namespace boost {
 
+template <typename CharT>
+constexpr std::size_t narrow_cfile_writer_default_buffer_size()
+{
+    return (64 * 1024) / sizeof(CharT);
+}
+
 template <typename CharT>
 class narrow_cfile_writer final: public boost::basic_outbuf_noexcept<CharT>
 {
 public:
 
-    explicit narrow_cfile_writer(std::FILE* dest_)
-        : boost::basic_outbuf_noexcept<CharT>(_buf, _buf_size)
+    explicit narrow_cfile_writer
+        ( std::FILE* dest_
+        , std::size_t buf_size
+            = boost::narrow_cfile_writer_default_buffer_size<CharT>() )
+        : boost::basic_outbuf_noexcept<CharT>(_small_buf, _small_buf_size)
+        , _dest(dest_)
+    {
+        BOOST_ASSERT(dest_ != nullptr);
+        if (buf_size > _small_buf_size)
+        {
+            _buf = new (std::nothrow) CharT[buf_size];
+            if (_buf != nullptr)
+            {
+                _buf_size = buf_size;
+                _owns_buf = true;
+            }
+            else
+            {
+                _buf = _small_buf;
+            }
+            this->set_pos(_buf);
+            this->set_end(_buf + _buf_size);
+        }
+    }
+
+    // Takes the buffer from the pool, and returns it on destruction.
+    // The buffer size is rounded up to the size of the pool's block.
+    narrow_cfile_writer
+        ( std::FILE* dest_
+        , boost::outbuf_buffer_pool& pool
+        , std::size_t buf_size
+            = boost::narrow_cfile_writer_default_buffer_size<CharT>() )
+        : boost::basic_outbuf_noexcept<CharT>(_small_buf, _small_buf_size)
+        , _dest(dest_)
+    {
+        BOOST_ASSERT(dest_ != nullptr);
+        const std::size_t bytes = pool.rounded_size(buf_size * sizeof(CharT));
+        void* p = pool.allocate(bytes);
+        if (p != nullptr)
+        {
+            _buf = static_cast<CharT*>(p);
+            _buf_size = bytes / sizeof(CharT);
+            _owns_buf = true;
+            _pool = &pool;
+            this->set_pos(_buf);
+            this->set_end(_buf + _buf_size);
+        }
+    }
+
+    narrow_cfile_writer(std::FILE* dest_, CharT* buf, std::size_t buf_size)
+        : boost::basic_outbuf_noexcept<CharT>(buf, buf_size)
         , _dest(dest_)
+        , _buf(buf)
+        , _buf_size(buf_size)
     {
         BOOST_ASSERT(dest_ != nullptr);
+        BOOST_ASSERT(buf != nullptr);
+        BOOST_ASSERT(buf_size >= boost::min_size_after_recycle<CharT>());
     }
 
     narrow_cfile_writer() = delete;
@@ -28,6 +91,42 @@ public:
 
     ~narrow_cfile_writer()
     {
+        if (_pool != nullptr)
+        {
+            _pool->deallocate(_buf, _buf_size * sizeof(CharT));
+        }
+        else if (_owns_buf)
+        {
+            delete [] _buf;
+        }
+    }
+
+    std::size_t buffer_size() const noexcept
+    {
+        return _buf_size;
+    }
+
+    std::size_t max_contiguous() const noexcept override
+    {
+        return _buf_size;
+    }
+
+    // Discards the content written since the last call to recycle(),
+    // and makes the object ready to write again, as if it were
+    // constructed, but keeping its buffer
+    void reset() noexcept
+    {
+        _count = 0;
+        this->set_good(true);
+        this->set_pos(_buf);
+        this->set_end(_buf + _buf_size);
+    }
+
+    void reset(std::FILE* dest_) noexcept
+    {
+        BOOST_ASSERT(dest_ != nullptr);
+        _dest = dest_;
+        reset();
     }
 
     void recycle() noexcept
@@ -63,24 +162,114 @@ public:
         return {_count, g};
     }
 
+protected:
+
+    // Blocks that do not fit in the buffer are passed to fwrite as they are
+    bool do_write_direct(const CharT* str, std::size_t len) noexcept override
+    {
+        if (len < _buf_size || ! this->good())
+        {
+            return false;
+        }
+        recycle();
+        if (this->good())
+        {
+            auto count_inc = std::fwrite(str, sizeof(CharT), len, _dest);
+            _count += count_inc;
+            this->set_good(len == count_inc);
+        }
+        return true;
+    }
+
 private:
 
+    static constexpr std::size_t _small_buf_size
+        = boost::min_size_after_recycle<CharT>();
+
     std::FILE* _dest;
     std::size_t _count = 0;
-    static constexpr std::size_t _buf_size
-        = boost::min_size_after_recycle<CharT>();
-    CharT _buf[_buf_size];
+    CharT* _buf = _small_buf;
+    std::size_t _buf_size = _small_buf_size;
+    bool _owns_buf = false;
+    boost::outbuf_buffer_pool* _pool = nullptr;
+    CharT _small_buf[_small_buf_size];
 };
 
+constexpr std::size_t wide_cfile_writer_default_buffer_size()
+{
+    return (64 * 1024) / sizeof(wchar_t);
+}
+
+namespace detail {
+
+inline bool locale_is_utf8() noexcept
+{
+    char tmp[MB_LEN_MAX];
+    std::mbstate_t state{};
+    return std::wcrtomb(tmp, L'\u00E9', &state) == 2
+        && tmp[0] == static_cast<char>(0xC3)
+        && tmp[1] == static_cast<char>(0xA9);
+}
+
+} // namespace detail
+
+// When dest is byte-oriented, the content is converted to multibyte
+// characters by this class, according to the LC_CTYPE locale at the moment
+// of the construction: a later call to setlocale does not affect it.
 class wide_cfile_writer final: public boost::basic_outbuf_noexcept<wchar_t>
 {
 public:
 
-    explicit wide_cfile_writer(std::FILE* dest_)
-        : boost::basic_outbuf_noexcept<wchar_t>(_buf, _buf_size)
+    explicit wide_cfile_writer
+        ( std::FILE* dest_
+        , std::size_t buf_size = boost::wide_cfile_writer_default_buffer_size() )
+        : boost::basic_outbuf_noexcept<wchar_t>(_small_buf, _small_buf_size)
         , _dest(dest_)
+        , _utf8(boost::detail::locale_is_utf8())
     {
         BOOST_ASSERT(dest_ != nullptr);
+        if (buf_size > _small_buf_size)
+        {
+            _buf = new (std::nothrow) wchar_t[buf_size];
+            if (_buf != nullptr)
+            {
+                _buf_size = buf_size;
+                _owns_buf = true;
+            }
+            else
+            {
+                _buf = _small_buf;
+            }
+            this->set_pos(_buf);
+            this->set_end(_buf + _buf_size);
+        }
+        _bytes = new (std::nothrow) char[_bytes_size];
+    }
+
+    // Takes the buffer from the pool, and returns it on destruction.
+    // The buffer size is rounded up to the size of the pool's block.
+    wide_cfile_writer
+        ( std::FILE* dest_
+        , boost::outbuf_buffer_pool& pool
+        , std::size_t buf_size
+            = boost::wide_cfile_writer_default_buffer_size() )
+        : boost::basic_outbuf_noexcept<wchar_t>(_small_buf, _small_buf_size)
+        , _dest(dest_)
+        , _utf8(boost::detail::locale_is_utf8())
+    {
+        BOOST_ASSERT(dest_ != nullptr);
+        const std::size_t bytes = pool.rounded_size(buf_size * sizeof(wchar_t));
+        void* p = pool.allocate(bytes);
+        if (p != nullptr)
+        {
+            _buf = static_cast<wchar_t*>(p);
+            _buf_size = bytes / sizeof(wchar_t);
+            _owns_buf = true;
+            _pool = &pool;
+            this->set_pos(_buf);
+            this->set_end(_buf + _buf_size);
+        }
+        _bytes = new (std::nothrow) char[_bytes_size];
     }
 
     wide_cfile_writer() = delete;
@@ -89,6 +278,25 @@ public:
 
     ~wide_cfile_writer()
     {
+        if (_pool != nullptr)
+        {
+            _pool->deallocate(_buf, _buf_size * sizeof(wchar_t));
+        }
+        else if (_owns_buf)
+        {
+            delete [] _buf;
+        }
+        delete [] _bytes;
+    }
+
+    std::size_t buffer_size() const noexcept
+    {
+        return _buf_size;
+    }
+
+    std::size_t max_contiguous() const noexcept override
+    {
+        return _buf_size;
     }
 
     void recycle() noexcept
@@ -97,14 +305,7 @@ public:
         this->set_pos(_buf);
         if (this->good())
         {
-            for (auto it = _buf; it != p; ++it, ++_count)
-            {
-                if(std::fputwc(*it, _dest) == WEOF)
-                {
-                    this->set_good(false);
-                    break;
-                }
-            }
+            this->set_good(_write(_buf, p));
         }
     }
 
@@ -122,13 +323,207 @@ public:
         return {_count, g};
     }
 
-  private:
+protected:
+
+    // Blocks that do not fit in the buffer are converted without
+    // being copied into it first
+    bool do_write_direct(const wchar_t* str, std::size_t len) noexcept override
+    {
+        if (len < _buf_size || ! this->good())
+        {
+            return false;
+        }
+        recycle();
+        if (this->good())
+        {
+            this->set_good(_write(str, str + len));
+        }
+        return true;
+    }
+
+private:
+
+    // If the stream is byte-oriented, the content is converted to
+    // multibyte characters in _bytes, and then written with a single
+    // fwrite. Otherwise it is written with fputws, which makes an
+    // unoriented stream wide-oriented.
+    bool _write(const wchar_t* it, const wchar_t* end) noexcept
+    {
+        if (_bytes == nullptr)
+        {
+            return _write_wide_chars(it, end);
+        }
+        if (std::fwide(_dest, 0) >= 0)
+        {
+            return _write_wide(it, end);
+        }
+        while (it != end)
+        {
+            const wchar_t* const chunk = it;
+            const std::mbstate_t chunk_state = _state;
+            char* b = _bytes;
+            char* const b_limit = _bytes + _bytes_size - MB_LEN_MAX;
+            bool encoding_error = false;
+            while (it != end && b <= b_limit)
+            {
+                std::size_t space = b_limit - b + 1;
+                std::size_t n = static_cast<std::size_t>(end - it);
+                const wchar_t* ascii_end = it + (n < space ? n : space);
+                for ( ; it != ascii_end && _is_ascii(*it); ++it, ++b)
+                {
+                    *b = static_cast<char>(*it);
+                }
+                if (it != ascii_end)
+                {
+                    auto len = _encode(*it, b, _state);
+                    if (len == static_cast<std::size_t>(-1))
+                    {
+                        encoding_error = true;
+                        break;
+                    }
+                    b += len;
+                    ++it;
+                }
+            }
+            std::size_t bytes_count = b - _bytes;
+            auto written = std::fwrite(_bytes, 1, bytes_count, _dest);
+            if (written != bytes_count)
+            {
+                _count += _chars_count(chunk, chunk_state, written);
+                return false;
+            }
+            _count += it - chunk;
+            if (encoding_error)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // The content is copied in null-terminated chunks into _bytes, and
+    // each chunk is written with one call to fputws, so that the stream
+    // is locked, and the content converted, once per chunk instead of
+    // once per character. Null characters are written with fputwc.
+    bool _write_wide(const wchar_t* it, const wchar_t* end) noexcept
+    {
+        wchar_t* const chunk = reinterpret_cast<wchar_t*>(_bytes);
+        const std::size_t chunk_max = _bytes_size / sizeof(wchar_t) - 1;
+        while (it != end)
+        {
+            std::size_t n = 0;
+            for ( ; it != end && n != chunk_max && *it != L'\0'; ++it, ++n)
+            {
+                chunk[n] = *it;
+            }
+            if (n != 0)
+            {
+                chunk[n] = L'\0';
+                if (std::fputws(chunk, _dest) < 0)
+                {
+                    return false;
+                }
+                _count += n;
+            }
+            if (it != end && *it == L'\0')
+            {
+                if (std::fputwc(L'\0', _dest) == WEOF)
+                {
+                    return false;
+                }
+                ++it;
+                ++_count;
+            }
+        }
+        return true;
+    }
+
+    bool _write_wide_chars(const wchar_t* it, const wchar_t* end) noexcept
+    {
+        for ( ; it != end; ++it, ++_count)
+        {
+            if (std::fputwc(*it, _dest) == WEOF)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static bool _is_ascii(wchar_t ch) noexcept
+    {
+        return static_cast<unsigned long>(ch) < 0x80;
+    }
+
+    std::size_t _encode(wchar_t ch, char* dest, std::mbstate_t& state) noexcept
+    {
+        if (_utf8 && sizeof(wchar_t) == 4)
+        {
+            unsigned long cp = static_cast<unsigned long>(ch);
+            if (cp < 0x800)
+            {
+                dest[0] = static_cast<char>(0xC0 | (cp >> 6));
+                dest[1] = static_cast<char>(0x80 | (cp & 0x3F));
+                return 2;
+            }
+            if (cp < 0x10000)
+            {
+                if (cp >= 0xD800 && cp < 0xE000)
+                {
+                    return static_cast<std::size_t>(-1);
+                }
+                dest[0] = static_cast<char>(0xE0 | (cp >> 12));
+                dest[1] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                dest[2] = static_cast<char>(0x80 | (cp & 0x3F));
+                return 3;
+            }
+            if (cp < 0x110000)
+            {
+                dest[0] = static_cast<char>(0xF0 | (cp >> 18));
+                dest[1] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+                dest[2] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                dest[3] = static_cast<char>(0x80 | (cp & 0x3F));
+                return 4;
+            }
+            return static_cast<std::size_t>(-1);
+        }
+        return std::wcrtomb(dest, ch, &state);
+    }
+
+    // Number of characters starting at chunk whose multibyte
+    // sequences are entirely contained in the first `bytes` bytes.
+    std::size_t _chars_count
+        ( const wchar_t* chunk
+        , std::mbstate_t state
+        , std::size_t bytes ) noexcept
+    {
+        char tmp[MB_LEN_MAX];
+        std::size_t count = 0;
+        for (auto it = chunk; ; ++it, ++count)
+        {
+            std::size_t len = _is_ascii(*it) ? 1 : _encode(*it, tmp, state);
+            if (len > bytes)
+            {
+                return count;
+            }
+            bytes -= len;
+        }
+    }
+
+    static constexpr std::size_t _small_buf_size
+        = boost::min_size_after_recycle<wchar_t>();
+    static constexpr std::size_t _bytes_size = 16 * 1024;
 
     std::FILE* _dest;
     std::size_t _count = 0;
-    static constexpr std::size_t _buf_size
-        = boost::min_size_after_recycle<wchar_t>();
-    wchar_t _buf[_buf_size];
+    wchar_t* _buf = _small_buf;
+    std::size_t _buf_size = _small_buf_size;
+    char* _bytes = nullptr;
+    std::mbstate_t _state{};
+    bool _owns_buf = false;
+    boost::outbuf_buffer_pool* _pool = nullptr;
+    bool _utf8;
+    wchar_t _small_buf[_small_buf_size];
 };
 
 } // namespace outbuf
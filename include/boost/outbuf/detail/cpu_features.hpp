@@ -0,0 +1,64 @@
+#ifndef BOOST_OUTBUF_DETAIL_CPU_FEATURES_HPP
+#define BOOST_OUTBUF_DETAIL_CPU_FEATURES_HPP
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+// BOOST_OUTBUF_X86_SIMD is defined when the SIMD kernels for x86 can be
+// compiled. They are compiled with the target attribute, so that they
+// don't require any compiler flag, and they are only selected at runtime
+// when the CPU supports them. Define BOOST_OUTBUF_NO_SIMD to disable them.
+
+#if ! defined(BOOST_OUTBUF_NO_SIMD)                   \
+ && ( defined(__x86_64__) || defined(__i386__) )      \
+ && ( defined(__clang__)                              \
+   || (defined(__GNUC__) && __GNUC__ >= 8) )
+
+#define BOOST_OUTBUF_X86_SIMD
+#include <immintrin.h>
+
+#endif
+
+namespace boost {
+namespace detail {
+
+struct cpu_features
+{
+    bool ssse3 = false;
+    bool sse41 = false;
+    bool avx2 = false;
+    bool avx512f = false;
+    bool avx512bw = false;
+    bool avx512vbmi = false;
+};
+
+inline cpu_features detect_cpu_features() noexcept
+{
+    cpu_features f;
+
+#if defined(BOOST_OUTBUF_X86_SIMD)
+
+    __builtin_cpu_init();
+    f.ssse3 = __builtin_cpu_supports("ssse3");
+    f.sse41 = __builtin_cpu_supports("sse4.1");
+    f.avx2 = __builtin_cpu_supports("avx2");
+    f.avx512f = __builtin_cpu_supports("avx512f");
+    f.avx512bw = __builtin_cpu_supports("avx512bw");
+    f.avx512vbmi = f.avx512bw && __builtin_cpu_supports("avx512vbmi");
+
+#endif // defined(BOOST_OUTBUF_X86_SIMD)
+
+    return f;
+}
+
+inline const cpu_features& get_cpu_features() noexcept
+{
+    static const cpu_features f = detect_cpu_features();
+    return f;
+}
+
+} // namespace detail
+} // namespace boost
+
+#endif  // BOOST_OUTBUF_DETAIL_CPU_FEATURES_HPP
@@ -0,0 +1,264 @@
+#ifndef BOOST_OUTBUF_FD_HPP
+#define BOOST_OUTBUF_FD_HPP
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <cerrno>
+#include <climits>
+#include <new>
+#include <unistd.h>
+#include <sys/uio.h>
+#include <boost/outbuf.hpp>
+#include <boost/outbuf/buffer_pool.hpp>
+
+namespace boost {
+
+template <typename CharT>
+constexpr std::size_t fd_writer_default_buffer_size()
+{
+    return (64 * 1024) / sizeof(CharT);
+}
+
+template <typename CharT>
+class basic_fd_writer final: public boost::basic_outbuf_noexcept<CharT>
+{
+public:
+
+    explicit basic_fd_writer
+        ( int fd
+        , std::size_t buf_size = boost::fd_writer_default_buffer_size<CharT>() )
+        : boost::basic_outbuf_noexcept<CharT>(_small_buf, _small_buf_size)
+        , _fd(fd)
+    {
+        BOOST_ASSERT(fd >= 0);
+        if (buf_size > _small_buf_size)
+        {
+            _buf = new (std::nothrow) CharT[buf_size];
+            if (_buf != nullptr)
+            {
+                _buf_size = buf_size;
+                _owns_buf = true;
+            }
+            else
+            {
+                _buf = _small_buf;
+            }
+            this->set_pos(_buf);
+            this->set_end(_buf + _buf_size);
+        }
+    }
+
+    // Takes the buffer from the pool, and returns it on destruction.
+    // The buffer size is rounded up to the size of the pool's block.
+    basic_fd_writer
+        ( int fd
+        , boost::outbuf_buffer_pool& pool
+        , std::size_t buf_size
+            = boost::fd_writer_default_buffer_size<CharT>() )
+        : boost::basic_outbuf_noexcept<CharT>(_small_buf, _small_buf_size)
+        , _fd(fd)
+    {
+        BOOST_ASSERT(fd >= 0);
+        const std::size_t bytes = pool.rounded_size(buf_size * sizeof(CharT));
+        void* p = pool.allocate(bytes);
+        if (p != nullptr)
+        {
+            _buf = static_cast<CharT*>(p);
+            _buf_size = bytes / sizeof(CharT);
+            _owns_buf = true;
+            _pool = &pool;
+            this->set_pos(_buf);
+            this->set_end(_buf + _buf_size);
+        }
+    }
+
+    basic_fd_writer(int fd, CharT* buf, std::size_t buf_size)
+        : boost::basic_outbuf_noexcept<CharT>(buf, buf_size)
+        , _fd(fd)
+        , _buf(buf)
+        , _buf_size(buf_size)
+    {
+        BOOST_ASSERT(fd >= 0);
+        BOOST_ASSERT(buf != nullptr);
+        BOOST_ASSERT(buf_size >= boost::min_size_after_recycle<CharT>());
+    }
+
+    basic_fd_writer() = delete;
+    basic_fd_writer(const basic_fd_writer&) = delete;
+    basic_fd_writer(basic_fd_writer&&) = delete;
+
+    ~basic_fd_writer()
+    {
+        if (_pool != nullptr)
+        {
+            _pool->deallocate(_buf, _buf_size * sizeof(CharT));
+        }
+        else if (_owns_buf)
+        {
+            delete [] _buf;
+        }
+    }
+
+    std::size_t buffer_size() const noexcept
+    {
+        return _buf_size;
+    }
+
+    std::size_t max_contiguous() const noexcept override
+    {
+        return _buf_size;
+    }
+
+    void recycle() noexcept override
+    {
+        auto p = this->pos();
+        this->set_pos(_buf);
+        if (this->good())
+        {
+            _write(_buf, (p - _buf) * sizeof(CharT));
+        }
+    }
+
+    struct result
+    {
+        std::size_t count;
+        int errnum;
+        bool success;
+    };
+
+    result finish()
+    {
+        bool g = this->good();
+        if (g)
+        {
+            _write(_buf, (this->pos() - _buf) * sizeof(CharT));
+            g = this->good();
+        }
+        this->set_pos(_buf);
+        this->set_good(false);
+        return {_count, _errnum, g};
+    }
+
+protected:
+
+    // Sends the content pending in the buffer followed by
+    // [str, str + len) with a single writev call, without
+    // copying str into the buffer, if len >= buffer_size().
+    bool do_write_direct(const CharT* str, std::size_t len) noexcept override
+    {
+        if (len < _buf_size)
+        {
+            return false;
+        }
+        auto p = this->pos();
+        this->set_pos(_buf);
+        if (this->good())
+        {
+            ::iovec iov[2];
+            iov[0].iov_base = _buf;
+            iov[0].iov_len = (p - _buf) * sizeof(CharT);
+            iov[1].iov_base = const_cast<CharT*>(str);
+            iov[1].iov_len = len * sizeof(CharT);
+            _writev(iov);
+        }
+        return true;
+    }
+
+private:
+
+    void _write(const void* data, std::size_t len) noexcept
+    {
+        auto it = static_cast<const char*>(data);
+        while (len != 0)
+        {
+            std::size_t chunk = len <= SSIZE_MAX ? len : SSIZE_MAX;
+            auto r = ::write(_fd, it, chunk);
+            if (r <= 0)
+            {
+                if (r < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                _fail(r < 0 ? errno : EIO);
+                return;
+            }
+            _count += r;
+            it += r;
+            len -= r;
+        }
+    }
+
+    void _writev(::iovec* iov) noexcept
+    {
+        int iovcnt = 2;
+        if (iov[0].iov_len == 0)
+        {
+            ++iov;
+            --iovcnt;
+        }
+        while (iovcnt != 0)
+        {
+            // The total length passed to writev can not exceed SSIZE_MAX
+            ::iovec capped[2];
+            std::size_t room = SSIZE_MAX;
+            for (int i = 0; i < iovcnt; ++i)
+            {
+                capped[i] = iov[i];
+                if (capped[i].iov_len > room)
+                {
+                    capped[i].iov_len = room;
+                }
+                room -= capped[i].iov_len;
+            }
+            auto r = ::writev(_fd, capped, iovcnt);
+            if (r <= 0)
+            {
+                if (r < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                _fail(r < 0 ? errno : EIO);
+                return;
+            }
+            _count += r;
+            std::size_t n = r;
+            while (iovcnt != 0 && n >= iov->iov_len)
+            {
+                n -= iov->iov_len;
+                ++iov;
+                --iovcnt;
+            }
+            if (iovcnt != 0)
+            {
+                iov->iov_base = static_cast<char*>(iov->iov_base) + n;
+                iov->iov_len -= n;
+            }
+        }
+    }
+
+    void _fail(int errnum) noexcept
+    {
+        _errnum = errnum;
+        this->set_good(false);
+    }
+
+    static constexpr std::size_t _small_buf_size
+        = boost::min_size_after_recycle<CharT>();
+
+    int _fd;
+    int _errnum = 0;
+    std::size_t _count = 0;
+    CharT* _buf = _small_buf;
+    std::size_t _buf_size = _small_buf_size;
+    bool _owns_buf = false;
+    boost::outbuf_buffer_pool* _pool = nullptr;
+    CharT _small_buf[_small_buf_size];
+};
+
+using fd_writer = basic_fd_writer<char>;
+
+} // namespace boost
+
+#endif  // BOOST_OUTBUF_FD_HPP
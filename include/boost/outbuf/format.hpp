@@ -0,0 +1,406 @@
+#ifndef BOOST_OUTBUF_FORMAT_HPP
+#define BOOST_OUTBUF_FORMAT_HPP
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/outbuf.hpp>
+
+#if defined(__cpp_nontype_template_args) && __cpp_nontype_template_args >= 201911L \
+ && defined(__cpp_consteval) && defined(__cpp_concepts)
+#define BOOST_OUTBUF_HAS_FORMAT
+#endif
+
+#if defined(BOOST_OUTBUF_HAS_FORMAT)
+
+#include <cstring>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <boost/outbuf/integer.hpp>
+#include <boost/outbuf/floating_point.hpp>
+
+namespace boost {
+
+// The type of the template argument of write_formatted
+template <std::size_t N>
+struct format_string
+{
+    constexpr format_string(const char (&str)[N]) noexcept
+    {
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            chars[i] = str[i];
+        }
+    }
+
+    char chars[N] {};
+};
+
+// Defines how values of type T are written by write_formatted.
+// A specialization shall provide:
+//
+//   static constexpr bool supports(char spec);
+//   static std::size_t size(const T& value, char spec);
+//   static CharT* write(CharT* dest, const T& value, char spec);
+//
+// where spec is the character after ':' in the replacement field,
+// or '\0' if there is none, and size returns an upper bound of the
+// number of characters that write writes. It may also provide:
+//
+//   static void write(basic_outbuf<CharT>& ob, const T& value, char spec);
+//
+// which is used when there is not enough contiguous space for the whole
+// content. Otherwise, size must not exceed min_size_after_recycle<CharT>().
+template <typename T, typename CharT, typename Enable = void>
+struct formatter;
+
+template <typename CharT>
+struct formatter<CharT, CharT>
+{
+    static constexpr bool supports(char spec) noexcept
+    {
+        return spec == '\0';
+    }
+    static std::size_t size(CharT, char) noexcept
+    {
+        return 1;
+    }
+    static CharT* write(CharT* dest, CharT ch, char) noexcept
+    {
+        *dest = ch;
+        return dest + 1;
+    }
+};
+
+template <typename CharT>
+struct formatter<bool, CharT>
+{
+    static constexpr bool supports(char spec) noexcept
+    {
+        return spec == '\0';
+    }
+    static std::size_t size(bool value, char) noexcept
+    {
+        return value ? 4 : 5;
+    }
+    static CharT* write(CharT* dest, bool value, char) noexcept
+    {
+        const char* str = value ? "true" : "false";
+        for ( ; *str; ++str)
+        {
+            *dest++ = static_cast<CharT>(*str);
+        }
+        return dest;
+    }
+};
+
+template <typename Int, typename CharT>
+struct formatter
+    < Int, CharT
+    , typename std::enable_if
+        < std::is_integral<Int>::value
+       && ! std::is_same<Int, bool>::value
+       && ! std::is_same<Int, CharT>::value >::type >
+{
+    static constexpr bool supports(char spec) noexcept
+    {
+        return spec == '\0' || spec == 'x' || spec == 'X' || spec == 'o';
+    }
+    static std::size_t size(Int, char spec) noexcept
+    {
+        constexpr int bits = std::numeric_limits<Int>::digits
+                           + std::numeric_limits<Int>::is_signed;
+        return spec == '\0' ? std::numeric_limits<Int>::digits10 + 2
+             : spec == 'o'  ? (bits + 2) / 3
+             :                (bits + 3) / 4;
+    }
+    static CharT* write(CharT* dest, Int value, char spec) noexcept
+    {
+        switch (spec)
+        {
+            case 'x':
+                return boost::detail::write_pow2
+                    ( dest, value, 4, boost::detail::int_tables<>::hex_digits );
+            case 'X':
+                return boost::detail::write_pow2
+                    ( dest, value, 4, boost::detail::int_tables<>::hex_digits_upper );
+            case 'o':
+                return boost::detail::write_pow2
+                    ( dest, value, 3, boost::detail::int_tables<>::hex_digits );
+            default:
+                return boost::detail::write_dec(dest, value);
+        }
+    }
+};
+
+template <typename Float, typename CharT>
+struct formatter
+    < Float, CharT
+    , typename std::enable_if
+        < std::is_same<Float, float>::value
+       || std::is_same<Float, double>::value >::type >
+{
+    static constexpr bool supports(char spec) noexcept
+    {
+        return spec == '\0';
+    }
+    static std::size_t size(Float, char) noexcept
+    {
+        return boost::detail::shortest_float_max_size;
+    }
+    static CharT* write(CharT* dest, Float value, char) noexcept
+    {
+        return boost::detail::write_float_shortest(dest, value);
+    }
+};
+
+template <typename CharT, typename Traits>
+struct formatter<std::basic_string_view<CharT, Traits>, CharT>
+{
+    static constexpr bool supports(char spec) noexcept
+    {
+        return spec == '\0';
+    }
+    static std::size_t size(std::basic_string_view<CharT, Traits> str, char) noexcept
+    {
+        return str.size();
+    }
+    static CharT* write(CharT* dest, std::basic_string_view<CharT, Traits> str, char) noexcept
+    {
+        std::memcpy(dest, str.data(), str.size() * sizeof(CharT));
+        return dest + str.size();
+    }
+    static void write
+        ( boost::basic_outbuf<CharT>& ob
+        , std::basic_string_view<CharT, Traits> str
+        , char )
+    {
+        boost::detail::outbuf_write(ob, str.data(), str.size());
+    }
+};
+
+template <typename CharT, typename Traits, typename Alloc>
+struct formatter<std::basic_string<CharT, Traits, Alloc>, CharT>
+    : formatter<std::basic_string_view<CharT, Traits>, CharT>
+{
+};
+
+template <typename CharT>
+struct formatter<const CharT*, CharT>
+    : formatter<std::basic_string_view<CharT>, CharT>
+{
+};
+
+template <typename CharT>
+struct formatter<CharT*, CharT>
+    : formatter<std::basic_string_view<CharT>, CharT>
+{
+};
+
+namespace detail {
+
+// Not constexpr: calling it makes the parsing fail at compile time
+inline void format_string_error(const char*)
+{
+}
+
+template <std::size_t N>
+struct parsed_format
+{
+    // The literal content, with "{{" and "}}" replaced by '{' and '}'
+    char text[N] {};
+    std::size_t text_size = 0;
+
+    // The literal fragment before the i-th replacement field is
+    // [fragment_begin[i], fragment_begin[i + 1]). The last fragment
+    // comes after the last replacement field.
+    std::size_t fragment_begin[N + 1] {};
+    char specs[N] {};
+    std::size_t fields_count = 0;
+
+    constexpr std::size_t fragment_size(std::size_t i) const noexcept
+    {
+        return ( i < fields_count ? fragment_begin[i + 1] : text_size )
+             - fragment_begin[i];
+    }
+};
+
+template <std::size_t N>
+consteval parsed_format<N> parse_format(const boost::format_string<N>& fmt)
+{
+    parsed_format<N> result;
+    const char* str = fmt.chars;
+    std::size_t i = 0;
+    while (i < N - 1)
+    {
+        const char ch = str[i];
+        if (ch == '{' && str[i + 1] == '{')
+        {
+            result.text[result.text_size++] = '{';
+            i += 2;
+        }
+        else if (ch == '{')
+        {
+            char spec = '\0';
+            ++i;
+            if (str[i] == ':')
+            {
+                spec = str[i + 1];
+                if (spec == '\0' || spec == '}')
+                {
+                    boost::detail::format_string_error("missing format specifier after ':'");
+                }
+                i += 2;
+            }
+            if (str[i] != '}')
+            {
+                boost::detail::format_string_error("invalid replacement field");
+            }
+            ++i;
+            result.specs[result.fields_count] = spec;
+            result.fragment_begin[++result.fields_count] = result.text_size;
+        }
+        else if (ch == '}')
+        {
+            if (str[i + 1] != '}')
+            {
+                boost::detail::format_string_error("unmatched '}'");
+            }
+            result.text[result.text_size++] = '}';
+            i += 2;
+        }
+        else
+        {
+            result.text[result.text_size++] = ch;
+            ++i;
+        }
+    }
+    return result;
+}
+
+template <typename T, typename CharT>
+using formatter_of = boost::formatter<typename std::decay<T>::type, CharT>;
+
+template <typename T, typename CharT>
+concept has_outbuf_write = requires
+    ( boost::basic_outbuf<CharT>& ob, const typename std::decay<T>::type& value )
+{
+    formatter_of<T, CharT>::write(ob, value, '\0');
+};
+
+template <const auto& Parsed, std::size_t I, typename CharT>
+inline CharT* copy_fragment(CharT* dest) noexcept
+{
+    constexpr std::size_t size = Parsed.fragment_size(I);
+    if constexpr (size != 0)
+    {
+        constexpr const char* fragment = Parsed.text + Parsed.fragment_begin[I];
+        if constexpr (sizeof(CharT) == 1)
+        {
+            std::memcpy(dest, fragment, size);
+        }
+        else
+        {
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                dest[i] = static_cast<CharT>(fragment[i]);
+            }
+        }
+    }
+    return dest + size;
+}
+
+template <const auto& Parsed, std::size_t I, typename CharT>
+inline void write_fragment(boost::basic_outbuf<CharT>& ob)
+{
+    constexpr std::size_t size = Parsed.fragment_size(I);
+    if constexpr (size != 0)
+    {
+        if (ob.reserve_contiguous(size))
+        {
+            ob.advance_to(boost::detail::copy_fragment<Parsed, I>(ob.pos()));
+        }
+        else
+        {
+            boost::detail::write_ascii(ob, Parsed.text + Parsed.fragment_begin[I], size);
+        }
+    }
+}
+
+template <typename CharT, typename T>
+inline void write_field(boost::basic_outbuf<CharT>& ob, const T& value, char spec)
+{
+    using fmt = boost::detail::formatter_of<T, CharT>;
+    if constexpr (boost::detail::has_outbuf_write<T, CharT>)
+    {
+        fmt::write(ob, value, spec);
+    }
+    else if (fmt::size(value, spec) <= ob.size())
+    {
+        ob.advance_to(fmt::write(ob.pos(), value, spec));
+    }
+    else
+    {
+        // Requiring the upper bound could recycle earlier than needed
+        CharT tmp[boost::min_size_after_recycle<CharT>()];
+        BOOST_ASSERT(fmt::size(value, spec) <= sizeof(tmp) / sizeof(CharT));
+        CharT* end = fmt::write(tmp, value, spec);
+        boost::detail::outbuf_write(ob, tmp, end - tmp);
+    }
+}
+
+template <const auto& Parsed, typename CharT, std::size_t... I, typename... Args>
+inline void write_formatted(boost::basic_outbuf<CharT>& ob, std::index_sequence<I...>, const Args&... args)
+{
+    static_assert
+        ( Parsed.fields_count == sizeof...(Args)
+        , "The number of arguments does not match the number of replacement fields" );
+    static_assert
+        ( (boost::detail::formatter_of<Args, CharT>::supports(Parsed.specs[I]) && ...)
+        , "Format specifier not supported by the argument type" );
+
+    // For types like integers, size() does not depend on the value,
+    // so the sum is mostly calculated at compile time.
+    const std::size_t size = ( Parsed.text_size + ... + boost::detail::formatter_of<Args, CharT>
+                               ::size(args, Parsed.specs[I]) );
+    if (ob.reserve_contiguous(size))
+    {
+        CharT* p = boost::detail::copy_fragment<Parsed, 0>(ob.pos());
+        ( ( p = boost::detail::formatter_of<Args, CharT>::write(p, args, Parsed.specs[I])
+          , p = boost::detail::copy_fragment<Parsed, I + 1>(p) ), ... );
+        ob.advance_to(p);
+    }
+    else
+    {
+        boost::detail::write_fragment<Parsed, 0>(ob);
+        ( ( boost::detail::write_field(ob, args, Parsed.specs[I])
+          , boost::detail::write_fragment<Parsed, I + 1>(ob) ), ... );
+    }
+}
+
+template <boost::format_string Fmt>
+struct parsed_format_holder
+{
+    static constexpr auto value = boost::detail::parse_format(Fmt);
+};
+
+} // namespace detail
+
+// Writes the format string Fmt, where each "{}" or "{:spec}" is replaced
+// by the corresponding argument, and "{{" and "}}" by '{' and '}'.
+template <boost::format_string Fmt, typename CharT, typename... Args>
+inline void write_formatted(boost::basic_outbuf<CharT>& ob, const Args&... args)
+{
+    boost::detail::write_formatted<boost::detail::parsed_format_holder<Fmt>::value>
+        ( ob, std::index_sequence_for<Args...>(), args... );
+}
+
+} // namespace boost
+
+#endif // defined(BOOST_OUTBUF_HAS_FORMAT)
+
+#endif  // BOOST_OUTBUF_FORMAT_HPP
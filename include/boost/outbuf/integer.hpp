@@ -0,0 +1,356 @@
+#ifndef BOOST_OUTBUF_INTEGER_HPP
+#define BOOST_OUTBUF_INTEGER_HPP
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <cstdint>
+#include <type_traits>
+#include <boost/outbuf.hpp>
+
+namespace boost {
+namespace detail {
+
+template <typename T = void>
+struct int_tables
+{
+    static const char digit_pairs[200];
+    static const char hex_digits[16];
+    static const char hex_digits_upper[16];
+    static const std::uint64_t powers_of_10[20];
+};
+
+template <typename T>
+const char int_tables<T>::digit_pairs[200] =
+    { '0','0','0','1','0','2','0','3','0','4','0','5','0','6','0','7','0','8','0','9'
+    , '1','0','1','1','1','2','1','3','1','4','1','5','1','6','1','7','1','8','1','9'
+    , '2','0','2','1','2','2','2','3','2','4','2','5','2','6','2','7','2','8','2','9'
+    , '3','0','3','1','3','2','3','3','3','4','3','5','3','6','3','7','3','8','3','9'
+    , '4','0','4','1','4','2','4','3','4','4','4','5','4','6','4','7','4','8','4','9'
+    , '5','0','5','1','5','2','5','3','5','4','5','5','5','6','5','7','5','8','5','9'
+    , '6','0','6','1','6','2','6','3','6','4','6','5','6','6','6','7','6','8','6','9'
+    , '7','0','7','1','7','2','7','3','7','4','7','5','7','6','7','7','7','8','7','9'
+    , '8','0','8','1','8','2','8','3','8','4','8','5','8','6','8','7','8','8','8','9'
+    , '9','0','9','1','9','2','9','3','9','4','9','5','9','6','9','7','9','8','9','9' };
+
+template <typename T>
+const char int_tables<T>::hex_digits[16] =
+    { '0','1','2','3','4','5','6','7','8','9','a','b','c','d','e','f' };
+
+template <typename T>
+const char int_tables<T>::hex_digits_upper[16] =
+    { '0','1','2','3','4','5','6','7','8','9','A','B','C','D','E','F' };
+
+template <typename T>
+const std::uint64_t int_tables<T>::powers_of_10[20] =
+    { 1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL
+    , 10000000ULL, 100000000ULL, 1000000000ULL, 10000000000ULL
+    , 100000000000ULL, 1000000000000ULL, 10000000000000ULL
+    , 100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL
+    , 100000000000000000ULL, 1000000000000000000ULL
+    , 10000000000000000000ULL };
+
+// Number of significant bits, with bit_width(0) == 1
+inline unsigned bit_width(std::uint64_t x) noexcept
+{
+#if defined(__GNUC__)
+
+    return 64 - __builtin_clzll(x | 1);
+
+#else
+
+    unsigned n = 1;
+    while (x >>= 1)
+    {
+        ++n;
+    }
+    return n;
+
+#endif
+}
+
+// Number of decimal digits. 1233 / 4096 approximates log10(2).
+// Setting the lowest bit makes count_digits(0) == 1 without
+// affecting other values, since powers of ten are even.
+inline unsigned count_digits(std::uint64_t x) noexcept
+{
+    x |= 1;
+    unsigned t = (boost::detail::bit_width(x) * 1233) >> 12;
+    return t + (x >= boost::detail::int_tables<>::powers_of_10[t]);
+}
+
+template <typename Int>
+constexpr bool is_negative(Int x, std::true_type) noexcept
+{
+    return x < 0;
+}
+
+template <typename Int>
+constexpr bool is_negative(Int, std::false_type) noexcept
+{
+    return false;
+}
+
+template <typename Int>
+constexpr bool is_negative(Int x) noexcept
+{
+    return boost::detail::is_negative(x, std::is_signed<Int>());
+}
+
+template <typename UInt>
+using fast_uint = typename std::conditional
+    < (sizeof(UInt) <= 4), std::uint32_t, std::uint64_t >::type;
+
+// Writes the decimal digits of x backwards, two at a time,
+// ending at `end`. Returns the position of the first digit.
+template <typename CharT, typename UInt>
+inline CharT* write_dec_backwards(CharT* end, UInt x) noexcept
+{
+    const char* pairs = boost::detail::int_tables<>::digit_pairs;
+    while (x >= 100)
+    {
+        auto i = static_cast<unsigned>(x % 100) * 2;
+        x /= 100;
+        *--end = static_cast<CharT>(pairs[i + 1]);
+        *--end = static_cast<CharT>(pairs[i]);
+    }
+    if (x >= 10)
+    {
+        auto i = static_cast<unsigned>(x) * 2;
+        *--end = static_cast<CharT>(pairs[i + 1]);
+        *--end = static_cast<CharT>(pairs[i]);
+    }
+    else
+    {
+        *--end = static_cast<CharT>('0' + x);
+    }
+    return end;
+}
+
+template <typename CharT, typename UInt>
+inline void write_pow2_backwards
+    ( CharT* end, UInt x, unsigned bits_per_digit, const char* digits ) noexcept
+{
+    const UInt mask = (1u << bits_per_digit) - 1;
+    do
+    {
+        *--end = static_cast<CharT>(digits[x & mask]);
+        x >>= bits_per_digit;
+    }
+    while (x != 0);
+}
+
+// Writes value in decimal base, preceded by '-' if negative,
+// at p. Returns the end of the written content.
+template <typename CharT, typename Int>
+inline CharT* write_dec(CharT* p, Int value) noexcept
+{
+    using uint_t = boost::detail::fast_uint<Int>;
+    uint_t uvalue = static_cast<uint_t>(value);
+    if (boost::detail::is_negative(value))
+    {
+        uvalue = 0 - uvalue;
+        *p++ = static_cast<CharT>('-');
+    }
+    p += boost::detail::count_digits(uvalue);
+    boost::detail::write_dec_backwards(p, uvalue);
+    return p;
+}
+
+// Same as above, in hexadecimal or octal base
+template <typename CharT, typename Int>
+inline CharT* write_pow2
+    ( CharT* p, Int value, unsigned bits_per_digit, const char* digits ) noexcept
+{
+    using uint_t = boost::detail::fast_uint<Int>;
+    auto uvalue = static_cast<uint_t>
+        (static_cast<typename std::make_unsigned<Int>::type>(value));
+    p += (boost::detail::bit_width(uvalue) + bits_per_digit - 1) / bits_per_digit;
+    boost::detail::write_pow2_backwards(p, uvalue, bits_per_digit, digits);
+    return p;
+}
+
+template <typename CharT>
+void write_fill(boost::basic_outbuf<CharT>& ob, std::size_t count, CharT fill)
+{
+    while (count != 0)
+    {
+        if (ob.pos() == ob.end())
+        {
+            ob.recycle();
+        }
+        std::size_t n = ob.size() < count ? ob.size() : count;
+        auto p = ob.pos();
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            p[i] = fill;
+        }
+        ob.advance(n);
+        count -= n;
+    }
+}
+
+// Writes the sign ( unless it is zero ) followed by the `count` characters
+// that write_digits writes backwards, padded up to `width` with `fill`.
+// When fill is '0', the padding goes between the sign and the digits.
+template <typename CharT, typename WriteDigits>
+inline void write_padded
+    ( boost::basic_outbuf<CharT>& ob
+    , CharT sign
+    , unsigned count
+    , std::size_t width
+    , CharT fill
+    , WriteDigits write_digits )
+{
+    unsigned sign_len = (sign != 0);
+    std::size_t len = count + sign_len;
+    if (width > len)
+    {
+        if (fill == static_cast<CharT>('0') && sign_len != 0)
+        {
+            boost::put(ob, sign);
+            sign_len = 0;
+        }
+        boost::detail::write_fill(ob, width - len, fill);
+    }
+    ob.require(count + sign_len);
+    auto p = ob.pos();
+    if (sign_len != 0)
+    {
+        *p = sign;
+    }
+    write_digits(p + sign_len + count);
+    ob.advance(count + sign_len);
+}
+
+template <typename CharT, typename Int>
+inline void write_pow2
+    ( boost::basic_outbuf<CharT>& ob
+    , Int value
+    , unsigned bits_per_digit
+    , const char* digits
+    , std::size_t width
+    , CharT fill )
+{
+    using uint_t = boost::detail::fast_uint<Int>;
+    auto uvalue = static_cast<uint_t>
+        (static_cast<typename std::make_unsigned<Int>::type>(value));
+    unsigned count
+        = (boost::detail::bit_width(uvalue) + bits_per_digit - 1) / bits_per_digit;
+    boost::detail::write_padded
+        ( ob, CharT(), count, width, fill
+        , [=](CharT* end)
+          {
+              boost::detail::write_pow2_backwards(end, uvalue, bits_per_digit, digits);
+          } );
+}
+
+} // namespace detail
+
+template <typename CharT, typename UInt>
+inline typename std::enable_if<std::is_unsigned<UInt>::value>::type
+write_uint(boost::basic_outbuf<CharT>& ob, UInt value)
+{
+    using uint_t = boost::detail::fast_uint<UInt>;
+    unsigned count = boost::detail::count_digits(value);
+    ob.require(count);
+    auto end = ob.pos() + count;
+    boost::detail::write_dec_backwards(end, static_cast<uint_t>(value));
+    ob.advance_to(end);
+}
+
+template <typename CharT, typename UInt>
+inline typename std::enable_if<std::is_unsigned<UInt>::value>::type
+write_uint
+    ( boost::basic_outbuf<CharT>& ob
+    , UInt value
+    , std::size_t width
+    , typename boost::basic_outbuf<CharT>::char_type fill = static_cast<CharT>(' ') )
+{
+    using uint_t = boost::detail::fast_uint<UInt>;
+    auto uvalue = static_cast<uint_t>(value);
+    boost::detail::write_padded
+        ( ob, CharT(), boost::detail::count_digits(uvalue), width, fill
+        , [=](CharT* end){ boost::detail::write_dec_backwards(end, uvalue); } );
+}
+
+template <typename CharT, typename Int>
+inline typename std::enable_if<std::is_integral<Int>::value>::type
+write_int(boost::basic_outbuf<CharT>& ob, Int value)
+{
+    using uint_t = boost::detail::fast_uint<Int>;
+    uint_t uvalue = static_cast<uint_t>(value);
+    bool negative = boost::detail::is_negative(value);
+    if (negative)
+    {
+        uvalue = 0 - uvalue;
+    }
+    unsigned count = boost::detail::count_digits(uvalue) + negative;
+    ob.require(count);
+    auto p = ob.pos();
+    *p = static_cast<CharT>('-');
+    boost::detail::write_dec_backwards(p + count, uvalue);
+    ob.advance(count);
+}
+
+template <typename CharT, typename Int>
+inline typename std::enable_if<std::is_integral<Int>::value>::type
+write_int
+    ( boost::basic_outbuf<CharT>& ob
+    , Int value
+    , std::size_t width
+    , typename boost::basic_outbuf<CharT>::char_type fill = static_cast<CharT>(' ') )
+{
+    using uint_t = boost::detail::fast_uint<Int>;
+    uint_t uvalue = static_cast<uint_t>(value);
+    CharT sign = CharT();
+    if (boost::detail::is_negative(value))
+    {
+        uvalue = 0 - uvalue;
+        sign = static_cast<CharT>('-');
+    }
+    boost::detail::write_padded
+        ( ob, sign, boost::detail::count_digits(uvalue), width, fill
+        , [=](CharT* end){ boost::detail::write_dec_backwards(end, uvalue); } );
+}
+
+template <typename CharT, typename Int>
+inline typename std::enable_if<std::is_integral<Int>::value>::type
+write_hex
+    ( boost::basic_outbuf<CharT>& ob
+    , Int value
+    , std::size_t width = 0
+    , typename boost::basic_outbuf<CharT>::char_type fill = static_cast<CharT>('0') )
+{
+    boost::detail::write_pow2
+        ( ob, value, 4, boost::detail::int_tables<>::hex_digits, width, fill );
+}
+
+template <typename CharT, typename Int>
+inline typename std::enable_if<std::is_integral<Int>::value>::type
+write_hex_upper
+    ( boost::basic_outbuf<CharT>& ob
+    , Int value
+    , std::size_t width = 0
+    , typename boost::basic_outbuf<CharT>::char_type fill = static_cast<CharT>('0') )
+{
+    boost::detail::write_pow2
+        ( ob, value, 4, boost::detail::int_tables<>::hex_digits_upper, width, fill );
+}
+
+template <typename CharT, typename Int>
+inline typename std::enable_if<std::is_integral<Int>::value>::type
+write_oct
+    ( boost::basic_outbuf<CharT>& ob
+    , Int value
+    , std::size_t width = 0
+    , typename boost::basic_outbuf<CharT>::char_type fill = static_cast<CharT>('0') )
+{
+    boost::detail::write_pow2
+        ( ob, value, 3, boost::detail::int_tables<>::hex_digits, width, fill );
+}
+
+} // namespace boost
+
+#endif  // BOOST_OUTBUF_INTEGER_HPP
@@ -0,0 +1,219 @@
+#ifndef BOOST_OUTBUF_ITERATOR_HPP
+#define BOOST_OUTBUF_ITERATOR_HPP
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <cstddef>
+#include <iterator>
+#include <boost/outbuf.hpp>
+#if defined(__cpp_lib_concepts)
+#include <concepts>
+#endif
+
+namespace boost {
+namespace detail {
+
+// The iterator keeps its own copy of pos() and end(), so that
+// writing a character does not require loading and storing
+// the outbuf's members. The outbuf is only updated on recycle,
+// and when the iterator is copied or destroyed.
+//
+// When an iterator is copied, the source is synchronized with the
+// outbuf and detached from it ( _pos == _end == nullptr ), and the new
+// copy takes over the buffer. A detached iterator reattaches itself
+// the next time it writes something.
+//
+// The copy functions that write contiguous ranges with memcpy are
+// hidden friends, hence only found by argument dependent lookup:
+// an unqualified call `copy(first, last, it)` uses them, but a
+// qualified `std::copy(first, last, it)` or `std::ranges::copy`
+// does not, and assigns the characters one by one.
+template <typename Derived, typename Outbuf, typename CharT>
+class outbuf_iterator_base
+{
+public:
+
+    using char_type = CharT;
+    using value_type = void;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = void;
+    using iterator_category = std::output_iterator_tag;
+
+    explicit outbuf_iterator_base(Outbuf& ob) noexcept
+        : _ob(&ob)
+        , _pos(ob.pos())
+        , _end(ob.end())
+    {
+    }
+
+    outbuf_iterator_base(const outbuf_iterator_base& other) noexcept
+        : _ob(other._ob)
+    {
+        other._detach();
+        _pos = _ob->pos();
+        _end = _ob->end();
+    }
+
+    ~outbuf_iterator_base()
+    {
+        _sync();
+    }
+
+    Derived& operator=(const outbuf_iterator_base& other) noexcept
+    {
+        if (this != &other)
+        {
+            _detach();
+            _ob = other._ob;
+            other._detach();
+            _pos = _ob->pos();
+            _end = _ob->end();
+        }
+        return static_cast<Derived&>(*this);
+    }
+
+    Derived& operator=(CharT ch)
+    {
+        if (_pos == _end)
+        {
+            _next();
+        }
+        *_pos = ch;
+        ++_pos;
+        return static_cast<Derived&>(*this);
+    }
+
+    Derived& operator*() noexcept
+    {
+        return static_cast<Derived&>(*this);
+    }
+    Derived& operator++() noexcept
+    {
+        return static_cast<Derived&>(*this);
+    }
+    Derived& operator++(int) noexcept
+    {
+        return static_cast<Derived&>(*this);
+    }
+
+    template <typename InputIt>
+    friend Derived copy(InputIt first, InputIt last, Derived it)
+    {
+        for (; first != last; ++first)
+        {
+            it = *first;
+        }
+        return it;
+    }
+
+    friend Derived copy(const CharT* first, const CharT* last, Derived it)
+    {
+        BOOST_ASSERT(first <= last);
+        it._write(first, last - first);
+        return it;
+    }
+
+    friend Derived copy(CharT* first, CharT* last, Derived it)
+    {
+        BOOST_ASSERT(first <= last);
+        it._write(first, last - first);
+        return it;
+    }
+
+#if defined(__cpp_lib_concepts)
+
+    template <std::contiguous_iterator InputIt>
+        requires std::same_as<std::iter_value_t<InputIt>, CharT>
+    friend Derived copy(InputIt first, InputIt last, Derived it)
+    {
+        it._write(std::to_address(first), last - first);
+        return it;
+    }
+
+#endif // defined(__cpp_lib_concepts)
+
+private:
+
+    void _sync() const noexcept
+    {
+        if (_pos != nullptr)
+        {
+            _ob->advance_to(_pos);
+        }
+    }
+
+    void _detach() const noexcept
+    {
+        _sync();
+        _pos = nullptr;
+        _end = nullptr;
+    }
+
+    void _next()
+    {
+        if (_pos != nullptr)
+        {
+            _ob->advance_to(_pos);
+            _ob->recycle();
+        }
+        else if (_ob->pos() == _ob->end())
+        {
+            _ob->recycle();
+        }
+        _pos = _ob->pos();
+        _end = _ob->end();
+    }
+
+    void _write(const CharT* str, std::size_t len)
+    {
+        _detach();
+        boost::detail::outbuf_write(*_ob, str, len);
+        _pos = _ob->pos();
+        _end = _ob->end();
+    }
+
+    Outbuf* _ob;
+    mutable CharT* _pos;
+    mutable CharT* _end;
+};
+
+} // namespace detail
+
+template <std::size_t CharSize>
+class underlying_outbuf_iterator
+    : public boost::detail::outbuf_iterator_base
+        < underlying_outbuf_iterator<CharSize>
+        , boost::underlying_outbuf<CharSize>
+        , boost::underlying_outbuf_char_type<CharSize> >
+{
+    using _base = boost::detail::outbuf_iterator_base
+        < underlying_outbuf_iterator<CharSize>
+        , boost::underlying_outbuf<CharSize>
+        , boost::underlying_outbuf_char_type<CharSize> >;
+
+public:
+
+    using _base::_base;
+    using _base::operator=;
+};
+
+template <typename CharT>
+class outbuf_iterator
+    : public boost::detail::outbuf_iterator_base
+        < outbuf_iterator<CharT>, boost::basic_outbuf<CharT>, CharT >
+{
+    using _base = boost::detail::outbuf_iterator_base
+        < outbuf_iterator<CharT>, boost::basic_outbuf<CharT>, CharT >;
+
+public:
+
+    using _base::_base;
+    using _base::operator=;
+};
+
+} // namespace boost
+
+#endif  // BOOST_OUTBUF_ITERATOR_HPP
@@ -0,0 +1,214 @@
+#ifndef BOOST_OUTBUF_JSON_HPP
+#define BOOST_OUTBUF_JSON_HPP
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <boost/outbuf.hpp>
+#include <boost/outbuf/detail/cpu_features.hpp>
+
+#if defined(__SSE2__) && ! defined(BOOST_OUTBUF_NO_SIMD)
+#define BOOST_OUTBUF_JSON_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace boost {
+namespace detail {
+
+inline bool json_needs_escape(std::uint8_t ch) noexcept
+{
+    return ch < 0x20 || ch == '"' || ch == '\\';
+}
+
+inline const std::uint8_t* json_find_escape_scalar
+    ( const std::uint8_t* it
+    , const std::uint8_t* end ) noexcept
+{
+    while (it != end && ! boost::detail::json_needs_escape(*it))
+    {
+        ++it;
+    }
+    return it;
+}
+
+#if defined(BOOST_OUTBUF_JSON_SSE2)
+
+inline int json_escape_mask_sse2(__m128i v) noexcept
+{
+    const __m128i is_ctrl = _mm_cmpeq_epi8
+        ( _mm_min_epu8(v, _mm_set1_epi8(0x1F)), v );
+    const __m128i is_quote = _mm_cmpeq_epi8(v, _mm_set1_epi8('"'));
+    const __m128i is_bslash = _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'));
+    return _mm_movemask_epi8
+        ( _mm_or_si128(is_ctrl, _mm_or_si128(is_quote, is_bslash)) );
+}
+
+// Scans 16 bytes per step
+inline const std::uint8_t* json_find_escape_sse2
+    ( const std::uint8_t* it
+    , const std::uint8_t* end ) noexcept
+{
+    for ( ; end - it >= 16; it += 16)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it));
+        int mask = boost::detail::json_escape_mask_sse2(v);
+        if (mask != 0)
+        {
+            return it + __builtin_ctz(static_cast<unsigned>(mask));
+        }
+    }
+    return boost::detail::json_find_escape_scalar(it, end);
+}
+
+#endif // defined(BOOST_OUTBUF_JSON_SSE2)
+
+#if defined(BOOST_OUTBUF_X86_SIMD) && defined(BOOST_OUTBUF_JSON_SSE2)
+
+// Scans 32 bytes per step
+__attribute__((target("avx2")))
+inline const std::uint8_t* json_find_escape_avx2
+    ( const std::uint8_t* it
+    , const std::uint8_t* end ) noexcept
+{
+    const __m256i ctrl_max = _mm256_set1_epi8(0x1F);
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i bslash = _mm256_set1_epi8('\\');
+    for ( ; end - it >= 32; it += 32)
+    {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(it));
+        const __m256i is_ctrl = _mm256_cmpeq_epi8(_mm256_min_epu8(v, ctrl_max), v);
+        const __m256i is_quote = _mm256_cmpeq_epi8(v, quote);
+        const __m256i is_bslash = _mm256_cmpeq_epi8(v, bslash);
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8
+            ( _mm256_or_si256(is_ctrl, _mm256_or_si256(is_quote, is_bslash)) ));
+        if (mask != 0)
+        {
+            return it + __builtin_ctz(mask);
+        }
+    }
+    return boost::detail::json_find_escape_sse2(it, end);
+}
+
+#endif // defined(BOOST_OUTBUF_X86_SIMD) && defined(BOOST_OUTBUF_JSON_SSE2)
+
+// Returns the first character in [it, end) that needs to
+// be escaped, or end if there is none.
+inline const std::uint8_t* json_find_escape
+    ( const std::uint8_t* it
+    , const std::uint8_t* end ) noexcept
+{
+#if defined(BOOST_OUTBUF_X86_SIMD) && defined(BOOST_OUTBUF_JSON_SSE2)
+
+    if (end - it >= 32 && boost::detail::get_cpu_features().avx2)
+    {
+        return boost::detail::json_find_escape_avx2(it, end);
+    }
+
+#endif
+
+#if defined(BOOST_OUTBUF_JSON_SSE2)
+
+    return boost::detail::json_find_escape_sse2(it, end);
+
+#else
+
+    return boost::detail::json_find_escape_scalar(it, end);
+
+#endif
+}
+
+inline void json_write_escape(boost::underlying_outbuf<1>& ob, std::uint8_t ch)
+{
+    // The escape sequence is never split across recycle()
+    ob.require(6);
+    auto p = ob.pos();
+    p[0] = '\\';
+    switch (ch)
+    {
+        case '"':  p[1] = '"';  break;
+        case '\\': p[1] = '\\'; break;
+        case '\b': p[1] = 'b';  break;
+        case '\f': p[1] = 'f';  break;
+        case '\n': p[1] = 'n';  break;
+        case '\r': p[1] = 'r';  break;
+        case '\t': p[1] = 't';  break;
+        default:
+        {
+            const char* hex = "0123456789abcdef";
+            p[1] = 'u';
+            p[2] = '0';
+            p[3] = '0';
+            p[4] = static_cast<std::uint8_t>(hex[ch >> 4]);
+            p[5] = static_cast<std::uint8_t>(hex[ch & 0xF]);
+            ob.advance(6);
+            return;
+        }
+    }
+    ob.advance(2);
+}
+
+} // namespace detail
+
+// Writes the content of [str, str + len) escaped as in a JSON string,
+// i.e. with '"', '\\' and the control characters escaped. The quotation
+// marks that delimit the string are not written.
+inline void write_json_escaped
+    ( boost::underlying_outbuf<1>& ob
+    , const char* str
+    , std::size_t len )
+{
+    auto it = reinterpret_cast<const std::uint8_t*>(str);
+    auto end = it + len;
+    while (true)
+    {
+        auto hit = boost::detail::json_find_escape(it, end);
+        if (hit != it)
+        {
+            boost::detail::outbuf_write(ob, it, hit - it);
+        }
+        if (hit == end)
+        {
+            return;
+        }
+        boost::detail::json_write_escape(ob, *hit);
+        it = hit + 1;
+    }
+}
+
+inline void write_json_escaped(boost::underlying_outbuf<1>& ob, const char* str)
+{
+    boost::write_json_escaped(ob, str, std::strlen(str));
+}
+
+template <typename CharT>
+inline typename std::enable_if<sizeof(CharT) == 1>::type write_json_escaped
+    ( boost::basic_outbuf<CharT>& ob
+    , const CharT* str
+    , std::size_t len )
+{
+    boost::write_json_escaped
+        ( ob.as_underlying(), reinterpret_cast<const char*>(str), len );
+}
+
+template <typename CharT>
+inline typename std::enable_if<sizeof(CharT) == 1>::type write_json_escaped
+    ( boost::basic_outbuf<CharT>& ob
+    , const CharT* str
+    , const CharT* str_end )
+{
+    BOOST_ASSERT(str <= str_end);
+    boost::write_json_escaped(ob, str, str_end - str);
+}
+
+inline void write_json_escaped(boost::basic_outbuf<char>& ob, const char* str)
+{
+    boost::write_json_escaped(ob.as_underlying(), str, std::strlen(str));
+}
+
+} // namespace boost
+
+#endif  // BOOST_OUTBUF_JSON_HPP
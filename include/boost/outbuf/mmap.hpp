@@ -0,0 +1,259 @@
+#ifndef BOOST_OUTBUF_MMAP_HPP
+#define BOOST_OUTBUF_MMAP_HPP
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <boost/outbuf.hpp>
+
+namespace boost {
+
+template <typename CharT>
+constexpr std::size_t mmap_file_writer_default_window_size()
+{
+    return (4 * 1024 * 1024) / sizeof(CharT);
+}
+
+// Writes into a shared memory mapping of a window of the file, which
+// slides forward on each recycle(). The file is extended ahead of the
+// window and truncated to the length of the content in finish().
+template <typename CharT>
+class basic_mmap_file_writer final: public boost::basic_outbuf_noexcept<CharT>
+{
+public:
+
+    explicit basic_mmap_file_writer
+        ( int fd
+        , std::size_t window_size = boost::mmap_file_writer_default_window_size<CharT>() )
+        : boost::basic_outbuf_noexcept<CharT>
+            ( boost::outbuf_garbage_buf<CharT>()
+            , boost::outbuf_garbage_buf_end<CharT>() )
+        , _fd(fd)
+    {
+        BOOST_ASSERT(fd >= 0);
+        const long page_size = ::sysconf(_SC_PAGESIZE);
+        _page_size = page_size > 0 ? static_cast<std::size_t>(page_size) : 4096;
+        // At least two pages, so that after sliding there is
+        // always room for min_size_after_recycle<CharT>() characters
+        std::size_t bytes = window_size * sizeof(CharT);
+        bytes = (bytes + _page_size - 1) / _page_size * _page_size;
+        _window_bytes = bytes > 2 * _page_size ? bytes : 2 * _page_size;
+
+        const ::off_t offset = ::lseek(fd, 0, SEEK_CUR);
+        const ::off_t file_size = ::lseek(fd, 0, SEEK_END);
+        if (offset < 0 || file_size < 0 || ::lseek(fd, offset, SEEK_SET) < 0)
+        {
+            _fail();
+            return;
+        }
+        BOOST_ASSERT(offset % sizeof(CharT) == 0);
+        _begin_offset = offset;
+        _committed_offset = offset;
+        _file_size = file_size;
+        _initial_file_size = file_size;
+        _map(offset);
+    }
+
+    basic_mmap_file_writer() = delete;
+    basic_mmap_file_writer(const basic_mmap_file_writer&) = delete;
+    basic_mmap_file_writer(basic_mmap_file_writer&&) = delete;
+
+    // Truncates the file to the greater of its initial size and the
+    // size committed by the last call to recycle(), like finish() would
+    // do if good() were false. Only the growth past that size is removed:
+    // since the mapping is shared, the content written since the last
+    // recycle() within the initial length of the file is already in it.
+    ~basic_mmap_file_writer()
+    {
+        _unmap();
+        _truncate();
+    }
+
+    std::size_t window_size() const noexcept
+    {
+        return _window_bytes / sizeof(CharT);
+    }
+
+    std::size_t max_contiguous() const noexcept override
+    {
+        return (_window_bytes - _page_size) / sizeof(CharT);
+    }
+
+    void recycle() noexcept override
+    {
+        if (this->good())
+        {
+            _committed_offset = _current_offset();
+            _unmap();
+            _map(_committed_offset);
+        }
+        else
+        {
+            _unmap();
+            this->set_pos(boost::outbuf_garbage_buf<CharT>());
+            this->set_end(boost::outbuf_garbage_buf_end<CharT>());
+        }
+    }
+
+    struct result
+    {
+        std::size_t count;
+        int errnum;
+        bool success;
+    };
+
+    // If sync is true, also waits for the content to be written
+    // to the storage device.
+    result finish(bool sync = false) noexcept
+    {
+        bool g = this->good();
+        if (g)
+        {
+            _committed_offset = _current_offset();
+        }
+        _unmap();
+        this->set_pos(boost::outbuf_garbage_buf<CharT>());
+        this->set_end(boost::outbuf_garbage_buf_end<CharT>());
+        this->set_good(false);
+        if ( ! _truncate() && g)
+        {
+            _errnum = errno;
+            g = false;
+        }
+        if (g)
+        {
+            // The lseek keeps the file offset consistent with
+            // the content, as if it had been written with ::write
+            if (::lseek(_fd, _committed_offset, SEEK_SET) < 0 || (sync && ::fsync(_fd) != 0))
+            {
+                _errnum = errno;
+                g = false;
+            }
+        }
+        return { static_cast<std::size_t>(_committed_offset - _begin_offset), _errnum, g };
+    }
+
+private:
+
+    ::off_t _current_offset() const noexcept
+    {
+        return _map_offset + ( reinterpret_cast<char*>(this->pos())
+                             - static_cast<char*>(_map_base) );
+    }
+
+    // Removes the part of the file that was extended ahead of the content
+    bool _truncate() noexcept
+    {
+        const ::off_t size = _committed_offset > _initial_file_size
+                           ? _committed_offset : _initial_file_size;
+        if (_file_size > size)
+        {
+            if (::ftruncate(_fd, size) != 0)
+            {
+                return false;
+            }
+            _file_size = size;
+        }
+        return true;
+    }
+
+    // Maps the window that contains the given offset,
+    // extending the file if necessary
+    void _map(::off_t offset) noexcept
+    {
+        const ::off_t map_offset = offset - offset % static_cast<::off_t>(_page_size);
+        const ::off_t map_end = map_offset + static_cast<::off_t>(_window_bytes);
+        if (map_end > _file_size)
+        {
+            // Extending the file costs about as much as filling many pages,
+            // so it is done ahead of the window, in steps that grow with the
+            // content up to 16 windows. The excess is truncated in finish().
+            const ::off_t window = static_cast<::off_t>(_window_bytes);
+            const ::off_t written = offset - _begin_offset;
+            const ::off_t step = written < window ? window
+                               : written < 16 * window ? written
+                               : 16 * window;
+            const ::off_t new_size = map_offset + step > map_end ? map_offset + step : map_end;
+            const ::off_t old_size = _file_size;
+            // Even on failure, the file may have been partially
+            // extended, and needs to be truncated later
+            _file_size = new_size;
+            if ( ! _extend(old_size, new_size))
+            {
+                _fail();
+                return;
+            }
+        }
+        void* p = ::mmap( nullptr, _window_bytes, PROT_READ | PROT_WRITE
+                        , MAP_SHARED, _fd, map_offset );
+        if (p == MAP_FAILED)
+        {
+            _fail();
+            return;
+        }
+        _map_base = p;
+        _map_offset = map_offset;
+        char* base = static_cast<char*>(p);
+        this->set_pos(reinterpret_cast<CharT*>(base + (offset - map_offset)));
+        this->set_end(reinterpret_cast<CharT*>(base + _window_bytes));
+    }
+
+    bool _extend(::off_t old_size, ::off_t size) noexcept
+    {
+#if defined(__linux__)
+        // Unlike ftruncate, allocating the blocks makes a full disk
+        // be reported here, instead of by a SIGBUS later
+        int err = ::posix_fallocate(_fd, old_size, size - old_size);
+        if (err == 0)
+        {
+            return true;
+        }
+        if (err != EOPNOTSUPP && err != EINVAL)
+        {
+            errno = err;
+            return false;
+        }
+#endif
+        return ::ftruncate(_fd, size) == 0;
+    }
+
+    void _unmap() noexcept
+    {
+        if (_map_base != nullptr)
+        {
+            ::munmap(_map_base, _window_bytes);
+            _map_base = nullptr;
+        }
+    }
+
+    void _fail() noexcept
+    {
+        _errnum = errno;
+        this->set_good(false);
+        this->set_pos(boost::outbuf_garbage_buf<CharT>());
+        this->set_end(boost::outbuf_garbage_buf_end<CharT>());
+    }
+
+    int _fd;
+    int _errnum = 0;
+    std::size_t _page_size;
+    std::size_t _window_bytes;
+    void* _map_base = nullptr;
+    ::off_t _map_offset = 0;
+    ::off_t _begin_offset = 0;
+    ::off_t _committed_offset = 0;
+    ::off_t _file_size = 0;
+    ::off_t _initial_file_size = 0;
+};
+
+using mmap_file_writer = basic_mmap_file_writer<char>;
+
+} // namespace boost
+
+#endif  // BOOST_OUTBUF_MMAP_HPP
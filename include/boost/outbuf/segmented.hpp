@@ -0,0 +1,273 @@
+#ifndef BOOST_OUTBUF_SEGMENTED_HPP
+#define BOOST_OUTBUF_SEGMENTED_HPP
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <new>
+#include <string>
+#include <vector>
+#include <boost/outbuf.hpp>
+
+#if ! defined(_WIN32)
+#include <sys/uio.h>
+#define BOOST_OUTBUF_HAS_IOVEC
+#endif
+
+namespace boost {
+
+template <typename CharT>
+constexpr std::size_t segmented_writer_default_segment_size()
+{
+    return (16 * 1024) / sizeof(CharT);
+}
+
+namespace detail {
+
+// The characters of a segment are allocated right after this header
+template <typename CharT>
+struct outbuf_segment
+{
+    outbuf_segment* next;
+    std::size_t size;
+
+    CharT* data() noexcept
+    {
+        return reinterpret_cast<CharT*>(this + 1);
+    }
+};
+
+} // namespace detail
+
+// Writes the content into a chain of segments of the same size. recycle()
+// appends a new segment instead of moving the content into a larger buffer,
+// so the content is never copied. The segments are kept after clear(),
+// and reused by the next content.
+template <typename CharT>
+class basic_segmented_writer final: public boost::basic_outbuf_noexcept<CharT>
+{
+    using segment = boost::detail::outbuf_segment<CharT>;
+
+public:
+
+    explicit basic_segmented_writer
+        ( std::size_t segment_size
+            = boost::segmented_writer_default_segment_size<CharT>() )
+        : boost::basic_outbuf_noexcept<CharT>
+            ( boost::outbuf_garbage_buf<CharT>()
+            , boost::outbuf_garbage_buf_end<CharT>() )
+        , _segment_size( segment_size > boost::min_size_after_recycle<CharT>()
+                       ? segment_size : boost::min_size_after_recycle<CharT>() )
+    {
+        _first = _new_segment();
+        _last = _first;
+        if (_first != nullptr)
+        {
+            _set_current(_first);
+        }
+        else
+        {
+            this->set_good(false);
+        }
+    }
+
+    basic_segmented_writer(const basic_segmented_writer&) = delete;
+    basic_segmented_writer(basic_segmented_writer&&) = delete;
+
+    ~basic_segmented_writer()
+    {
+        _delete_chain(_first);
+        _delete_chain(_free);
+    }
+
+    std::size_t segment_size() const noexcept
+    {
+        return _segment_size;
+    }
+
+    std::size_t max_contiguous() const noexcept override
+    {
+        return _segment_size;
+    }
+
+    void recycle() noexcept override
+    {
+        if ( ! this->good())
+        {
+            this->set_pos(boost::outbuf_garbage_buf<CharT>());
+            return;
+        }
+        _close_current();
+        if (_last->size == 0)
+        {
+            this->set_pos(_last->data());
+            return;
+        }
+        segment* seg = _free;
+        if (seg != nullptr)
+        {
+            _free = seg->next;
+            seg->next = nullptr;
+            seg->size = 0;
+        }
+        else
+        {
+            seg = _new_segment();
+            if (seg == nullptr)
+            {
+                this->set_good(false);
+                this->set_pos(boost::outbuf_garbage_buf<CharT>());
+                this->set_end(boost::outbuf_garbage_buf_end<CharT>());
+                return;
+            }
+        }
+        _last->next = seg;
+        _last = seg;
+        ++_segments_count;
+        _set_current(seg);
+    }
+
+    struct result
+    {
+        std::size_t count;
+        bool success;
+    };
+
+    // Closes the current segment. The content can then be read
+    // through the functions below, until clear() is called.
+    result finish() noexcept
+    {
+        const bool g = this->good();
+        if (g)
+        {
+            _close_current();
+        }
+        this->set_good(false);
+        this->set_pos(boost::outbuf_garbage_buf<CharT>());
+        this->set_end(boost::outbuf_garbage_buf_end<CharT>());
+        return {_count, g};
+    }
+
+    // Discards the content, keeping the segments to be reused
+    void clear() noexcept
+    {
+        if (_first == nullptr)
+        {
+            return;
+        }
+        _last->next = _free;
+        _free = _first->next;
+        _first->next = nullptr;
+        _first->size = 0;
+        _last = _first;
+        _count = 0;
+        _segments_count = 1;
+        this->set_good(true);
+        _set_current(_first);
+    }
+
+    // The number of characters in the closed segments
+    std::size_t count() const noexcept
+    {
+        return _count;
+    }
+
+    std::size_t segments_count() const noexcept
+    {
+        return _first != nullptr ? _segments_count : 0;
+    }
+
+    void copy_to(boost::basic_outbuf<CharT>& dest) const
+    {
+        for (segment* seg = _first; seg != nullptr; seg = seg->next)
+        {
+            boost::detail::outbuf_write(dest, seg->data(), seg->size);
+        }
+    }
+
+    template < typename Traits = std::char_traits<CharT>
+             , typename Allocator = std::allocator<CharT> >
+    std::basic_string<CharT, Traits, Allocator> to_string
+        ( const Allocator& alloc = Allocator() ) const
+    {
+        std::basic_string<CharT, Traits, Allocator> str(alloc);
+        str.reserve(_count);
+        for (segment* seg = _first; seg != nullptr; seg = seg->next)
+        {
+            str.append(seg->data(), seg->size);
+        }
+        return str;
+    }
+
+#if defined(BOOST_OUTBUF_HAS_IOVEC)
+
+    // One iovec per non-empty segment, to be passed to writev or sendmsg
+    std::vector<::iovec> iovecs() const
+    {
+        std::vector<::iovec> v;
+        v.reserve(_segments_count);
+        for (segment* seg = _first; seg != nullptr; seg = seg->next)
+        {
+            if (seg->size != 0)
+            {
+                v.push_back({seg->data(), seg->size * sizeof(CharT)});
+            }
+        }
+        return v;
+    }
+
+#endif // defined(BOOST_OUTBUF_HAS_IOVEC)
+
+private:
+
+    segment* _new_segment() noexcept
+    {
+        void* p = ::operator new
+            ( sizeof(segment) + _segment_size * sizeof(CharT), std::nothrow );
+        if (p == nullptr)
+        {
+            return nullptr;
+        }
+        segment* seg = static_cast<segment*>(p);
+        seg->next = nullptr;
+        seg->size = 0;
+        return seg;
+    }
+
+    static void _delete_chain(segment* seg) noexcept
+    {
+        while (seg != nullptr)
+        {
+            segment* next = seg->next;
+            ::operator delete(seg);
+            seg = next;
+        }
+    }
+
+    void _set_current(segment* seg) noexcept
+    {
+        this->set_pos(seg->data());
+        this->set_end(seg->data() + _segment_size);
+    }
+
+    void _close_current() noexcept
+    {
+        const std::size_t s = this->pos() - _last->data();
+        _count += s - _last->size;
+        _last->size = s;
+    }
+
+    const std::size_t _segment_size;
+    segment* _first = nullptr;
+    segment* _last = nullptr;
+    segment* _free = nullptr;
+    std::size_t _count = 0;
+    std::size_t _segments_count = 1;
+};
+
+using segmented_writer = basic_segmented_writer<char>;
+
+} // namespace boost
+
+#endif  // BOOST_OUTBUF_SEGMENTED_HPP
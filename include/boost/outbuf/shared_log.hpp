@@ -0,0 +1,383 @@
+#ifndef BOOST_OUTBUF_SHARED_LOG_HPP
+#define BOOST_OUTBUF_SHARED_LOG_HPP
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <boost/outbuf.hpp>
+
+namespace boost {
+
+constexpr std::size_t shared_log_sink_default_ring_size = 1024 * 1024;
+
+// Collects records from many threads, each one writing through its own
+// shared_log_writer, and writes them into another outbuf object from a
+// dedicated thread. A record is never interleaved with another one.
+class shared_log_sink
+{
+public:
+
+    explicit shared_log_sink
+        ( boost::basic_outbuf<char>& dest
+        , std::size_t ring_size = boost::shared_log_sink_default_ring_size )
+        : _dest(dest)
+        , _slots_count(_calc_slots_count(ring_size))
+        , _states(new std::atomic<std::uint32_t>[_slots_count])
+        , _data(new char[_slots_count * _slot_size + _slot_size - 1])
+        , _data_begin(_align_to_slot(_data.get()))
+    {
+        for (std::size_t i = 0; i < _slots_count; ++i)
+        {
+            _states[i].store(0, std::memory_order_relaxed);
+        }
+        _thread = std::thread([this]{ _run(); });
+    }
+
+    shared_log_sink(const shared_log_sink&) = delete;
+    shared_log_sink(shared_log_sink&&) = delete;
+
+    ~shared_log_sink()
+    {
+        if (_thread.joinable())
+        {
+            _stop_thread();
+        }
+    }
+
+    // Records longer than that are split
+    std::size_t max_record_size() const noexcept
+    {
+        return _slots_count / 2 * _slot_size;
+    }
+
+    // The number of records taken from the ring so far
+    std::size_t records_count() const noexcept
+    {
+        return _records_count.load(std::memory_order_relaxed);
+    }
+
+    // How many times a thread had to wait because the ring was full
+    std::size_t full_waits() const noexcept
+    {
+        return _full_waits.load(std::memory_order_relaxed);
+    }
+
+    // Copies [data, data + len) into the ring as a single record, waiting
+    // while the ring is full. Returns false if finish() has been called.
+    bool push(const char* data, std::size_t len) noexcept
+    {
+        BOOST_ASSERT(len <= max_record_size());
+        if (len == 0)
+        {
+            return true;
+        }
+        if (_stop.load(std::memory_order_relaxed))
+        {
+            return false;
+        }
+        const std::size_t k = (len + _slot_size - 1) / _slot_size;
+        std::uint64_t r = _reserved.load(std::memory_order_relaxed);
+        std::size_t index;
+        std::size_t needed;
+        bool waited = false;
+        while (true)
+        {
+            index = static_cast<std::size_t>(r % _slots_count);
+            // If the record does not fit before the end of the ring,
+            // the remaining slots are skipped
+            needed = index + k > _slots_count ? _slots_count - index + k : k;
+            if (r + needed - _read.load(std::memory_order_acquire) > _slots_count)
+            {
+                // r may be outdated, in which case the ring may not be full
+                const std::uint64_t r2 = _reserved.load(std::memory_order_relaxed);
+                if (r2 == r)
+                {
+                    if ( ! waited)
+                    {
+                        waited = true;
+                        _full_waits.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    std::this_thread::yield();
+                }
+                r = r2;
+                continue;
+            }
+            if (_reserved.compare_exchange_weak(r, r + needed, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        if (needed != k)
+        {
+            // An even state tells how many slots to skip
+            _states[index].store( static_cast<std::uint32_t>((_slots_count - index) << 1)
+                                , std::memory_order_release );
+            index = 0;
+        }
+        std::memcpy(_slot(index), data, len);
+        // An odd state tells the length of the record
+        _states[index].store( static_cast<std::uint32_t>((len << 1) | 1)
+                            , std::memory_order_release );
+        // Ensures that either the consumer sees the record,
+        // or this thread sees that the consumer is waiting
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (_consumer_waiting.load(std::memory_order_relaxed))
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _consumer_cv.notify_one();
+        }
+        return true;
+    }
+
+    struct result
+    {
+        std::size_t count;
+        bool success;
+    };
+
+    // Waits until all the records are written into the destination,
+    // and stops the thread. No shared_log_writer shall be in use
+    // during or after this call. finish() of the destination
+    // is not called.
+    result finish() noexcept
+    {
+        if (_thread.joinable())
+        {
+            _stop_thread();
+        }
+        return {_count, ! _dest_failed};
+    }
+
+private:
+
+    // Each record starts at a new cache line, so that threads
+    // writing adjacent records do not contend for it
+    static constexpr std::size_t _slot_size = 64;
+
+    char* _slot(std::size_t index) const noexcept
+    {
+        return _data_begin + index * _slot_size;
+    }
+
+    static char* _align_to_slot(char* p) noexcept
+    {
+        const std::uintptr_t x = reinterpret_cast<std::uintptr_t>(p);
+        return p + ((_slot_size - x % _slot_size) % _slot_size);
+    }
+
+    static std::size_t _calc_slots_count(std::size_t ring_size) noexcept
+    {
+        std::size_t n = ring_size / _slot_size;
+        // the length of a record must fit in the 31 bits of the state
+        constexpr std::size_t max_n = (std::size_t(1) << 31) / _slot_size;
+        return n < 4 ? 4 : n > max_n ? max_n : n;
+    }
+
+    void _stop_thread() noexcept
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop.store(true);
+            _consumer_cv.notify_one();
+        }
+        _thread.join();
+    }
+
+    void _run() noexcept
+    {
+        std::uint64_t read = 0;
+        while (true)
+        {
+            const std::size_t index = static_cast<std::size_t>(read % _slots_count);
+            const std::uint32_t state = _states[index].load(std::memory_order_acquire);
+            if (state != 0)
+            {
+                std::size_t k = state >> 1;
+                if (state & 1)
+                {
+                    _write_into_dest(_slot(index), k);
+                    k = (k + _slot_size - 1) / _slot_size;
+                }
+                _states[index].store(0, std::memory_order_relaxed);
+                read += k;
+                _read.store(read, std::memory_order_release);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(_mutex);
+            _consumer_waiting.store(true);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            _consumer_cv.wait(lock, [&]{
+                    return _states[index].load(std::memory_order_acquire) != 0
+                        || ( _stop.load()
+                          && _reserved.load(std::memory_order_relaxed) == read );
+                });
+            _consumer_waiting.store(false, std::memory_order_relaxed);
+            if (_states[index].load(std::memory_order_acquire) == 0)
+            {
+                return;
+            }
+        }
+    }
+
+    void _write_into_dest(const char* data, std::size_t len) noexcept
+    {
+        _records_count.fetch_add(1, std::memory_order_relaxed);
+        if (_dest_failed)
+        {
+            return;
+        }
+#if defined(__cpp_exceptions)
+        try
+        {
+            boost::detail::outbuf_write(_dest, data, len);
+        }
+        catch(...)
+        {
+            _dest_failed = true;
+            return;
+        }
+#else
+        boost::detail::outbuf_write(_dest, data, len);
+#endif
+        if (_dest.good())
+        {
+            _count += len;
+        }
+        else
+        {
+            _dest_failed = true;
+        }
+    }
+
+    boost::basic_outbuf<char>& _dest;
+    const std::size_t _slots_count;
+    std::unique_ptr<std::atomic<std::uint32_t>[]> _states;
+    std::unique_ptr<char[]> _data;
+    char* const _data_begin;
+    alignas(64) std::atomic<std::uint64_t> _reserved {0};
+    alignas(64) std::atomic<std::uint64_t> _read {0};
+    alignas(64) std::atomic<bool> _consumer_waiting {false};
+    std::atomic<bool> _stop {false};
+    std::atomic<std::size_t> _full_waits {0};
+    std::atomic<std::size_t> _records_count {0};
+    // only accessed by the consumer until it is joined
+    std::size_t _count = 0;
+    bool _dest_failed = false;
+    std::mutex _mutex;
+    std::condition_variable _consumer_cv;
+    std::thread _thread;
+};
+
+// The outbuf where each thread builds its records. Everything written
+// between two calls to commit() is pushed into the sink as one record.
+class shared_log_writer final: public boost::basic_outbuf_noexcept<char>
+{
+public:
+
+    explicit shared_log_writer
+        ( boost::shared_log_sink& sink
+        , std::size_t buf_size = 1024 )
+        : boost::basic_outbuf_noexcept<char>(_small_buf, _small_buf_size)
+        , _sink(sink)
+    {
+        if (buf_size > sink.max_record_size())
+        {
+            buf_size = sink.max_record_size();
+        }
+        if (buf_size > _small_buf_size)
+        {
+            _set_buffer(new (std::nothrow) char[buf_size], buf_size);
+        }
+    }
+
+    shared_log_writer(const shared_log_writer&) = delete;
+    shared_log_writer(shared_log_writer&&) = delete;
+
+    // The content written since the last call to commit() is discarded
+    ~shared_log_writer()
+    {
+        if (_buf != _small_buf)
+        {
+            delete [] _buf;
+        }
+    }
+
+    std::size_t buffer_size() const noexcept
+    {
+        return _buf_size;
+    }
+
+    void commit() noexcept
+    {
+        if (this->good() && ! _sink.push(_buf, this->pos() - _buf))
+        {
+            this->set_good(false);
+        }
+        this->set_pos(_buf);
+    }
+
+    // Called when the record does not fit in the buffer. Moves it into
+    // a buffer twice as large, or, if the maximum record size is reached,
+    // pushes the content into the sink as a part of the record.
+    void recycle() noexcept override
+    {
+        if ( ! this->good())
+        {
+            this->set_pos(_buf);
+            return;
+        }
+        const std::size_t len = this->pos() - _buf;
+        const std::size_t max_size = _sink.max_record_size();
+        if (_buf_size < max_size)
+        {
+            const std::size_t new_size = 2 * _buf_size < max_size ? 2 * _buf_size : max_size;
+            char* new_buf = new (std::nothrow) char[new_size];
+            if (new_buf != nullptr)
+            {
+                std::memcpy(new_buf, _buf, len);
+                if (_buf != _small_buf)
+                {
+                    delete [] _buf;
+                }
+                _set_buffer(new_buf, new_size);
+                this->set_pos(new_buf + len);
+                return;
+            }
+        }
+        commit();
+    }
+
+private:
+
+    void _set_buffer(char* buf, std::size_t size) noexcept
+    {
+        if (buf != nullptr)
+        {
+            _buf = buf;
+            _buf_size = size;
+            this->set_pos(buf);
+            this->set_end(buf + size);
+        }
+    }
+
+    static constexpr std::size_t _small_buf_size
+        = boost::min_size_after_recycle<char>();
+
+    boost::shared_log_sink& _sink;
+    char* _buf = _small_buf;
+    std::size_t _buf_size = _small_buf_size;
+    char _small_buf[_small_buf_size];
+};
+
+} // namespace boost
+
+#endif  // BOOST_OUTBUF_SHARED_LOG_HPP
@@ -0,0 +1,267 @@
+#ifndef BOOST_OUTBUF_STATIC_HPP
+#define BOOST_OUTBUF_STATIC_HPP
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <utility>
+#include <boost/outbuf.hpp>
+
+namespace boost {
+
+// Same interface as basic_outbuf, but without virtual functions:
+// Derived shall provide a public recycle() function, which is called
+// directly and hence can be inlined. It is meant to be used by
+// serializers that are templates on the output buffer type.
+template <typename Derived, typename CharT>
+class static_outbuf
+{
+public:
+
+    using char_type = CharT;
+
+    static_outbuf(const static_outbuf&) = delete;
+    static_outbuf(static_outbuf&&) = delete;
+    static_outbuf& operator=(const static_outbuf&) = delete;
+    static_outbuf& operator=(static_outbuf&&) = delete;
+
+    CharT* pos() const noexcept
+    {
+        return _pos;
+    }
+    CharT* end() const noexcept
+    {
+        return _end;
+    }
+    std::size_t size() const noexcept
+    {
+        BOOST_ASSERT(_pos <= _end);
+        return _end - _pos;
+    }
+    bool good() const noexcept
+    {
+        return _good;
+    }
+    void advance_to(CharT* p)
+    {
+        BOOST_ASSERT(_pos <= p);
+        BOOST_ASSERT(p <= _end);
+        _pos = p;
+    }
+    void advance(std::size_t n)
+    {
+        BOOST_ASSERT(pos() + n <= end());
+        _pos += n;
+    }
+    void advance() noexcept
+    {
+        BOOST_ASSERT(pos() < end());
+        ++_pos;
+    }
+    void require(std::size_t s)
+    {
+        BOOST_ASSERT(s <= boost::min_size_after_recycle<CharT>());
+        if (pos() + s > end())
+        {
+            static_cast<Derived*>(this)->recycle();
+        }
+        BOOST_ASSERT(pos() + s <= end());
+    }
+    void ensure(std::size_t s)
+    {
+        require(s);
+    }
+
+protected:
+
+    static_outbuf(CharT* pos_, CharT* end_) noexcept
+        : _pos(pos_), _end(end_)
+    { }
+
+    static_outbuf(CharT* pos_, std::size_t s) noexcept
+        : _pos(pos_), _end(pos_ + s)
+    { }
+
+    ~static_outbuf() = default;
+
+    void set_pos(CharT* p) noexcept
+    { _pos = p; };
+    void set_end(CharT* e) noexcept
+    { _end = e; };
+    void set_good(bool g) noexcept
+    { _good = g; };
+
+private:
+
+    CharT* _pos;
+    CharT* _end;
+    bool _good = true;
+};
+
+// Views a writer derived from basic_outbuf as a static_outbuf. When Writer
+// is a final class, like the writers of this library, the compiler can
+// call its recycle() without virtual dispatch, and inline it.
+// The position is kept in this object and is only passed back to
+// the writer on recycle() and on destruction, so that the
+// compiler can keep it in a register.
+template <typename Writer>
+class static_outbuf_ref final
+    : public boost::static_outbuf
+        < static_outbuf_ref<Writer>, typename Writer::char_type >
+{
+    using _char_type = typename Writer::char_type;
+    using _base = boost::static_outbuf<static_outbuf_ref<Writer>, _char_type>;
+
+public:
+
+    explicit static_outbuf_ref(Writer& writer) noexcept
+        : _base(writer.pos(), writer.end())
+        , _writer(writer)
+    {
+        this->set_good(writer.good());
+    }
+
+    ~static_outbuf_ref()
+    {
+        _writer.advance_to(this->pos());
+    }
+
+    void recycle() noexcept(noexcept(std::declval<Writer&>().recycle()))
+    {
+        _writer.advance_to(this->pos());
+        _writer.recycle();
+        this->set_pos(_writer.pos());
+        this->set_end(_writer.end());
+        this->set_good(_writer.good());
+    }
+
+    bool write_direct(const _char_type* str, std::size_t len)
+    {
+        _writer.advance_to(this->pos());
+        bool done = _writer.write_direct(str, len);
+        this->set_pos(_writer.pos());
+        this->set_end(_writer.end());
+        this->set_good(_writer.good());
+        return done;
+    }
+
+    Writer& writer() const noexcept
+    {
+        return _writer;
+    }
+
+private:
+
+    Writer& _writer;
+};
+
+// Views a static_outbuf as a basic_outbuf, in order to pass it to functions
+// that take a basic_outbuf reference. Like in static_outbuf_ref, the position
+// is only passed back to the static_outbuf on recycle() and on destruction.
+template <typename StaticOutbuf>
+class dynamic_outbuf_ref final
+    : public boost::basic_outbuf<typename StaticOutbuf::char_type>
+{
+    using _char_type = typename StaticOutbuf::char_type;
+
+public:
+
+    explicit dynamic_outbuf_ref(StaticOutbuf& dest) noexcept
+        : boost::basic_outbuf<_char_type>(dest.pos(), dest.end())
+        , _dest(dest)
+    {
+        this->set_good(dest.good());
+    }
+
+    ~dynamic_outbuf_ref()
+    {
+        _dest.advance_to(this->pos());
+    }
+
+    void recycle() override
+    {
+        _dest.advance_to(this->pos());
+        _dest.recycle();
+        this->set_pos(_dest.pos());
+        this->set_end(_dest.end());
+        this->set_good(_dest.good());
+    }
+
+protected:
+
+    bool do_write_direct(const _char_type* str, std::size_t len) override
+    {
+        _dest.advance_to(this->pos());
+        bool done = boost::detail::outbuf_try_write_direct(_dest, str, len, 0);
+        this->set_pos(_dest.pos());
+        this->set_end(_dest.end());
+        this->set_good(_dest.good());
+        return done;
+    }
+
+private:
+
+    StaticOutbuf& _dest;
+};
+
+// global functions
+
+template <typename Derived, typename CharT>
+inline void write( boost::static_outbuf<Derived, CharT>& ob
+                 , const CharT* str
+                 , std::size_t len )
+{
+    boost::detail::outbuf_write(static_cast<Derived&>(ob), str, len);
+}
+
+template <typename Derived, typename CharT>
+inline void write( boost::static_outbuf<Derived, CharT>& ob
+                 , const CharT* str
+                 , const CharT* str_end )
+{
+    BOOST_ASSERT(str_end >= str);
+    boost::detail::outbuf_write(static_cast<Derived&>(ob), str, str_end - str);
+}
+
+template <typename Derived>
+inline void write( boost::static_outbuf<Derived, char>& ob
+                 , const char* str )
+{
+    boost::detail::outbuf_write(static_cast<Derived&>(ob), str, std::strlen(str));
+}
+
+template <typename Derived>
+inline void write( boost::static_outbuf<Derived, wchar_t>& ob
+                 , const wchar_t* str )
+{
+    boost::detail::outbuf_write(static_cast<Derived&>(ob), str, std::wcslen(str));
+}
+
+template <typename Derived, typename CharT, std::size_t Len>
+inline void write( boost::static_outbuf<Derived, CharT>& ob
+                 , boost::basic_literal<CharT, Len> literal )
+{
+    boost::detail::outbuf_write(static_cast<Derived&>(ob), literal.str, Len);
+}
+
+template <typename Derived, typename CharT, typename Arg, typename... Args>
+inline void write_all( boost::static_outbuf<Derived, CharT>& ob
+                     , const Arg& arg
+                     , const Args&... args )
+{
+    boost::detail::outbuf_write_pieces
+        ( static_cast<Derived&>(ob)
+        , boost::detail::outbuf_piece_maker<CharT, Arg>::make(arg)
+        , boost::detail::outbuf_piece_maker<CharT, Args>::make(args)... );
+}
+
+template <typename Derived, typename CharT>
+inline void put( boost::static_outbuf<Derived, CharT>& ob, CharT c )
+{
+    boost::detail::outbuf_put(static_cast<Derived&>(ob), c);
+}
+
+} // namespace boost
+
+#endif  // BOOST_OUTBUF_STATIC_HPP
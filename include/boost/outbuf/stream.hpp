@@ -0,0 +1,242 @@
+#ifndef BOOST_OUTBUF_STREAM_HPP
+#define BOOST_OUTBUF_STREAM_HPP
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <cstdint>
+#include <cstring>
+#include <boost/outbuf.hpp>
+#include <boost/outbuf/detail/cpu_features.hpp>
+
+namespace boost {
+
+// The size in bytes from which write_stream uses non-temporal stores
+constexpr std::size_t write_stream_default_threshold()
+{
+    return 1024 * 1024;
+}
+
+enum class stream_copy_kernel { plain, avx2, avx512 };
+
+namespace detail {
+
+#if defined(BOOST_OUTBUF_X86_SIMD)
+
+// The destination is aligned to 32 bytes with a memcpy of the first bytes,
+// so that the stores in the loop are aligned, as required by vmovntdq
+__attribute__((target("avx2")))
+inline void stream_copy_avx2
+    ( std::uint8_t* dest
+    , const std::uint8_t* src
+    , std::size_t len ) noexcept
+{
+    std::size_t head = (32 - (reinterpret_cast<std::uintptr_t>(dest) & 31)) & 31;
+    std::memcpy(dest, src, head);
+    dest += head;
+    src += head;
+    len -= head;
+    for ( ; len >= 128; len -= 128, dest += 128, src += 128)
+    {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 32));
+        __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 64));
+        __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 96));
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dest), a);
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dest + 32), b);
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dest + 64), c);
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dest + 96), d);
+    }
+    for ( ; len >= 32; len -= 32, dest += 32, src += 32)
+    {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dest), a);
+    }
+    _mm_sfence();
+    std::memcpy(dest, src, len);
+}
+
+__attribute__((target("avx512f")))
+inline void stream_copy_avx512
+    ( std::uint8_t* dest
+    , const std::uint8_t* src
+    , std::size_t len ) noexcept
+{
+    std::size_t head = (64 - (reinterpret_cast<std::uintptr_t>(dest) & 63)) & 63;
+    std::memcpy(dest, src, head);
+    dest += head;
+    src += head;
+    len -= head;
+    for ( ; len >= 256; len -= 256, dest += 256, src += 256)
+    {
+        __m512i a = _mm512_loadu_si512(src);
+        __m512i b = _mm512_loadu_si512(src + 64);
+        __m512i c = _mm512_loadu_si512(src + 128);
+        __m512i d = _mm512_loadu_si512(src + 192);
+        _mm512_stream_si512(reinterpret_cast<__m512i*>(dest), a);
+        _mm512_stream_si512(reinterpret_cast<__m512i*>(dest + 64), b);
+        _mm512_stream_si512(reinterpret_cast<__m512i*>(dest + 128), c);
+        _mm512_stream_si512(reinterpret_cast<__m512i*>(dest + 192), d);
+    }
+    for ( ; len >= 64; len -= 64, dest += 64, src += 64)
+    {
+        __m512i a = _mm512_loadu_si512(src);
+        _mm512_stream_si512(reinterpret_cast<__m512i*>(dest), a);
+    }
+    _mm_sfence();
+    std::memcpy(dest, src, len);
+}
+
+#endif // defined(BOOST_OUTBUF_X86_SIMD)
+
+inline void stream_copy_memcpy
+    ( std::uint8_t* dest
+    , const std::uint8_t* src
+    , std::size_t len ) noexcept
+{
+    std::memcpy(dest, src, len);
+}
+
+using stream_copy_function = void (*)(std::uint8_t*, const std::uint8_t*, std::size_t);
+
+// Falls back to memcpy when k is not supported
+inline stream_copy_function stream_copy_function_of(stream_copy_kernel k) noexcept
+{
+#if defined(BOOST_OUTBUF_X86_SIMD)
+
+    const auto& cpu = boost::detail::get_cpu_features();
+    if (k == stream_copy_kernel::avx512 && cpu.avx512f)
+    {
+        return boost::detail::stream_copy_avx512;
+    }
+    if (k != stream_copy_kernel::plain && cpu.avx2)
+    {
+        return boost::detail::stream_copy_avx2;
+    }
+
+#else
+
+    (void) k;
+
+#endif // defined(BOOST_OUTBUF_X86_SIMD)
+
+    return boost::detail::stream_copy_memcpy;
+}
+
+template <typename Outbuf, typename CharT>
+void outbuf_write_stream
+    ( Outbuf& ob
+    , const CharT* str
+    , std::size_t len
+    , std::size_t threshold
+    , stream_copy_function copy )
+{
+    if (len * sizeof(CharT) < threshold)
+    {
+        boost::detail::outbuf_write(ob, str, len);
+        return;
+    }
+    if ( len > ob.size()
+      && boost::detail::outbuf_try_write_direct(ob, str, len, 0) )
+    {
+        return;
+    }
+    while (true)
+    {
+        std::size_t space = ob.size();
+        std::size_t n = len < space ? len : space;
+        std::size_t bytes = n * sizeof(CharT);
+        auto dest = reinterpret_cast<std::uint8_t*>(ob.pos());
+        auto src = reinterpret_cast<const std::uint8_t*>(str);
+        if (bytes >= threshold && bytes >= 256)
+        {
+            copy(dest, src, bytes);
+        }
+        else
+        {
+            std::memcpy(dest, src, bytes);
+        }
+        ob.advance(n);
+        str += n;
+        len -= n;
+        if (len == 0 || ! ob.good())
+        {
+            break;
+        }
+        ob.recycle();
+    }
+}
+
+} // namespace detail
+
+inline bool stream_copy_kernel_supported(boost::stream_copy_kernel k) noexcept
+{
+#if defined(BOOST_OUTBUF_X86_SIMD)
+
+    const auto& cpu = boost::detail::get_cpu_features();
+    switch (k)
+    {
+        case stream_copy_kernel::avx512: return cpu.avx512f;
+        case stream_copy_kernel::avx2:   return cpu.avx2;
+        default:                         return true;
+    }
+
+#else
+
+    return k == stream_copy_kernel::plain;
+
+#endif // defined(BOOST_OUTBUF_X86_SIMD)
+}
+
+inline boost::stream_copy_kernel stream_copy_best_kernel() noexcept
+{
+    static const stream_copy_kernel k
+        = boost::stream_copy_kernel_supported(stream_copy_kernel::avx512) ? stream_copy_kernel::avx512
+        : boost::stream_copy_kernel_supported(stream_copy_kernel::avx2)   ? stream_copy_kernel::avx2
+        : stream_copy_kernel::plain;
+    return k;
+}
+
+// Same as write, except that the chunks of threshold bytes or
+// more are copied with non-temporal stores, which do not pull the
+// destination into the cache.
+template <std::size_t CharSize>
+inline void write_stream
+    ( boost::underlying_outbuf<CharSize>& ob
+    , const boost::underlying_outbuf_char_type<CharSize>* str
+    , std::size_t len
+    , std::size_t threshold = boost::write_stream_default_threshold()
+    , boost::stream_copy_kernel k = boost::stream_copy_best_kernel() )
+{
+    boost::detail::outbuf_write_stream
+        ( ob, str, len, threshold, boost::detail::stream_copy_function_of(k) );
+}
+
+template <typename CharT>
+inline void write_stream
+    ( boost::basic_outbuf<CharT>& ob
+    , const CharT* str
+    , std::size_t len
+    , std::size_t threshold = boost::write_stream_default_threshold()
+    , boost::stream_copy_kernel k = boost::stream_copy_best_kernel() )
+{
+    boost::detail::outbuf_write_stream
+        ( ob, str, len, threshold, boost::detail::stream_copy_function_of(k) );
+}
+
+template <typename CharT>
+inline void write_stream
+    ( boost::basic_outbuf_noexcept<CharT>& ob
+    , const CharT* str
+    , std::size_t len
+    , std::size_t threshold = boost::write_stream_default_threshold()
+    , boost::stream_copy_kernel k = boost::stream_copy_best_kernel() ) noexcept
+{
+    boost::detail::outbuf_write_stream
+        ( ob, str, len, threshold, boost::detail::stream_copy_function_of(k) );
+}
+
+} // namespace boost
+
+#endif  // BOOST_OUTBUF_STREAM_HPP
@@ -21,7 +21,7 @@ public:
 
     explicit basic_streambuf_writer(std::basic_streambuf<CharT, Traits>& dest_)
         : boost::basic_outbuf<CharT>(_buf, _buf_size)
-        , _dest(dest_)
+        , _dest(&dest_)
     {
     }
 
@@ -33,13 +33,28 @@ public:
     {
     }
 
+    // Discards the content written since the last call to recycle(),
+    // and makes the object ready to write again, as if it were constructed
+    void reset() noexcept
+    {
+        _count = 0;
+        this->set_good(true);
+        this->set_pos(_buf);
+    }
+
+    void reset(std::basic_streambuf<CharT, Traits>& dest_) noexcept
+    {
+        _dest = &dest_;
+        reset();
+    }
+
     void recycle() override
     {
         std::streamsize count = this->pos() - _buf;
         this->set_pos(_buf);
         if (this->good())
         {
-            auto count_inc = _dest.sputn(_buf, count);
+            auto count_inc = _dest->sputn(_buf, count);
             _count += count_inc;
             this->set_good(count_inc == count);
         }
@@ -59,16 +74,36 @@ public:
         this->set_good(false);
         if (g)
         {
-            auto count_inc = _dest.sputn(_buf, count);
+            auto count_inc = _dest->sputn(_buf, count);
             _count += count_inc;
             g = (count_inc == count);
         }
         return {_count, g};
     }
 
+protected:
+
+    // Blocks that do not fit in the buffer are passed to sputn as they are
+    bool do_write_direct(const CharT* str, std::size_t len) override
+    {
+        if (len < _buf_size || ! this->good())
+        {
+            return false;
+        }
+        recycle();
+        if (this->good())
+        {
+            auto count = static_cast<std::streamsize>(len);
+            auto count_inc = _dest->sputn(str, count);
+            _count += count_inc;
+            this->set_good(count_inc == count);
+        }
+        return true;
+    }
+
 private:
 
-    std::basic_streambuf<CharT, Traits>& _dest;
+    std::basic_streambuf<CharT, Traits>* _dest;
     std::streamsize _count = 0;
     static constexpr std::size_t _buf_size
         = boost::min_size_after_recycle<CharT>();
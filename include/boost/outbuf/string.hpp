@@ -9,6 +9,12 @@
 #if defined(__cpp_exceptions)
 #include <exception>
 #endif
+#if defined(__has_include)
+#if __has_include(<memory_resource>) && \
+    (__cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L))
+#include <memory_resource>
+#endif
+#endif
 
 #include <boost/outbuf.hpp>
 
@@ -41,6 +47,24 @@ public:
             static_cast<T*>(this)->set_good(true);
         }
     }
+    void do_reset() noexcept
+    {
+    }
+
+    // Appends the content of the buffer and then [str, str + len)
+    bool do_append_direct(const CharT* str, std::size_t len)
+    {
+        if (len < _buf_size || ! static_cast<T*>(this)->good())
+        {
+            return false;
+        }
+        do_recycle();
+        static_cast<T*>(this)->set_good(false);
+        static_cast<T*>(this)->_append(str, str + len);
+        static_cast<T*>(this)->set_good(true);
+        return true;
+    }
+
     void do_finish()
     {
         auto * p = static_cast<T*>(this)->pos();
@@ -103,6 +127,33 @@ public:
         }
     }
 
+    void do_reset() noexcept
+    {
+        _eptr = nullptr;
+    }
+
+    bool do_append_direct(const CharT* str, std::size_t len) noexcept
+    {
+        if (len < _buf_size || ! static_cast<T*>(this)->good())
+        {
+            return false;
+        }
+        do_recycle();
+        if (static_cast<T*>(this)->good())
+        {
+            try
+            {
+                static_cast<T*>(this)->_append(str, str + len);
+            }
+            catch(...)
+            {
+                _eptr = std::current_exception();
+                static_cast<T*>(this)->set_good(false);
+            }
+        }
+        return true;
+    }
+
     void do_finish()
     {
         if (_eptr != nullptr)
@@ -170,7 +221,7 @@ class basic_string_appender_impl
 {
 public:
 
-    using string_type = std::basic_string<CharT, Traits>;
+    using string_type = std::basic_string<CharT, Traits, Allocator>;
 
     basic_string_appender_impl(string_type& str_)
         : boost::detail::basic_outbuf_noexcept_switch<NoExcept, CharT>
@@ -222,7 +273,7 @@ class basic_string_maker_impl
 {
 public:
 
-    using string_type = std::basic_string<CharT, Traits>;
+    using string_type = std::basic_string<CharT, Traits, Allocator>;
 
     basic_string_maker_impl()
         : boost::detail::basic_outbuf_noexcept_switch<NoExcept, CharT>
@@ -233,6 +284,16 @@ public:
         this->set_end(this->buf_end());
     }
 
+    explicit basic_string_maker_impl(const Allocator& alloc)
+        : boost::detail::basic_outbuf_noexcept_switch<NoExcept, CharT>
+            ( boost::outbuf_garbage_buf<CharT>()
+            , boost::outbuf_garbage_buf_end<CharT>() )
+        , _str(alloc)
+    {
+        this->set_pos(this->buf_begin());
+        this->set_end(this->buf_end());
+    }
+
     basic_string_maker_impl(const basic_string_maker_impl&) = delete;
     basic_string_maker_impl(basic_string_maker_impl&&) = delete;
     ~basic_string_maker_impl() = default;
@@ -243,6 +304,25 @@ public:
         return std::move(_str);
     }
 
+    // Swaps the content with dest, so that the next content,
+    // after reset(), is written into the capacity of dest
+    void finish(string_type& dest)
+    {
+        this->do_finish();
+        _str.swap(dest);
+    }
+
+    // Discards the content, but not the capacity of the string, and
+    // makes the object ready to write again, as if it were constructed
+    void reset() noexcept
+    {
+        _str.clear();
+        this->do_reset();
+        this->set_good(true);
+        this->set_pos(this->buf_begin());
+        this->set_end(this->buf_end());
+    }
+
     void do_reserve(std::size_t s)
     {
         _str.reserve(s);
@@ -261,7 +341,361 @@ private:
     string_type _str;
 };
 
+template <typename String>
+inline void string_resize_for_overwrite(String& str, std::size_t size)
+{
+#if defined(__cpp_lib_string_resize_and_overwrite)
+    using char_type = typename String::value_type;
+    str.resize_and_overwrite(size, [](char_type*, std::size_t s){ return s; });
+#else
+    str.resize(size);
+#endif
+}
+
+// The content is written directly into the string. Its size is kept
+// equal to its capacity, and the range [ pos(), end() ) lies in
+// the unused tail, which is cut away in do_finish().
+template <typename T, bool NoExcept, typename CharT>
+class direct_string_writer_mixin;
+
+template <typename T, typename CharT>
+class direct_string_writer_mixin<T, false, CharT>
+{
+public:
+
+    direct_string_writer_mixin() = default;
+
+    void do_recycle()
+    {
+        auto* self = static_cast<T*>(this);
+        if (self->good())
+        {
+            _commit();
+            self->set_good(false);
+            _grow(boost::min_size_after_recycle<CharT>());
+            self->set_good(true);
+        }
+        else
+        {
+            self->set_pos(boost::outbuf_garbage_buf<CharT>());
+        }
+    }
+
+    bool do_grow(std::size_t s)
+    {
+        auto* self = static_cast<T*>(this);
+        if (self->good())
+        {
+            _commit();
+            self->set_good(false);
+            _grow(s);
+            self->set_good(true);
+            return true;
+        }
+        if (s <= boost::min_size_after_recycle<CharT>())
+        {
+            self->set_pos(boost::outbuf_garbage_buf<CharT>());
+            return true;
+        }
+        return false;
+    }
+
+    std::size_t do_max_contiguous() const noexcept
+    {
+        auto* self = static_cast<const T*>(this);
+        if (self->good())
+        {
+            return self->_string().max_size() - _committed;
+        }
+        return boost::min_size_after_recycle<CharT>();
+    }
+
+    // If additional is true, reserves space for s characters after
+    // the content written so far. Otherwise, for s characters in total.
+    void do_reserve(std::size_t s, bool additional)
+    {
+        auto* self = static_cast<T*>(this);
+        if (self->good())
+        {
+            _commit();
+            self->set_good(false);
+            auto& str = self->_string();
+            str.resize(_committed);
+            str.reserve(additional ? _committed + s : s);
+            _grow(0);
+            self->set_good(true);
+        }
+    }
+
+    void do_finish()
+    {
+        auto* self = static_cast<T*>(this);
+        if (self->good())
+        {
+            _commit();
+            self->set_good(false);
+        }
+        _trim();
+    }
+
+protected:
+
+    void init_direct_writer()
+    {
+        auto& str = static_cast<T*>(this)->_string();
+        _committed = str.size();
+        _set_window();
+    }
+
+    void _trim()
+    {
+        auto* self = static_cast<T*>(this);
+        self->set_pos(boost::outbuf_garbage_buf<CharT>());
+        self->set_end(boost::outbuf_garbage_buf_end<CharT>());
+        self->_string().resize(_committed);
+    }
+
+    void _commit()
+    {
+        auto* self = static_cast<T*>(this);
+        auto& str = self->_string();
+        CharT* begin = &str[0] + _committed;
+        CharT* end = &str[0] + str.size();
+        auto* p = self->pos();
+        if (begin <= p)
+        {
+            if (p > end)
+            {
+                p = end;
+            }
+            _committed += (p - begin);
+        }
+        self->set_pos(boost::outbuf_garbage_buf<CharT>());
+        self->set_end(boost::outbuf_garbage_buf_end<CharT>());
+    }
+
+    void _grow(std::size_t min_free_space)
+    {
+        auto& str = static_cast<T*>(this)->_string();
+        std::size_t capacity = str.capacity();
+        std::size_t size = _committed + min_free_space;
+        if (size > capacity)
+        {
+            str.resize(_committed);
+            size = size > 2 * capacity ? size : 2 * capacity;
+        }
+        else
+        {
+            size = capacity;
+        }
+        boost::detail::string_resize_for_overwrite(str, size);
+        _set_window();
+    }
+
+    void _set_window()
+    {
+        auto* self = static_cast<T*>(this);
+        auto& str = self->_string();
+        if (str.capacity() > str.size())
+        {
+            boost::detail::string_resize_for_overwrite(str, str.capacity());
+        }
+        CharT* data = &str[0];
+        self->set_pos(data + _committed);
+        self->set_end(data + str.size());
+    }
+
+    std::size_t _committed = 0;
+};
+
+#if defined(__cpp_exceptions)
+
+template <typename T, typename CharT>
+class direct_string_writer_mixin<T, true, CharT>
+    : public direct_string_writer_mixin<T, false, CharT>
+{
+    using _base = direct_string_writer_mixin<T, false, CharT>;
+
+public:
+
+    direct_string_writer_mixin() = default;
+
+    void do_recycle() noexcept
+    {
+        try
+        {
+            _base::do_recycle();
+        }
+        catch(...)
+        {
+            _eptr = std::current_exception();
+        }
+    }
+
+    void do_reserve(std::size_t s, bool additional)
+    {
+        try
+        {
+            _base::do_reserve(s, additional);
+        }
+        catch(...)
+        {
+            _eptr = std::current_exception();
+        }
+    }
+
+    bool do_grow(std::size_t s) noexcept
+    {
+        try
+        {
+            return _base::do_grow(s);
+        }
+        catch(...)
+        {
+            _eptr = std::current_exception();
+        }
+        return false;
+    }
+
+    void do_finish()
+    {
+        _base::do_finish();
+        if (_eptr != nullptr)
+        {
+            std::rethrow_exception(_eptr);
+        }
+    }
+
+private:
+
+    std::exception_ptr _eptr = nullptr;
+};
+
+#else // defined(__cpp_exceptions)
+
+template <typename T, typename CharT>
+class direct_string_writer_mixin<T, true, CharT>
+    : public direct_string_writer_mixin<T, false, CharT>
+{
+};
+
+#endif // defined(__cpp_exceptions)
+
+template < bool NoExcept
+         , typename CharT
+         , typename Traits
+         , typename Allocator >
+class basic_direct_string_appender_impl
+    : public boost::detail::basic_outbuf_noexcept_switch<NoExcept, CharT>
+    , protected boost::detail::direct_string_writer_mixin
+        < basic_direct_string_appender_impl<NoExcept, CharT, Traits, Allocator>
+        , NoExcept
+        , CharT >
+{
+public:
+
+    using string_type = std::basic_string<CharT, Traits, Allocator>;
+
+    basic_direct_string_appender_impl(string_type& str_)
+        : boost::detail::basic_outbuf_noexcept_switch<NoExcept, CharT>
+            ( boost::outbuf_garbage_buf<CharT>()
+            , boost::outbuf_garbage_buf_end<CharT>() )
+        , _str(str_)
+    {
+        this->init_direct_writer();
+    }
+    basic_direct_string_appender_impl() = delete;
+    basic_direct_string_appender_impl(const basic_direct_string_appender_impl&) = delete;
+    basic_direct_string_appender_impl(basic_direct_string_appender_impl&&) = delete;
+
+    ~basic_direct_string_appender_impl()
+    {
+        if (this->good())
+        {
+            this->_trim();
+        }
+    }
+
+    void finish()
+    {
+        this->do_finish();
+    }
+
+private:
+
+    template <typename, bool, typename>
+    friend class detail::direct_string_writer_mixin;
+
+    string_type& _string()
+    {
+        return _str;
+    }
+    const string_type& _string() const
+    {
+        return _str;
+    }
+
+    string_type& _str;
+};
+
+template < bool NoExcept
+         , typename CharT
+         , typename Traits
+         , typename Allocator >
+class basic_direct_string_maker_impl
+    : public boost::detail::basic_outbuf_noexcept_switch<NoExcept, CharT>
+    , protected boost::detail::direct_string_writer_mixin
+        < basic_direct_string_maker_impl<NoExcept, CharT, Traits, Allocator>
+        , NoExcept
+        , CharT >
+{
+public:
+
+    using string_type = std::basic_string<CharT, Traits, Allocator>;
 
+    basic_direct_string_maker_impl()
+        : boost::detail::basic_outbuf_noexcept_switch<NoExcept, CharT>
+            ( boost::outbuf_garbage_buf<CharT>()
+            , boost::outbuf_garbage_buf_end<CharT>() )
+    {
+        this->init_direct_writer();
+    }
+
+    explicit basic_direct_string_maker_impl(const Allocator& alloc)
+        : boost::detail::basic_outbuf_noexcept_switch<NoExcept, CharT>
+            ( boost::outbuf_garbage_buf<CharT>()
+            , boost::outbuf_garbage_buf_end<CharT>() )
+        , _str(alloc)
+    {
+        this->init_direct_writer();
+    }
+
+    basic_direct_string_maker_impl(const basic_direct_string_maker_impl&) = delete;
+    basic_direct_string_maker_impl(basic_direct_string_maker_impl&&) = delete;
+    ~basic_direct_string_maker_impl() = default;
+
+    string_type finish()
+    {
+        this->do_finish();
+        return std::move(_str);
+    }
+
+private:
+
+    template <typename, bool, typename>
+    friend class detail::direct_string_writer_mixin;
+
+    string_type& _string()
+    {
+        return _str;
+    }
+    const string_type& _string() const
+    {
+        return _str;
+    }
+
+    string_type _str;
+};
 
 } // namespace detail
 
@@ -287,6 +721,13 @@ public:
     {
         this->do_reserve(s);
     }
+
+protected:
+
+    bool do_write_direct(const CharT* str, std::size_t len) noexcept override
+    {
+        return this->do_append_direct(str, len);
+    }
 };
 
 template < typename CharT
@@ -311,6 +752,13 @@ public:
     {
         this->do_reserve(s);
     }
+
+protected:
+
+    bool do_write_direct(const CharT* str, std::size_t len) override
+    {
+        return this->do_append_direct(str, len);
+    }
 };
 
 template < typename CharT
@@ -335,6 +783,13 @@ public:
     {
         this->do_reserve(s);
     }
+
+protected:
+
+    bool do_write_direct(const CharT* str, std::size_t len) noexcept override
+    {
+        return this->do_append_direct(str, len);
+    }
 };
 
 template < typename CharT
@@ -359,6 +814,157 @@ public:
     {
         this->do_reserve(s);
     }
+
+protected:
+
+    bool do_write_direct(const CharT* str, std::size_t len) override
+    {
+        return this->do_append_direct(str, len);
+    }
+};
+
+template < typename CharT
+         , typename Traits = std::char_traits<CharT>
+         , typename Allocator = std::allocator<CharT> >
+class basic_direct_string_appender_noexcept final
+    : public boost::detail::basic_direct_string_appender_impl
+        < true, CharT, Traits, Allocator >
+{
+public:
+
+    using boost::detail::basic_direct_string_appender_impl
+        < true, CharT, Traits, Allocator >
+        ::basic_direct_string_appender_impl;
+
+    void recycle() noexcept(true) override
+    {
+        this->do_recycle();
+    }
+
+    void reserve(std::size_t s)
+    {
+        this->do_reserve(s, true);
+    }
+
+    std::size_t max_contiguous() const noexcept override
+    {
+        return this->do_max_contiguous();
+    }
+
+protected:
+
+    bool do_reserve_contiguous(std::size_t s) noexcept override
+    {
+        return this->do_grow(s);
+    }
+};
+
+template < typename CharT
+         , typename Traits = std::char_traits<CharT>
+         , typename Allocator = std::allocator<CharT> >
+class basic_direct_string_appender final
+    : public boost::detail::basic_direct_string_appender_impl
+        < false, CharT, Traits, Allocator >
+{
+public:
+
+    using boost::detail::basic_direct_string_appender_impl
+        < false, CharT, Traits, Allocator >
+        ::basic_direct_string_appender_impl;
+
+    void recycle() override
+    {
+        this->do_recycle();
+    }
+
+    void reserve(std::size_t s)
+    {
+        this->do_reserve(s, true);
+    }
+
+    std::size_t max_contiguous() const noexcept override
+    {
+        return this->do_max_contiguous();
+    }
+
+protected:
+
+    bool do_reserve_contiguous(std::size_t s) override
+    {
+        return this->do_grow(s);
+    }
+};
+
+template < typename CharT
+         , typename Traits = std::char_traits<CharT>
+         , typename Allocator = std::allocator<CharT> >
+class basic_direct_string_maker_noexcept final
+    : public boost::detail::basic_direct_string_maker_impl
+        < true, CharT, Traits, Allocator >
+{
+public:
+
+    using boost::detail::basic_direct_string_maker_impl
+        < true, CharT, Traits, Allocator >
+        ::basic_direct_string_maker_impl;
+
+    void recycle() noexcept(true) override
+    {
+        this->do_recycle();
+    }
+
+    void reserve(std::size_t s)
+    {
+        this->do_reserve(s, false);
+    }
+
+    std::size_t max_contiguous() const noexcept override
+    {
+        return this->do_max_contiguous();
+    }
+
+protected:
+
+    bool do_reserve_contiguous(std::size_t s) noexcept override
+    {
+        return this->do_grow(s);
+    }
+};
+
+template < typename CharT
+         , typename Traits = std::char_traits<CharT>
+         , typename Allocator = std::allocator<CharT> >
+class basic_direct_string_maker final
+    : public boost::detail::basic_direct_string_maker_impl
+        < false, CharT, Traits, Allocator >
+{
+public:
+
+    using boost::detail::basic_direct_string_maker_impl
+        < false, CharT, Traits, Allocator >
+        ::basic_direct_string_maker_impl;
+
+    void recycle() override
+    {
+        this->do_recycle();
+    }
+
+    void reserve(std::size_t s)
+    {
+        this->do_reserve(s, false);
+    }
+
+    std::size_t max_contiguous() const noexcept override
+    {
+        return this->do_max_contiguous();
+    }
+
+protected:
+
+    bool do_reserve_contiguous(std::size_t s) override
+    {
+        return this->do_grow(s);
+    }
 };
 
 using string_appender = basic_string_appender<char>;
@@ -381,15 +987,116 @@ using u16string_maker_noexcept = basic_string_maker_noexcept<char16_t>;
 using u32string_maker_noexcept = basic_string_maker_noexcept<char32_t>;
 using wstring_maker_noexcept = basic_string_maker_noexcept<wchar_t>;
 
+using direct_string_appender = basic_direct_string_appender<char>;
+using direct_u16string_appender = basic_direct_string_appender<char16_t>;
+using direct_u32string_appender = basic_direct_string_appender<char32_t>;
+using direct_wstring_appender = basic_direct_string_appender<wchar_t>;
+
+using direct_string_maker = basic_direct_string_maker<char>;
+using direct_u16string_maker = basic_direct_string_maker<char16_t>;
+using direct_u32string_maker = basic_direct_string_maker<char32_t>;
+using direct_wstring_maker = basic_direct_string_maker<wchar_t>;
+
+using direct_string_appender_noexcept
+    = basic_direct_string_appender_noexcept<char>;
+using direct_u16string_appender_noexcept
+    = basic_direct_string_appender_noexcept<char16_t>;
+using direct_u32string_appender_noexcept
+    = basic_direct_string_appender_noexcept<char32_t>;
+using direct_wstring_appender_noexcept
+    = basic_direct_string_appender_noexcept<wchar_t>;
+
+using direct_string_maker_noexcept = basic_direct_string_maker_noexcept<char>;
+using direct_u16string_maker_noexcept
+    = basic_direct_string_maker_noexcept<char16_t>;
+using direct_u32string_maker_noexcept
+    = basic_direct_string_maker_noexcept<char32_t>;
+using direct_wstring_maker_noexcept
+    = basic_direct_string_maker_noexcept<wchar_t>;
+
+#if defined(__cpp_lib_memory_resource)
+
+template <typename CharT, typename Traits = std::char_traits<CharT> >
+using basic_pmr_string_appender = basic_string_appender
+    < CharT, Traits, std::pmr::polymorphic_allocator<CharT> >;
+
+template <typename CharT, typename Traits = std::char_traits<CharT> >
+using basic_pmr_string_maker = basic_string_maker
+    < CharT, Traits, std::pmr::polymorphic_allocator<CharT> >;
+
+template <typename CharT, typename Traits = std::char_traits<CharT> >
+using basic_pmr_string_appender_noexcept = basic_string_appender_noexcept
+    < CharT, Traits, std::pmr::polymorphic_allocator<CharT> >;
+
+template <typename CharT, typename Traits = std::char_traits<CharT> >
+using basic_pmr_string_maker_noexcept = basic_string_maker_noexcept
+    < CharT, Traits, std::pmr::polymorphic_allocator<CharT> >;
+
+template <typename CharT, typename Traits = std::char_traits<CharT> >
+using basic_pmr_direct_string_appender = basic_direct_string_appender
+    < CharT, Traits, std::pmr::polymorphic_allocator<CharT> >;
+
+template <typename CharT, typename Traits = std::char_traits<CharT> >
+using basic_pmr_direct_string_maker = basic_direct_string_maker
+    < CharT, Traits, std::pmr::polymorphic_allocator<CharT> >;
+
+template <typename CharT, typename Traits = std::char_traits<CharT> >
+using basic_pmr_direct_string_appender_noexcept
+    = basic_direct_string_appender_noexcept
+        < CharT, Traits, std::pmr::polymorphic_allocator<CharT> >;
+
+template <typename CharT, typename Traits = std::char_traits<CharT> >
+using basic_pmr_direct_string_maker_noexcept
+    = basic_direct_string_maker_noexcept
+        < CharT, Traits, std::pmr::polymorphic_allocator<CharT> >;
+
+using pmr_string_appender = basic_pmr_string_appender<char>;
+using pmr_string_maker = basic_pmr_string_maker<char>;
+using pmr_string_appender_noexcept = basic_pmr_string_appender_noexcept<char>;
+using pmr_string_maker_noexcept = basic_pmr_string_maker_noexcept<char>;
+
+using pmr_direct_string_appender = basic_pmr_direct_string_appender<char>;
+using pmr_direct_string_maker = basic_pmr_direct_string_maker<char>;
+using pmr_direct_string_appender_noexcept
+    = basic_pmr_direct_string_appender_noexcept<char>;
+using pmr_direct_string_maker_noexcept
+    = basic_pmr_direct_string_maker_noexcept<char>;
+
+#endif // defined(__cpp_lib_memory_resource)
+
 #if defined(__cpp_char8_t)
 
 using u8string_appender = basic_string_appender<char8_t>;
 using u8string_maker = basic_string_maker<char8_t>;
 using u8string_appender_noexcept = basic_string_appender_noexcept<char8_t>;
 using u8string_maker_noexcept = basic_string_maker_noexcept<char8_t>;
+using direct_u8string_appender = basic_direct_string_appender<char8_t>;
+using direct_u8string_maker = basic_direct_string_maker<char8_t>;
+using direct_u8string_appender_noexcept
+    = basic_direct_string_appender_noexcept<char8_t>;
+using direct_u8string_maker_noexcept
+    = basic_direct_string_maker_noexcept<char8_t>;
 
 #endif
 
+// Calls f twice: first to measure the content, and then to write it
+// into a string whose memory is allocated only once. The capacity has
+// min_size_after_recycle<CharT>() characters more than the content,
+// so that calls to require() near the end do not need to reallocate.
+// f must write the same content both times.
+template < typename CharT
+         , typename Traits = std::char_traits<CharT>
+         , typename Allocator = std::allocator<CharT>
+         , typename F >
+std::basic_string<CharT, Traits, Allocator> make_string_two_pass(F&& f)
+{
+    const std::size_t size = boost::measure_size<CharT>(f);
+    boost::basic_direct_string_maker<CharT, Traits, Allocator> sm;
+    sm.reserve(size + boost::min_size_after_recycle<CharT>());
+    f(static_cast<boost::basic_outbuf<CharT>&>(sm));
+    return sm.finish();
+}
+
 } // namespace boost
 
 #endif  // BOOST_OUTBUF_STRING_HPP
@@ -0,0 +1,546 @@
+#ifndef BOOST_OUTBUF_URING_HPP
+#define BOOST_OUTBUF_URING_HPP
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/outbuf.hpp>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define BOOST_OUTBUF_HAS_URING
+#endif
+#endif
+
+#if defined(BOOST_OUTBUF_HAS_URING)
+
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <linux/io_uring.h>
+
+namespace boost {
+
+template <typename CharT>
+constexpr std::size_t uring_file_writer_default_buffer_size()
+{
+    return (256 * 1024) / sizeof(CharT);
+}
+
+constexpr unsigned uring_file_writer_default_buffers_count = 4;
+
+namespace detail {
+
+// The minimum of liburing that uring_file_writer needs:
+// a submission and a completion queue mapped from the kernel.
+class uring_queue
+{
+public:
+
+    uring_queue() = default;
+    uring_queue(const uring_queue&) = delete;
+
+    ~uring_queue()
+    {
+        if (_ring_fd >= 0)
+        {
+            if (_sqes != nullptr)
+            {
+                ::munmap(_sqes, _sqes_size);
+            }
+            if (_cq_ptr != nullptr && _cq_ptr != _sq_ptr)
+            {
+                ::munmap(_cq_ptr, _cq_size);
+            }
+            if (_sq_ptr != nullptr)
+            {
+                ::munmap(_sq_ptr, _sq_size);
+            }
+            ::close(_ring_fd);
+        }
+    }
+
+    // Returns zero on success, or the error code otherwise
+    int init(unsigned entries) noexcept
+    {
+        ::io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        int fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+        if (fd < 0)
+        {
+            return errno;
+        }
+        _ring_fd = fd;
+        _sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        _cq_size = params.cq_off.cqes + params.cq_entries * sizeof(::io_uring_cqe);
+        bool single_mmap = false;
+#if defined(IORING_FEAT_SINGLE_MMAP)
+        if (params.features & IORING_FEAT_SINGLE_MMAP)
+        {
+            single_mmap = true;
+            _sq_size = _sq_size > _cq_size ? _sq_size : _cq_size;
+        }
+#endif
+        _sq_ptr = _mmap(_sq_size, IORING_OFF_SQ_RING);
+        if (_sq_ptr == nullptr)
+        {
+            return errno;
+        }
+        _cq_ptr = single_mmap ? _sq_ptr : _mmap(_cq_size, IORING_OFF_CQ_RING);
+        if (_cq_ptr == nullptr)
+        {
+            return errno;
+        }
+        _sqes_size = params.sq_entries * sizeof(::io_uring_sqe);
+        _sqes = static_cast<::io_uring_sqe*>(_mmap(_sqes_size, IORING_OFF_SQES));
+        if (_sqes == nullptr)
+        {
+            return errno;
+        }
+        char* sq = static_cast<char*>(_sq_ptr);
+        _sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        _sq_mask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        _sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        char* cq = static_cast<char*>(_cq_ptr);
+        _cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        _cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        _cq_mask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        _cqes = reinterpret_cast<::io_uring_cqe*>(cq + params.cq_off.cqes);
+        return 0;
+    }
+
+    // Returns zero on success, or the error code otherwise
+    int register_buffers(const ::iovec* iovs, unsigned count) noexcept
+    {
+        auto r = ::syscall( __NR_io_uring_register, _ring_fd
+                          , IORING_REGISTER_BUFFERS, iovs, count );
+        return r < 0 ? errno : 0;
+    }
+
+    // The caller shall not have more requests in flight
+    // than the number of entries passed to init()
+    ::io_uring_sqe* next_sqe() noexcept
+    {
+        unsigned tail = *_sq_tail;
+        unsigned index = tail & _sq_mask;
+        ::io_uring_sqe* sqe = &_sqes[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        _sq_array[index] = index;
+        return sqe;
+    }
+
+    // Submits the last to_submit entries returned by next_sqe(), and
+    // if wait is true, waits until at least one completion is available.
+    // Returns zero on success, or the error code otherwise. In the
+    // latter case, the entries that were not submitted are withdrawn.
+    int submit(unsigned to_submit, bool wait) noexcept
+    {
+        if (to_submit != 0)
+        {
+            __atomic_store_n(_sq_tail, *_sq_tail + to_submit, __ATOMIC_RELEASE);
+        }
+        const unsigned flags = wait ? IORING_ENTER_GETEVENTS : 0;
+        while (true)
+        {
+            auto r = ::syscall( __NR_io_uring_enter, _ring_fd, to_submit
+                              , wait ? 1u : 0u, flags, nullptr, 0 );
+            if (r < 0)
+            {
+                if (errno == EINTR)
+                {
+                    // Nothing was submitted
+                    continue;
+                }
+                const int err = errno;
+                __atomic_store_n(_sq_tail, *_sq_tail - to_submit, __ATOMIC_RELEASE);
+                return err;
+            }
+            if (r == 0 && to_submit != 0)
+            {
+                // The kernel did not find the entries. Should not happen
+                __atomic_store_n(_sq_tail, *_sq_tail - to_submit, __ATOMIC_RELEASE);
+                return EAGAIN;
+            }
+            // A partial submission is possible. Moreover, when some entries
+            // are submitted, the kernel returns their number even if the
+            // waiting was interrupted, or did not happen at all.
+            to_submit -= static_cast<unsigned>(r);
+            if (to_submit == 0 && ( ! wait || r == 0 || _completion_available()))
+            {
+                return 0;
+            }
+        }
+    }
+
+    // Calls f(user_data, res) for each available completion
+    template <typename F>
+    void reap(F f) noexcept
+    {
+        unsigned head = *_cq_head;
+        const unsigned tail = __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE);
+        for ( ; head != tail; ++head)
+        {
+            const ::io_uring_cqe& cqe = _cqes[head & _cq_mask];
+            f(cqe.user_data, cqe.res);
+        }
+        __atomic_store_n(_cq_head, head, __ATOMIC_RELEASE);
+    }
+
+private:
+
+    bool _completion_available() const noexcept
+    {
+        return *_cq_head != __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE);
+    }
+
+    void* _mmap(std::size_t size, unsigned long long offset) noexcept
+    {
+        void* p = ::mmap( nullptr, size, PROT_READ | PROT_WRITE
+                        , MAP_SHARED | MAP_POPULATE, _ring_fd
+                        , static_cast<::off_t>(offset) );
+        return p == MAP_FAILED ? nullptr : p;
+    }
+
+    int _ring_fd = -1;
+    void* _sq_ptr = nullptr;
+    void* _cq_ptr = nullptr;
+    std::size_t _sq_size = 0;
+    std::size_t _cq_size = 0;
+    std::size_t _sqes_size = 0;
+    ::io_uring_sqe* _sqes = nullptr;
+    unsigned* _sq_tail = nullptr;
+    unsigned* _sq_array = nullptr;
+    unsigned _sq_mask = 0;
+    unsigned* _cq_head = nullptr;
+    unsigned* _cq_tail = nullptr;
+    unsigned _cq_mask = 0;
+    ::io_uring_cqe* _cqes = nullptr;
+};
+
+} // namespace detail
+
+// Writes each full buffer asynchronously with io_uring, and continues
+// in the next free buffer. If io_uring is not available, the buffers
+// are written synchronously with ::pwrite.
+template <typename CharT>
+class basic_uring_file_writer final: public boost::basic_outbuf_noexcept<CharT>
+{
+public:
+
+    explicit basic_uring_file_writer
+        ( int fd
+        , std::size_t buf_size = boost::uring_file_writer_default_buffer_size<CharT>()
+        , unsigned buffers_count = boost::uring_file_writer_default_buffers_count )
+        : boost::basic_outbuf_noexcept<CharT>
+            ( boost::outbuf_garbage_buf<CharT>()
+            , boost::outbuf_garbage_buf_end<CharT>() )
+        , _fd(fd)
+    {
+        BOOST_ASSERT(fd >= 0);
+        if (buf_size < boost::min_size_after_recycle<CharT>())
+        {
+            buf_size = boost::min_size_after_recycle<CharT>();
+        }
+        if (buffers_count == 0)
+        {
+            buffers_count = 1;
+        }
+        _offset = ::lseek(fd, 0, SEEK_CUR);
+        if (_offset < 0)
+        {
+            _fail(errno);
+            return;
+        }
+        _buf_size = buf_size;
+        _bufs = new (std::nothrow) buffer[buffers_count];
+        _free = new (std::nothrow) unsigned[buffers_count];
+        _mem = new (std::nothrow) CharT[buf_size * buffers_count];
+        if (_bufs == nullptr || _free == nullptr || _mem == nullptr)
+        {
+            _fail(ENOMEM);
+            return;
+        }
+        _bufs_count = buffers_count;
+        for (unsigned i = 0; i < buffers_count; ++i)
+        {
+            _bufs[i].data = _mem + i * buf_size;
+        }
+        if (buffers_count > 1 && _queue.init(buffers_count) == 0)
+        {
+            _use_uring = true;
+            std::unique_ptr<::iovec[]> iovs(new (std::nothrow) ::iovec[buffers_count]);
+            if (iovs)
+            {
+                for (unsigned i = 0; i < buffers_count; ++i)
+                {
+                    iovs[i].iov_base = _bufs[i].data;
+                    iovs[i].iov_len = buf_size * sizeof(CharT);
+                }
+                _fixed = _queue.register_buffers(iovs.get(), buffers_count) == 0;
+            }
+            // The first buffer is the current one
+            for (unsigned i = buffers_count; i > 1; --i)
+            {
+                _free[_free_count++] = i - 1;
+            }
+        }
+        _current = 0;
+        this->set_pos(_bufs[0].data);
+        this->set_end(_bufs[0].data + buf_size);
+    }
+
+    basic_uring_file_writer() = delete;
+    basic_uring_file_writer(const basic_uring_file_writer&) = delete;
+    basic_uring_file_writer(basic_uring_file_writer&&) = delete;
+
+    // Blocks until the writes in flight complete, since they read the
+    // buffers. The content written since the last call to recycle() is
+    // discarded.
+    ~basic_uring_file_writer()
+    {
+        _drain();
+        delete [] _mem;
+        delete [] _free;
+        delete [] _bufs;
+    }
+
+    std::size_t buffer_size() const noexcept
+    {
+        return _buf_size;
+    }
+
+    unsigned buffers_count() const noexcept
+    {
+        return _bufs_count;
+    }
+
+    // Whether the writes are asynchronous
+    bool uses_io_uring() const noexcept
+    {
+        return _use_uring;
+    }
+
+    std::size_t max_contiguous() const noexcept override
+    {
+        return _buf_size;
+    }
+
+    void recycle() noexcept override
+    {
+        if (_bufs_count == 0)
+        {
+            this->set_pos(boost::outbuf_garbage_buf<CharT>());
+            return;
+        }
+        CharT* data = _bufs[_current].data;
+        if (this->good() && this->pos() != data)
+        {
+            _write_current();
+        }
+        this->set_pos(_bufs[_current].data);
+        this->set_end(_bufs[_current].data + _buf_size);
+    }
+
+    struct result
+    {
+        std::size_t count;
+        int errnum;
+        bool success;
+    };
+
+    result finish() noexcept
+    {
+        if (this->good() && _bufs_count != 0 && this->pos() != _bufs[_current].data)
+        {
+            _write_current();
+        }
+        _drain();
+        bool g = this->good();
+        if (g && ::lseek(_fd, _offset, SEEK_SET) < 0)
+        {
+            _fail(errno);
+            g = false;
+        }
+        this->set_good(false);
+        this->set_pos(boost::outbuf_garbage_buf<CharT>());
+        this->set_end(boost::outbuf_garbage_buf_end<CharT>());
+        return {_count, _errnum, g};
+    }
+
+private:
+
+    struct buffer
+    {
+        CharT* data = nullptr;
+        ::off_t offset = 0;
+        std::size_t len = 0; // in bytes
+    };
+
+    void _write_current() noexcept
+    {
+        buffer& buf = _bufs[_current];
+        const std::size_t len = (this->pos() - buf.data) * sizeof(CharT);
+        buf.offset = _offset;
+        buf.len = len;
+        _offset += static_cast<::off_t>(len);
+        if ( ! _use_uring)
+        {
+            _pwrite(buf.data, len, buf.offset);
+            return;
+        }
+        ::io_uring_sqe* sqe = _queue.next_sqe();
+        sqe->fd = _fd;
+        sqe->addr = reinterpret_cast<std::uintptr_t>(buf.data);
+        sqe->len = static_cast<unsigned>(len);
+        sqe->off = static_cast<unsigned long long>(buf.offset);
+        sqe->user_data = _current;
+        if (_fixed)
+        {
+            sqe->opcode = IORING_OP_WRITE_FIXED;
+            sqe->buf_index = static_cast<unsigned short>(_current);
+        }
+        else
+        {
+            sqe->opcode = IORING_OP_WRITE;
+        }
+        int err = _queue.submit(1, _free_count == 0);
+        if (err != 0)
+        {
+            // Not submitted. Keeps the same buffer
+            _fail(err);
+            return;
+        }
+        ++_in_flight;
+        _reap();
+        while (_free_count == 0)
+        {
+            err = _queue.submit(0, true);
+            if (err != 0)
+            {
+                _fail(err);
+                _drain();
+                break;
+            }
+            _reap();
+        }
+        if (_free_count != 0)
+        {
+            _current = _free[--_free_count];
+        }
+    }
+
+    void _reap() noexcept
+    {
+        _queue.reap([this](unsigned long long user_data, int res)
+        {
+            const auto index = static_cast<unsigned>(user_data);
+            buffer& buf = _bufs[index];
+            --_in_flight;
+            _free[_free_count++] = index;
+            if (res < 0)
+            {
+                _fail(-res);
+                return;
+            }
+            const auto written = static_cast<std::size_t>(res);
+            _count += written;
+            if (written < buf.len && this->good())
+            {
+                // A short write. The remainder is written synchronously
+                _pwrite( reinterpret_cast<const char*>(buf.data) + written
+                       , buf.len - written
+                       , buf.offset + static_cast<::off_t>(written) );
+            }
+        });
+    }
+
+    // Waits until there is no write in flight. The buffers can not be
+    // released while the kernel may still read them, so this does not
+    // give up even if io_uring_enter keeps failing. In that case, the
+    // completions are polled in the ring with a growing sleep in between.
+    void _drain() noexcept
+    {
+        long sleep_ns = 1000;
+        while (_in_flight != 0)
+        {
+            const int err = _queue.submit(0, true);
+            _reap();
+            if (err != 0 && _in_flight != 0)
+            {
+                _fail(err);
+                ::timespec ts = {0, sleep_ns};
+                ::nanosleep(&ts, nullptr);
+                if (sleep_ns < 1000000)
+                {
+                    sleep_ns *= 2;
+                }
+            }
+        }
+    }
+
+    void _pwrite(const void* data, std::size_t len, ::off_t offset) noexcept
+    {
+        auto it = static_cast<const char*>(data);
+        while (len != 0)
+        {
+            std::size_t chunk = len <= SSIZE_MAX ? len : SSIZE_MAX;
+            auto r = ::pwrite(_fd, it, chunk, offset);
+            if (r < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                _fail(errno);
+                return;
+            }
+            _count += r;
+            it += r;
+            len -= r;
+            offset += r;
+        }
+    }
+
+    // Keeps the first error
+    void _fail(int errnum) noexcept
+    {
+        if (_errnum == 0)
+        {
+            _errnum = errnum;
+        }
+        this->set_good(false);
+    }
+
+    boost::detail::uring_queue _queue;
+    int _fd;
+    int _errnum = 0;
+    bool _use_uring = false;
+    bool _fixed = false;
+    ::off_t _offset = 0;
+    std::size_t _count = 0;
+    std::size_t _buf_size = 0;
+    CharT* _mem = nullptr;
+    buffer* _bufs = nullptr;
+    unsigned* _free = nullptr; // stack of the indexes of the free buffers
+    unsigned _bufs_count = 0;
+    unsigned _current = 0;
+    unsigned _free_count = 0;
+    unsigned _in_flight = 0;
+};
+
+using uring_file_writer = basic_uring_file_writer<char>;
+
+} // namespace boost
+
+#endif // defined(BOOST_OUTBUF_HAS_URING)
+
+#endif  // BOOST_OUTBUF_URING_HPP
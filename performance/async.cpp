@@ -0,0 +1,117 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <boost/outbuf/async.hpp>
+#include <boost/outbuf/cfile.hpp>
+#include <boost/outbuf/integer.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+// Measures how long each record takes to be written by the producer,
+// through narrow_cfile_writer directly, and through an async_writer
+// that wraps it. The FILE is unbuffered, so that each recycle() of
+// narrow_cfile_writer issues a write(2) system call.
+
+constexpr std::size_t records_count = 1000000;
+
+using clock_type = std::chrono::steady_clock;
+
+void write_record(boost::outbuf& dest, std::size_t i)
+{
+    write(dest, "2020-01-01 12:34:56.789 [info] request ");
+    boost::write_uint(dest, i);
+    write(dest, " handled in ");
+    boost::write_uint(dest, i % 997);
+    write(dest, " us\n");
+}
+
+void report( const char* label, std::vector<double>& ns, double total_ms
+           , const std::string& note )
+{
+    std::sort(ns.begin(), ns.end());
+    auto percentile = [&](double p) {
+        return ns[static_cast<std::size_t>(p * static_cast<double>(ns.size() - 1))];
+    };
+    std::cout << std::setw(24) << std::left << label << std::right << std::fixed
+              << std::setprecision(0)
+              << std::setw(10) << percentile(0.5)
+              << std::setw(10) << percentile(0.999)
+              << std::setw(12) << ns.back()
+              << std::setw(12) << std::setprecision(1) << total_ms
+              << "  " << note << '\n';
+}
+
+template <typename Func>
+void bench(const char* label, Func func)
+{
+    std::FILE* file = std::tmpfile();
+    if (file == nullptr)
+    {
+        std::cerr << "could not create temporary file\n";
+        return;
+    }
+    std::setvbuf(file, nullptr, _IONBF, 0);
+    std::vector<double> ns(records_count);
+    auto t1 = clock_type::now();
+    std::string note = func(file, ns);
+    auto t2 = clock_type::now();
+    std::fclose(file);
+    report(label, ns, std::chrono::duration<double, std::milli>(t2 - t1).count(), note);
+}
+
+template <typename Outbuf>
+void write_records(Outbuf& dest, std::vector<double>& ns)
+{
+    for (std::size_t i = 0; i < records_count; ++i)
+    {
+        auto t1 = clock_type::now();
+        write_record(dest, i);
+        auto t2 = clock_type::now();
+        ns[i] = std::chrono::duration<double, std::nano>(t2 - t1).count();
+    }
+}
+
+int main()
+{
+    std::cout << std::setw(24) << std::left << "ns per record" << std::right
+              << std::setw(10) << "median" << std::setw(10) << "p99.9"
+              << std::setw(12) << "max" << std::setw(12) << "total ms" << '\n';
+
+    bench("narrow_cfile_writer", [](std::FILE* file, std::vector<double>& ns)
+    {
+        boost::narrow_cfile_writer<char> writer(file);
+        write_records(writer, ns);
+        writer.finish();
+        return std::string();
+    });
+    bench("async_writer", [](std::FILE* file, std::vector<double>& ns)
+    {
+        boost::narrow_cfile_writer<char> sink(file);
+        boost::async_writer writer(sink);
+        write_records(writer, ns);
+        writer.finish();
+        sink.finish();
+        return "stalls: " + std::to_string(writer.stalls());
+    });
+    bench("async_writer grow", [](std::FILE* file, std::vector<double>& ns)
+    {
+        boost::narrow_cfile_writer<char> sink(file);
+        boost::async_writer writer
+            ( sink, boost::async_writer_default_buffer_size<char>(), 4
+            , boost::async_writer_overflow::grow );
+        write_records(writer, ns);
+        writer.finish();
+        sink.finish();
+        return "stalls: " + std::to_string(writer.stalls())
+             + ", buffers: " + std::to_string(writer.buffers_count());
+    });
+    return 0;
+}
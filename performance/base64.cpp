@@ -3,11 +3,14 @@
 //  http://www.boost.org/LICENSE_1_0.txt)
 
 #include <boost/outbuf.hpp>
+#include <boost/outbuf/base64.hpp>
+#include <boost/outbuf/static.hpp>
 #include "char_array_streambuf.hpp"
 #include <chrono>
 #include <iostream>
 #include <iomanip>
 #include <cstring>
+#include <string>
 
 inline char base64_encode(std::uint8_t hextet)
 {
@@ -92,9 +95,12 @@ base64_result to_base64( char* dest
     return {dest, data};
 }
 
-void to_base64( boost::outbuf& dest
-              , const std::uint8_t* data
-              , const std::uint8_t* data_end )
+// Template on the destination type, so that it can
+// be instantiated on a static_outbuf as well as on boost::outbuf
+template <typename Outbuf>
+void to_base64_t( Outbuf& dest
+                , const std::uint8_t* data
+                , const std::uint8_t* data_end )
 {
     while(dest.good())
     {
@@ -126,11 +132,38 @@ void to_base64( std::streambuf& dest
 }
 
 
-int main()
+template <typename F>
+void bench(const char* label, std::size_t bytes_per_loop, F func)
 {
     constexpr std::size_t loop_size = 20000;
+    auto t1 = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < loop_size; ++i)
+    {
+        func();
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    std::chrono::duration<double> dt = t2 - t1;
+    std::cout << std::setw(36) << std::left << label
+              << std::setw(10) << std::right << std::fixed
+              << std::setprecision(2)
+              << (bytes_per_loop * loop_size) / dt.count() / 1e9 << '\n';
+}
+
+const char* kernel_name(boost::base64_kernel k)
+{
+    switch (k)
+    {
+        case boost::base64_kernel::ssse3:      return "ssse3";
+        case boost::base64_kernel::avx2:       return "avx2";
+        case boost::base64_kernel::avx512vbmi: return "avx512vbmi";
+        default:                               return "scalar";
+    }
+}
+
+int main()
+{
     constexpr std::size_t data_size = 100000;
-    std::uint8_t data[data_size];
+    static std::uint8_t data[data_size];
     std::uint8_t* const data_end = data + data_size;
     for(std::size_t i=0; i < data_size; ++i)
     {
@@ -138,42 +171,75 @@ int main()
     }
 
     constexpr std::size_t dest_size = (4 * (data_size + 3)) / 3;
-    char dest[dest_size];
+    static char dest[dest_size];
+    static std::uint8_t decoded[data_size + 1];
     char* const dest_end = dest + dest_size;
 
+    std::cout << std::setw(36) << std::left << "encoding ( input bytes )"
+              << std::setw(10) << std::right << "GB/s" << '\n';
+
+    bench("ternary chain to char array", data_size, [&]()
+    {
+        to_base64(dest, dest_end, data, data_end);
+    });
+    bench("ternary chain to cstr_writer", data_size, [&]()
     {
-        auto t1 = std::chrono::steady_clock::now();
-        for (std::size_t i = 0; i < loop_size; ++i)
+        boost::cstr_writer writer(dest);
+        to_base64_t<boost::outbuf>(writer, data, data_end);
+        writer.finish();
+    });
+    bench("ternary chain to static_outbuf_ref", data_size, [&]()
+    {
+        boost::cstr_writer writer(dest);
         {
-            to_base64(dest, dest_end, data, data_end);
+            boost::static_outbuf_ref<boost::cstr_writer> ref(writer);
+            to_base64_t(ref, data, data_end);
         }
-        auto t2 = std::chrono::steady_clock::now();
-        std::chrono::steady_clock::duration  dt = (t2 - t1);
-        std::cout << dt.count() << " , " << std::flush;
-    }
+        writer.finish();
+    });
+    bench("ternary chain to std::streambuf", data_size, [&]()
+    {
+        char_array_streambuf writer(dest, dest_size);
+        to_base64(writer, data, data_end);
+    });
 
+    const boost::base64_kernel kernels[] =
+        { boost::base64_kernel::scalar
+        , boost::base64_kernel::ssse3
+        , boost::base64_kernel::avx2
+        , boost::base64_kernel::avx512vbmi };
+
+    for (auto k: kernels)
     {
-        auto t1 = std::chrono::steady_clock::now();
-        for (std::size_t i = 0; i < loop_size; ++i)
+        if (boost::base64_kernel_supported(k))
         {
-            boost::cstr_writer writer(dest);
-            to_base64(writer, data, data_end);
-            writer.finish();
+            std::string label = std::string("base64_encode, ") + kernel_name(k);
+            bench(label.c_str(), data_size, [&]()
+            {
+                boost::cstr_writer writer(dest);
+                boost::base64_encode(writer, data, data_size, k);
+                writer.finish();
+            });
         }
-        auto t2 = std::chrono::steady_clock::now();
-        std::chrono::steady_clock::duration  dt = (t2 - t1);
-        std::cout << dt.count() << " , " << std::flush;
     }
 
+    boost::cstr_writer encoded_writer(dest);
+    boost::base64_encode(encoded_writer, data, data_size);
+    const std::size_t encoded_size = encoded_writer.finish().ptr - dest;
+
+    std::cout << '\n' << std::setw(36) << std::left << "decoding ( input characters )"
+              << std::setw(10) << std::right << "GB/s" << '\n';
+    for (auto k: kernels)
     {
-        auto t1 = std::chrono::steady_clock::now();
-        for (std::size_t i = 0; i < loop_size; ++i)
+        if (boost::base64_kernel_supported(k))
         {
-            char_array_streambuf writer(dest, dest_size);
-            to_base64(writer, data, data_end);
+            std::string label = std::string("base64_decode, ") + kernel_name(k);
+            bench(label.c_str(), encoded_size, [&]()
+            {
+                boost::basic_cstr_writer<std::uint8_t> writer(decoded);
+                boost::base64_decode(writer.as_underlying(), dest, encoded_size, k);
+                writer.finish();
+            });
         }
-        auto t2 = std::chrono::steady_clock::now();
-        std::chrono::steady_clock::duration  dt = (t2 - t1);
-        std::cout << dt.count() << " , " << std::flush; // '\n';
     }
 }
@@ -0,0 +1,70 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <boost/outbuf/cfile.hpp>
+#include <boost/outbuf/buffer_pool.hpp>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <iomanip>
+
+// Creates a narrow_cfile_writer for each small response, as done in
+// per-request serialization, with the buffer allocated by new[] and
+// taken from an outbuf_buffer_pool. The responses are written to a
+// FILE with a large buffer of its own, so that the writing is cheap.
+
+void write_response(boost::outbuf& dest)
+{
+    write(dest, "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\n\r\n");
+    write(dest, "{ \"name\" : \"blah blah blah\", \"value\" : \"bleh bleh\" }\n");
+}
+
+template <typename Func>
+void bench(const char* label, Func func)
+{
+    constexpr int loop_size = 1000000;
+    std::FILE* file = std::tmpfile();
+    std::setvbuf(file, nullptr, _IOFBF, 1 << 20);
+    auto t1 = std::chrono::steady_clock::now();
+    for (int i = 0; i < loop_size; ++i)
+    {
+        func(file);
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    std::fclose(file);
+    std::chrono::duration<double, std::nano> dt = t2 - t1;
+    std::cout << std::setw(32) << std::left << label << std::right
+              << std::setw(10) << std::fixed << std::setprecision(1)
+              << dt.count() / loop_size << '\n';
+}
+
+int main()
+{
+    std::cout << std::setw(32) << std::left << "buffer" << std::right
+              << std::setw(10) << "ns / response" << '\n';
+
+    for (std::size_t buf_size : {4 * 1024, 64 * 1024, 1024 * 1024})
+    {
+        std::cout << '\n' << buf_size / 1024 << " KiB buffer\n";
+        bench("new[]", [&](std::FILE* file)
+        {
+            boost::narrow_cfile_writer<char> writer(file, buf_size);
+            write_response(writer);
+            writer.finish();
+        });
+        boost::outbuf_buffer_pool pool;
+        bench("outbuf_buffer_pool", [&](std::FILE* file)
+        {
+            boost::narrow_cfile_writer<char> writer(file, pool, buf_size);
+            write_response(writer);
+            writer.finish();
+        });
+        auto stats = pool.statistics();
+        std::cout << "    thread cache hits: " << stats.thread_cache_hits
+                  << ", misses: " << stats.misses << '\n';
+    }
+    return 0;
+}
@@ -0,0 +1,224 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <boost/outbuf/cfile.hpp>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+#if defined(__GLIBC__)
+#include <unistd.h>
+#endif
+
+// Writes a 1 MiB log dump through narrow_cfile_writer with several
+// buffer sizes. The FILE is unbuffered, so that each fwrite issued
+// by recycle() becomes a write(2) system call. With glibc, the FILE
+// is opened with fopencookie over a temporary file, and the calls
+// to its write function are counted. The first row uses a 64 bytes
+// buffer, which is what narrow_cfile_writer used to have.
+//
+// Then it writes the same dump as wchar_t through a loop of
+// std::fputwc calls, which is what wide_cfile_writer used to do,
+// and through wide_cfile_writer, into an unoriented and a
+// wide-oriented FILE, where it calls fputws once per chunk, and
+// into a byte-oriented one, where it converts the content by itself.
+
+constexpr std::size_t dump_size = 1024 * 1024;
+constexpr int loop_size = 50;
+
+void write_log_dump(boost::outbuf& dest, const std::string& line)
+{
+    std::size_t count = 0;
+    while (count < dump_size)
+    {
+        write(dest, line.data(), line.size());
+        count += line.size();
+    }
+}
+
+#if defined(__GLIBC__)
+
+// The destination of the FILE returned by open_counting_file
+struct counting_sink
+{
+    std::FILE* file;
+    std::size_t write_calls;
+};
+
+ssize_t counting_sink_write(void* cookie, const char* data, std::size_t size)
+{
+    auto sink = static_cast<counting_sink*>(cookie);
+    ++sink->write_calls;
+    return ::write(fileno(sink->file), data, size);
+}
+
+int counting_sink_seek(void* cookie, off64_t* offset, int whence)
+{
+    auto sink = static_cast<counting_sink*>(cookie);
+    auto r = ::lseek64(fileno(sink->file), *offset, whence);
+    if (r < 0)
+    {
+        return -1;
+    }
+    *offset = r;
+    return 0;
+}
+
+std::FILE* open_counting_file(counting_sink& sink)
+{
+    sink.write_calls = 0;
+    sink.file = std::tmpfile();
+    if (sink.file == nullptr)
+    {
+        return nullptr;
+    }
+    cookie_io_functions_t funcs = {nullptr, counting_sink_write, counting_sink_seek, nullptr};
+    return ::fopencookie(&sink, "w", funcs);
+}
+
+#endif // defined(__GLIBC__)
+
+void bench(const char* label, std::size_t buf_size, const std::string& line)
+{
+#if defined(__GLIBC__)
+    counting_sink sink;
+    std::FILE* file = open_counting_file(sink);
+#else
+    std::FILE* file = std::tmpfile();
+#endif
+    if (file == nullptr)
+    {
+        std::cerr << "could not create temporary file\n";
+        return;
+    }
+    std::setvbuf(file, nullptr, _IONBF, 0);
+
+    std::size_t bytes = 0;
+    auto t1 = std::chrono::steady_clock::now();
+    for (int i = 0; i < loop_size; ++i)
+    {
+        std::rewind(file);
+        boost::narrow_cfile_writer<char> writer(file, buf_size);
+        write_log_dump(writer, line);
+        auto res = writer.finish();
+        bytes += res.count;
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    std::fclose(file);
+
+    std::chrono::duration<double> dt = t2 - t1;
+    std::cout << std::setw(20) << std::left << label
+              << std::setw(12) << std::right << buf_size;
+#if defined(__GLIBC__)
+    std::fclose(sink.file);
+    std::cout << std::setw(18) << sink.write_calls / loop_size;
+#else
+    std::cout << std::setw(18) << "n/a";
+#endif
+    std::cout << std::setw(14) << std::fixed << std::setprecision(1)
+              << (bytes / (1024.0 * 1024.0)) / dt.count()
+              << '\n';
+}
+
+template <typename WriteFunc>
+void bench_wide(const char* label, WriteFunc func)
+{
+    std::FILE* file = std::tmpfile();
+    if (file == nullptr)
+    {
+        std::cerr << "could not create temporary file\n";
+        return;
+    }
+    std::size_t chars = 0;
+    auto t1 = std::chrono::steady_clock::now();
+    for (int i = 0; i < loop_size; ++i)
+    {
+        std::rewind(file);
+        chars += func(file);
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    std::fclose(file);
+
+    std::chrono::duration<double> dt = t2 - t1;
+    std::cout << std::setw(32) << std::left << label
+              << std::setw(14) << std::right << std::fixed
+              << std::setprecision(1)
+              << (chars / (1024.0 * 1024.0)) / dt.count() << '\n';
+}
+
+int main()
+{
+    const std::string line
+        = "2020-01-01 12:34:56.789 [info] request handled in 42 us\n";
+
+    std::cout << std::setw(20) << std::left << "buffer"
+              << std::setw(12) << std::right << "size"
+              << std::setw(18) << "write per dump"
+              << std::setw(14) << "MB/s" << '\n';
+
+    bench("64 bytes (old)", 64, line);
+    bench("4 KiB", 4 * 1024, line);
+    bench("default", boost::narrow_cfile_writer_default_buffer_size<char>(), line);
+    bench("1 MiB", 1024 * 1024, line);
+
+    const std::wstring wline(line.begin(), line.end());
+    std::cout << '\n' << std::setw(32) << std::left << "wide writer"
+              << std::setw(14) << std::right << "Mchar/s" << '\n';
+
+    bench_wide("fputwc per character (old)", [&](std::FILE* file)
+    {
+        std::size_t count = 0;
+        while (count < dump_size)
+        {
+            for (wchar_t ch: wline)
+            {
+                std::fputwc(ch, file);
+            }
+            count += wline.size();
+        }
+        return count;
+    });
+    // The FILE is unoriented on the first iteration, then wide-oriented,
+    // since rewind() does not reset the orientation
+    bench_wide("wide_cfile_writer, unoriented", [&](std::FILE* file)
+    {
+        boost::wide_cfile_writer writer(file);
+        std::size_t count = 0;
+        while (count < dump_size)
+        {
+            write(writer, wline.data(), wline.size());
+            count += wline.size();
+        }
+        return writer.finish().count;
+    });
+    bench_wide("wide_cfile_writer, wide-oriented", [&](std::FILE* file)
+    {
+        std::fwide(file, 1);
+        boost::wide_cfile_writer writer(file);
+        std::size_t count = 0;
+        while (count < dump_size)
+        {
+            write(writer, wline.data(), wline.size());
+            count += wline.size();
+        }
+        return writer.finish().count;
+    });
+    bench_wide("wide_cfile_writer, byte-oriented", [&](std::FILE* file)
+    {
+        std::fwide(file, -1);
+        boost::wide_cfile_writer writer(file);
+        std::size_t count = 0;
+        while (count < dump_size)
+        {
+            write(writer, wline.data(), wline.size());
+            count += wline.size();
+        }
+        return writer.finish().count;
+    });
+    return 0;
+}
@@ -0,0 +1,166 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/outbuf/floating_point.hpp>
+#include <boost/outbuf/string.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__has_include)
+#if __has_include(<charconv>) && __cplusplus >= 201703L
+#include <charconv>
+#if defined(__cpp_lib_to_chars)
+#define HAS_FLOAT_TO_CHARS
+#endif
+#endif
+#endif
+
+// Writes a list of doubles separated by spaces, like a metrics export,
+// into a cstr_writer and into a string_maker, with write_double,
+// snprintf("%.17g"), std::to_chars and std::ostream.
+
+constexpr std::size_t values_count = 10000;
+char buff[values_count * 26];
+
+std::vector<double> create_values()
+{
+    std::vector<double> values;
+    for (std::size_t i = 0; i < values_count; ++i)
+    {
+        double mantissa = static_cast<double>(std::rand()) / RAND_MAX;
+        double scale = 1.0;
+        for (int e = std::rand() % 12; e > 0; --e)
+        {
+            scale *= 10.0;
+        }
+        values.push_back(i % 3 ? mantissa * scale : -mantissa / scale);
+    }
+    return values;
+}
+
+void write_values(boost::outbuf& dest, const std::vector<double>& values)
+{
+    for (double v: values)
+    {
+        boost::write_double(dest, v);
+        put(dest, ' ');
+    }
+}
+
+void write_values_snprintf(boost::outbuf& dest, const std::vector<double>& values)
+{
+    for (double v: values)
+    {
+        dest.require(26);
+        int n = std::snprintf(dest.pos(), 26, "%.17g ", v);
+        dest.advance(n);
+    }
+}
+
+void write_values_fixed(boost::outbuf& dest, const std::vector<double>& values)
+{
+    for (double v: values)
+    {
+        boost::write_double(dest, v, boost::float_notation::fixed, 3);
+        put(dest, ' ');
+    }
+}
+
+void write_values_snprintf_fixed(boost::outbuf& dest, const std::vector<double>& values)
+{
+    for (double v: values)
+    {
+        dest.require(26);
+        int n = std::snprintf(dest.pos(), 26, "%.3f ", v);
+        dest.advance(n);
+    }
+}
+
+#if defined(HAS_FLOAT_TO_CHARS)
+
+void write_values_to_chars(boost::outbuf& dest, const std::vector<double>& values)
+{
+    for (double v: values)
+    {
+        dest.require(26);
+        auto res = std::to_chars(dest.pos(), dest.end(), v);
+        *res.ptr = ' ';
+        dest.advance_to(res.ptr + 1);
+    }
+}
+
+#endif
+
+using write_values_func = void (*)(boost::outbuf&, const std::vector<double>&);
+
+template <typename F>
+double measure(F f)
+{
+    constexpr int loop_size = 200;
+    auto t1 = std::chrono::steady_clock::now();
+    for (int i = 0; i < loop_size; ++i)
+    {
+        f();
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    std::chrono::duration<double, std::nano> dt = t2 - t1;
+    return dt.count() / (loop_size * values_count);
+}
+
+void bench(const char* label, const std::vector<double>& values, write_values_func func)
+{
+    double ns_cstr = measure([&]{
+            boost::cstr_writer writer(buff);
+            func(writer, values);
+            writer.finish();
+        });
+    double ns_string = measure([&]{
+            boost::string_maker writer;
+            func(writer, values);
+            writer.finish();
+        });
+    std::cout << std::setw(24) << std::left << label
+              << std::setw(16) << std::right << std::fixed << std::setprecision(2)
+              << ns_cstr << std::setw(16) << ns_string << '\n';
+}
+
+void bench_ostream(const std::vector<double>& values)
+{
+    double ns = measure([&]{
+            std::ostringstream os;
+            os.precision(17);
+            for (double v: values)
+            {
+                os << v << ' ';
+            }
+            os.str();
+        });
+    std::cout << std::setw(24) << std::left << "std::ostringstream"
+              << std::setw(16) << std::right << "-"
+              << std::setw(16) << std::fixed << std::setprecision(2) << ns << '\n';
+}
+
+int main()
+{
+    auto values = create_values();
+    std::cout << std::setw(24) << std::left << "ns / value"
+              << std::setw(16) << std::right << "cstr_writer"
+              << std::setw(16) << "string_maker" << '\n';
+    bench("write_double", values, write_values);
+    bench("snprintf %.17g", values, write_values_snprintf);
+#if defined(HAS_FLOAT_TO_CHARS)
+    bench("std::to_chars", values, write_values_to_chars);
+#endif
+    bench_ostream(values);
+    bench("write_double fixed 3", values, write_values_fixed);
+    bench("snprintf %.3f", values, write_values_snprintf_fixed);
+    return 0;
+}
@@ -0,0 +1,111 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+// Requires C++20
+
+#include <boost/outbuf/format.hpp>
+#include <boost/outbuf/integer.hpp>
+#include <boost/outbuf/string.hpp>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+// Writes log-like records with write_formatted, with the equivalent
+// sequence of write calls, and with snprintf.
+
+struct record
+{
+    int id;
+    unsigned flags;
+    long long timestamp;
+    std::string name;
+};
+
+void write_records_formatted(boost::outbuf& dest, const std::vector<record>& records)
+{
+    for (const auto& r: records)
+    {
+        boost::write_formatted<"[{}] id={} flags=0x{:x} name=\"{}\"\n">
+            (dest, r.timestamp, r.id, r.flags, r.name);
+    }
+}
+
+void write_records_by_hand(boost::outbuf& dest, const std::vector<record>& records)
+{
+    for (const auto& r: records)
+    {
+        put(dest, '[');
+        boost::write_int(dest, r.timestamp);
+        write(dest, "] id=");
+        boost::write_int(dest, r.id);
+        write(dest, " flags=0x");
+        boost::write_hex(dest, r.flags);
+        write(dest, " name=\"");
+        write(dest, r.name.data(), r.name.size());
+        write(dest, "\"\n");
+    }
+}
+
+void write_records_snprintf(boost::outbuf& dest, const std::vector<record>& records)
+{
+    char buff[200];
+    for (const auto& r: records)
+    {
+        int n = std::snprintf( buff, sizeof(buff), "[%lld] id=%d flags=0x%x name=\"%s\"\n"
+                             , r.timestamp, r.id, r.flags, r.name.c_str() );
+        write(dest, buff, n);
+    }
+}
+
+using write_records_func = void (*)(boost::outbuf&, const std::vector<record>&);
+
+void bench(const char* label, const std::vector<record>& records, write_records_func func)
+{
+    constexpr int loop_size = 2000;
+    static char buff[1000000];
+    auto t1 = std::chrono::steady_clock::now();
+    for (int i = 0; i < loop_size; ++i)
+    {
+        boost::cstr_writer writer(buff);
+        func(writer, records);
+        writer.finish();
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    auto t3 = std::chrono::steady_clock::now();
+    for (int i = 0; i < loop_size; ++i)
+    {
+        boost::string_maker writer;
+        func(writer, records);
+        writer.finish();
+    }
+    auto t4 = std::chrono::steady_clock::now();
+
+    std::chrono::duration<double, std::nano> dt1 = t2 - t1;
+    std::chrono::duration<double, std::nano> dt2 = t4 - t3;
+    const double count = static_cast<double>(loop_size * records.size());
+    std::cout << std::setw(20) << std::left << label
+              << std::setw(16) << std::right << std::fixed << std::setprecision(2)
+              << dt1.count() / count << std::setw(16) << dt2.count() / count << '\n';
+}
+
+int main()
+{
+    std::vector<record> records;
+    for (int i = 0; i < 1000; ++i)
+    {
+        records.push_back
+            ( record{ i * 7919, static_cast<unsigned>(i * 2654435761u)
+                    , 1700000000000LL + i * 1234, "record " + std::to_string(i) } );
+    }
+    std::cout << std::setw(20) << std::left << "ns / record"
+              << std::setw(16) << std::right << "cstr_writer"
+              << std::setw(16) << "string_maker" << '\n';
+    bench("write_formatted", records, write_records_formatted);
+    bench("write chain", records, write_records_by_hand);
+    bench("snprintf", records, write_records_snprintf);
+    return 0;
+}
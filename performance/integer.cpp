@@ -0,0 +1,153 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/outbuf/integer.hpp>
+#include <boost/outbuf/string.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__has_include)
+#if __has_include(<charconv>) && __cplusplus >= 201703L
+#include <charconv>
+#define HAS_TO_CHARS
+#endif
+#endif
+
+// Writes a list of integers separated by spaces, into a cstr_writer
+// and into a string_maker, with write_int, snprintf, std::to_chars
+// and std::ostream.
+
+constexpr std::size_t values_count = 10000;
+char buff[values_count * 21];
+
+std::vector<long long> create_values(int max_digits)
+{
+    std::vector<long long> values;
+    for (std::size_t i = 0; i < values_count; ++i)
+    {
+        long long v = (static_cast<long long>(std::rand()) << 31) ^ std::rand();
+        long long mod = 1;
+        for (int d = 1 + std::rand() % max_digits; d > 0; --d)
+        {
+            mod *= 10;
+        }
+        v %= mod;
+        values.push_back(i % 2 ? v : -v);
+    }
+    return values;
+}
+
+void write_values(boost::outbuf& dest, const std::vector<long long>& values)
+{
+    for (long long v: values)
+    {
+        boost::write_int(dest, v);
+        put(dest, ' ');
+    }
+}
+
+void write_values_snprintf(boost::outbuf& dest, const std::vector<long long>& values)
+{
+    for (long long v: values)
+    {
+        dest.require(21);
+        int n = std::snprintf(dest.pos(), 21, "%lld ", v);
+        dest.advance(n);
+    }
+}
+
+#if defined(HAS_TO_CHARS)
+
+void write_values_to_chars(boost::outbuf& dest, const std::vector<long long>& values)
+{
+    for (long long v: values)
+    {
+        dest.require(21);
+        auto res = std::to_chars(dest.pos(), dest.end(), v);
+        *res.ptr = ' ';
+        dest.advance_to(res.ptr + 1);
+    }
+}
+
+#endif
+
+using write_values_func = void (*)(boost::outbuf&, const std::vector<long long>&);
+
+template <typename F>
+double measure(F f)
+{
+    constexpr int loop_size = 1000;
+    auto t1 = std::chrono::steady_clock::now();
+    for (int i = 0; i < loop_size; ++i)
+    {
+        f();
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    std::chrono::duration<double, std::nano> dt = t2 - t1;
+    return dt.count() / (loop_size * values_count);
+}
+
+void print(const char* label, double ns_cstr, double ns_string)
+{
+    std::cout << std::setw(20) << std::left << label
+              << std::setw(16) << std::right << std::fixed << std::setprecision(2)
+              << ns_cstr << std::setw(16) << ns_string << '\n';
+}
+
+void bench(const char* label, const std::vector<long long>& values, write_values_func func)
+{
+    double ns_cstr = measure([&]{
+            boost::cstr_writer writer(buff);
+            func(writer, values);
+            writer.finish();
+        });
+    double ns_string = measure([&]{
+            boost::string_maker writer;
+            func(writer, values);
+            writer.finish();
+        });
+    print(label, ns_cstr, ns_string);
+}
+
+void bench_ostream(const std::vector<long long>& values)
+{
+    double ns = measure([&]{
+            std::ostringstream os;
+            for (long long v: values)
+            {
+                os << v << ' ';
+            }
+            os.str();
+        });
+    std::cout << std::setw(20) << std::left << "std::ostringstream"
+              << std::setw(16) << std::right << "-"
+              << std::setw(16) << std::fixed << std::setprecision(2) << ns << '\n';
+}
+
+int main()
+{
+    const int max_digits[] = {3, 18};
+    for (int d: max_digits)
+    {
+        auto values = create_values(d);
+        std::cout << "up to " << d << " digits\n"
+                  << std::setw(20) << std::left << "ns / value"
+                  << std::setw(16) << std::right << "cstr_writer"
+                  << std::setw(16) << "string_maker" << '\n';
+        bench("write_int", values, write_values);
+        bench("snprintf", values, write_values_snprintf);
+#if defined(HAS_TO_CHARS)
+        bench("std::to_chars", values, write_values_to_chars);
+#endif
+        bench_ostream(values);
+        std::cout << std::endl;
+    }
+    return 0;
+}
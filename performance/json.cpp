@@ -5,6 +5,8 @@
 #include <boost/outbuf.hpp>
 #include <boost/outbuf/streambuf.hpp>
 #include <boost/outbuf/string.hpp>
+#include <boost/outbuf/json.hpp>
+#include <boost/outbuf/static.hpp>
 #include "char_array_streambuf.hpp"
 #include <chrono>
 #include <iostream>
@@ -27,12 +29,82 @@ struct element_abc
 };
 
 
-void to_json(boost::outbuf& dest, const element_abc& data)
+using write_value_func = void (*)(boost::outbuf&, const char*, std::size_t);
+
+void write_raw(boost::outbuf& dest, const char* str, std::size_t len)
+{
+    write(dest, str, len);
+}
+
+void write_escaped_naive(boost::outbuf& dest, const char* str, std::size_t len)
+{
+    for (std::size_t i = 0; i < len; ++i)
+    {
+        unsigned char ch = static_cast<unsigned char>(str[i]);
+        switch (ch)
+        {
+            case '"':  write(dest, "\\\""); break;
+            case '\\': write(dest, "\\\\"); break;
+            case '\n': write(dest, "\\n"); break;
+            case '\r': write(dest, "\\r"); break;
+            case '\t': write(dest, "\\t"); break;
+            case '\b': write(dest, "\\b"); break;
+            case '\f': write(dest, "\\f"); break;
+            default:
+                if (ch < 0x20)
+                {
+                    char buf[8];
+                    sprintf(buf, "\\u%04x", ch);
+                    write(dest, buf);
+                }
+                else
+                {
+                    put(dest, static_cast<char>(ch));
+                }
+        }
+    }
+}
+
+void write_escaped(boost::outbuf& dest, const char* str, std::size_t len)
+{
+    boost::write_json_escaped(dest, str, len);
+}
+
+void to_json( boost::outbuf& dest
+            , const element_abc& data
+            , write_value_func write_value = write_escaped )
+{
+    write(dest, "{\n  \"field_1\" : \"");
+    write_value(dest, data.field_1.data(), data.field_1.size());
+    write(dest, "\",\n  \"field_2\" : \"");
+    write_value(dest, data.field_2.data(), data.field_2.size());
+    write(dest, "\",\n  \"field_3\" : [\n");
+    for (auto it = data.field_3.begin(); it != data.field_3.end(); ++it) {
+        const auto& elm = *it;
+        write(dest, "    {\n      \"field_a\" : \"");
+        write_value(dest, elm.field_a.data(), elm.field_a.size());
+        write(dest, "\",\n      \"field_b\" : \"");
+        write_value(dest, elm.field_b.data(), elm.field_b.size());
+        write(dest, "\",\n      \"field_c\" : \"");
+        write_value(dest, elm.field_c.data(), elm.field_c.size());
+        if (it + 1 == data.field_3.end()) {
+            write(dest, "\"\n    }\n");
+        } else {
+            write(dest, "\"\n    },\n");
+        }
+    }
+    write(dest, "  ]\n}\n");
+}
+
+// Same as to_json with write_raw, but template on the destination type,
+// so that it can be instantiated on a static_outbuf
+template <typename Outbuf>
+void to_json_t(Outbuf& dest, const element_abc& data)
 {
     write(dest, "{\n  \"field_1\" : \"");
     write(dest, data.field_1.data(), data.field_1.size());
     write(dest, "\",\n  \"field_2\" : \"");
-    write(dest, data.field_2.data(), data.field_2.size());    
+    write(dest, data.field_2.data(), data.field_2.size());
     write(dest, "\",\n  \"field_3\" : [\n");
     for (auto it = data.field_3.begin(); it != data.field_3.end(); ++it) {
         const auto& elm = *it;
@@ -46,11 +118,61 @@ void to_json(boost::outbuf& dest, const element_abc& data)
             write(dest, "\"\n    }\n");
         } else {
             write(dest, "\"\n    },\n");
-        }        
+        }
     }
     write(dest, "  ]\n}\n");
 }
 
+// Same as to_json_t, but with the lengths of the literals known
+// at compile time, instead of calculated by strlen
+template <typename Outbuf>
+void to_json_lit_t(Outbuf& dest, const element_abc& data)
+{
+    write(dest, boost::lit("{\n  \"field_1\" : \""));
+    write(dest, data.field_1.data(), data.field_1.size());
+    write(dest, boost::lit("\",\n  \"field_2\" : \""));
+    write(dest, data.field_2.data(), data.field_2.size());
+    write(dest, boost::lit("\",\n  \"field_3\" : [\n"));
+    for (auto it = data.field_3.begin(); it != data.field_3.end(); ++it) {
+        const auto& elm = *it;
+        write(dest, boost::lit("    {\n      \"field_a\" : \""));
+        write(dest, elm.field_a.data(), elm.field_a.size());
+        write(dest, boost::lit("\",\n      \"field_b\" : \""));
+        write(dest, elm.field_b.data(), elm.field_b.size());
+        write(dest, boost::lit("\",\n      \"field_c\" : \""));
+        write(dest, elm.field_c.data(), elm.field_c.size());
+        if (it + 1 == data.field_3.end()) {
+            write(dest, boost::lit("\"\n    }\n"));
+        } else {
+            write(dest, boost::lit("\"\n    },\n"));
+        }
+    }
+    write(dest, boost::lit("  ]\n}\n"));
+}
+
+// Same as to_json_lit_t, but with each run of literals and
+// values written by a single write_all call
+template <typename Outbuf>
+void to_json_all_t(Outbuf& dest, const element_abc& data)
+{
+    using boost::lit;
+    write_all( dest, lit("{\n  \"field_1\" : \""), data.field_1
+             , lit("\",\n  \"field_2\" : \""), data.field_2
+             , lit("\",\n  \"field_3\" : [\n") );
+    for (auto it = data.field_3.begin(); it != data.field_3.end(); ++it) {
+        const auto& elm = *it;
+        write_all( dest, lit("    {\n      \"field_a\" : \""), elm.field_a
+                 , lit("\",\n      \"field_b\" : \""), elm.field_b
+                 , lit("\",\n      \"field_c\" : \""), elm.field_c );
+        if (it + 1 == data.field_3.end()) {
+            write(dest, lit("\"\n    }\n"));
+        } else {
+            write(dest, lit("\"\n    },\n"));
+        }
+    }
+    write(dest, lit("  ]\n}\n"));
+}
+
 inline void write(std::streambuf& dest, const char* str)
 {
     dest.sputn(str, strlen(str));
@@ -110,8 +232,62 @@ element_abc create_sample_data()
 }
 
 
+// Fields of about 1 KB of text, with a few characters to escape
+element_abc create_large_sample_data()
+{
+    std::string text;
+    while (text.size() < 1000)
+    {
+        text += "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do "
+                "eiusmod tempor incididunt ut labore et dolore magna aliqua.";
+        text += (text.size() % 3 == 0) ? "\n" : " \"quoted\" ";
+    }
+    element_abc data;
+    data.field_1 = text;
+    data.field_2 = text;
+    for (int i = 0; i < 5; ++i)
+    {
+        data.field_3.push_back(element_123{text, text, text});
+    }
+    return data;
+}
+
+void bench_escaping(const char* label, const element_abc& data, write_value_func func)
+{
+    constexpr int loop_size = 50000;
+    boost::string_maker sizer;
+    to_json(sizer, data, func);
+    const std::size_t size = sizer.finish().size();
+
+    auto t1 = std::chrono::steady_clock::now();
+    for (int i = 0; i < loop_size; ++i)
+    {
+        boost::string_maker writer;
+        to_json(writer, data, func);
+        writer.finish();
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    std::chrono::duration<double> dt = t2 - t1;
+    std::cout << std::setw(24) << std::left << label
+              << std::setw(12) << std::right << size
+              << std::setw(12) << std::fixed << std::setprecision(2)
+              << (static_cast<double>(size) * loop_size) / dt.count() / 1e9
+              << '\n';
+}
+
 int main()
 {
+    {
+        auto large = create_large_sample_data();
+        std::cout << std::setw(24) << std::left << "field values"
+                  << std::setw(12) << std::right << "bytes"
+                  << std::setw(12) << "GB/s" << '\n';
+        bench_escaping("raw", large, write_raw);
+        bench_escaping("naive escaping", large, write_escaped_naive);
+        bench_escaping("write_json_escaped", large, write_escaped);
+        std::cout << std::endl;
+    }
+
     auto data = create_sample_data();
     constexpr std::size_t buff_size = 1000;
     char buff[buff_size];
@@ -134,6 +310,113 @@ int main()
         std::chrono::steady_clock::duration  dt = (t2 - t1);
         std::cout << dt.count() << " , " << std::flush;
     }
+    {
+        // the same writer is reused
+        boost::cstr_writer writer(buff);
+        auto t1 = std::chrono::steady_clock::now();
+        for (long long i = 0; i < loop_size; ++i)
+        {
+            writer.reset(buff);
+            to_json(writer, data);
+            writer.finish();
+        }
+        auto t2 = std::chrono::steady_clock::now();
+
+        std::chrono::steady_clock::duration  dt = (t2 - t1);
+        std::cout << dt.count() << " , " << std::flush;
+    }
+    {
+        // to_json_t instantiated on boost::outbuf, hence with virtual recycle()
+        auto t1 = std::chrono::steady_clock::now();
+        for (long long i = 0; i < loop_size; ++i)
+        {
+            boost::cstr_writer writer(buff);
+            to_json_t<boost::outbuf>(writer, data);
+            writer.finish();
+        }
+        auto t2 = std::chrono::steady_clock::now();
+
+        std::chrono::steady_clock::duration  dt = (t2 - t1);
+        std::cout << dt.count() << " , " << std::flush;
+    }
+    {
+        // to_json_t instantiated on static_outbuf_ref, hence with
+        // cstr_writer::recycle() inlined
+        auto t1 = std::chrono::steady_clock::now();
+        for (long long i = 0; i < loop_size; ++i)
+        {
+            boost::cstr_writer writer(buff);
+            {
+                boost::static_outbuf_ref<boost::cstr_writer> ref(writer);
+                to_json_t(ref, data);
+            }
+            writer.finish();
+        }
+        auto t2 = std::chrono::steady_clock::now();
+
+        std::chrono::steady_clock::duration  dt = (t2 - t1);
+        std::cout << dt.count() << " , " << std::flush;
+    }
+    {
+        // same as above, but with the literals written through boost::lit
+        auto t1 = std::chrono::steady_clock::now();
+        for (long long i = 0; i < loop_size; ++i)
+        {
+            boost::cstr_writer writer(buff);
+            to_json_lit_t<boost::outbuf>(writer, data);
+            writer.finish();
+        }
+        auto t2 = std::chrono::steady_clock::now();
+
+        std::chrono::steady_clock::duration  dt = (t2 - t1);
+        std::cout << dt.count() << " , " << std::flush;
+    }
+    {
+        auto t1 = std::chrono::steady_clock::now();
+        for (long long i = 0; i < loop_size; ++i)
+        {
+            boost::cstr_writer writer(buff);
+            {
+                boost::static_outbuf_ref<boost::cstr_writer> ref(writer);
+                to_json_lit_t(ref, data);
+            }
+            writer.finish();
+        }
+        auto t2 = std::chrono::steady_clock::now();
+
+        std::chrono::steady_clock::duration  dt = (t2 - t1);
+        std::cout << dt.count() << " , " << std::flush;
+    }
+    {
+        // literals and values written through write_all
+        auto t1 = std::chrono::steady_clock::now();
+        for (long long i = 0; i < loop_size; ++i)
+        {
+            boost::cstr_writer writer(buff);
+            to_json_all_t<boost::outbuf>(writer, data);
+            writer.finish();
+        }
+        auto t2 = std::chrono::steady_clock::now();
+
+        std::chrono::steady_clock::duration  dt = (t2 - t1);
+        std::cout << dt.count() << " , " << std::flush;
+    }
+    {
+        auto t1 = std::chrono::steady_clock::now();
+        for (long long i = 0; i < loop_size; ++i)
+        {
+            boost::cstr_writer writer(buff);
+            {
+                boost::static_outbuf_ref<boost::cstr_writer> ref(writer);
+                to_json_all_t(ref, data);
+            }
+            writer.finish();
+        }
+        auto t2 = std::chrono::steady_clock::now();
+
+        std::chrono::steady_clock::duration  dt = (t2 - t1);
+        std::cout << dt.count() << " , " << std::flush;
+    }
 
 #else
     
@@ -0,0 +1,95 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+// Requires POSIX
+
+#include <boost/outbuf/mmap.hpp>
+#include <boost/outbuf/fd.hpp>
+#include <boost/outbuf/cfile.hpp>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+// Writes a 256 MiB export into a temporary file through
+// narrow_cfile_writer, fd_writer and mmap_file_writer. The time
+// includes finish(), but not the kernel's writeback of the pages,
+// unless the "+ fsync" rows are considered.
+
+constexpr std::size_t export_size = 256 * 1024 * 1024;
+constexpr int loop_size = 5;
+
+void write_export(boost::outbuf& dest, const std::string& line)
+{
+    std::size_t count = 0;
+    while (count < export_size)
+    {
+        write(dest, line.data(), line.size());
+        count += line.size();
+    }
+}
+
+template <typename Func>
+void bench(const char* label, bool sync, Func func)
+{
+    std::FILE* file = std::tmpfile();
+    if (file == nullptr)
+    {
+        std::cerr << "could not create temporary file\n";
+        return;
+    }
+    std::size_t bytes = 0;
+    auto t1 = std::chrono::steady_clock::now();
+    for (int i = 0; i < loop_size; ++i)
+    {
+        std::rewind(file);
+        ::ftruncate(fileno(file), 0);
+        bytes += func(file);
+        if (sync)
+        {
+            std::fflush(file);
+            ::fsync(fileno(file));
+        }
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    std::fclose(file);
+
+    std::chrono::duration<double> dt = t2 - t1;
+    std::cout << std::setw(28) << std::left << label
+              << std::setw(14) << std::right << std::fixed << std::setprecision(1)
+              << (bytes / (1024.0 * 1024.0)) / dt.count() << '\n';
+}
+
+int main()
+{
+    const std::string line
+        = "2020-01-01 12:34:56.789,42,request handled,200,1234.5678\n";
+
+    std::cout << std::setw(28) << std::left << "writer"
+              << std::setw(14) << std::right << "MB/s" << '\n';
+
+    for (bool sync: {false, true})
+    {
+        bench(sync ? "narrow_cfile_writer + fsync" : "narrow_cfile_writer", sync, [&](std::FILE* f)
+        {
+            boost::narrow_cfile_writer<char> writer(f);
+            write_export(writer, line);
+            return writer.finish().count;
+        });
+        bench(sync ? "fd_writer + fsync" : "fd_writer", sync, [&](std::FILE* f)
+        {
+            boost::fd_writer writer(fileno(f));
+            write_export(writer, line);
+            return writer.finish().count;
+        });
+        bench(sync ? "mmap_file_writer + fsync" : "mmap_file_writer", sync, [&](std::FILE* f)
+        {
+            boost::mmap_file_writer writer(fileno(f));
+            write_export(writer, line);
+            return writer.finish().count;
+        });
+    }
+    return 0;
+}
@@ -0,0 +1,154 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <boost/outbuf.hpp>
+#include <boost/outbuf/cfile.hpp>
+#include <boost/outbuf/integer.hpp>
+#include <boost/outbuf/streambuf.hpp>
+#include <boost/outbuf/string.hpp>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <iomanip>
+#include <streambuf>
+#include <string>
+
+// Writes many short messages, constructing a new writer for each one,
+// and reusing the same writer through reset().
+
+constexpr long long loop_size = 10000000;
+
+void write_message(boost::outbuf& dest, long long i)
+{
+    write(dest, "{ \"id\" : ");
+    boost::write_int(dest, i);
+    write(dest, ", \"status\" : \"ok\" }\n");
+}
+
+// Discards everything
+class null_streambuf: public std::streambuf
+{
+protected:
+
+    std::streamsize xsputn(const char*, std::streamsize n) override
+    {
+        return n;
+    }
+    int_type overflow(int_type ch) override
+    {
+        return traits_type::not_eof(ch);
+    }
+};
+
+template <typename Func>
+void bench(const char* label, Func func)
+{
+    auto t1 = std::chrono::steady_clock::now();
+    func();
+    auto t2 = std::chrono::steady_clock::now();
+    std::chrono::duration<double, std::nano> dt = t2 - t1;
+    std::cout << std::setw(36) << std::left << label << std::right
+              << std::setw(10) << std::fixed << std::setprecision(1)
+              << dt.count() / loop_size << '\n';
+}
+
+int main()
+{
+    std::cout << std::setw(36) << std::left << "writer" << std::right
+              << std::setw(10) << "ns / message" << '\n';
+
+    char buff[200];
+    bench("cstr_writer constructed", [&]
+    {
+        for (long long i = 0; i < loop_size; ++i)
+        {
+            boost::cstr_writer writer(buff);
+            write_message(writer, i);
+            writer.finish();
+        }
+    });
+    bench("cstr_writer reset", [&]
+    {
+        boost::cstr_writer writer(buff);
+        for (long long i = 0; i < loop_size; ++i)
+        {
+            writer.reset(buff);
+            write_message(writer, i);
+            writer.finish();
+        }
+    });
+
+    std::size_t total = 0;
+    bench("string_maker constructed", [&]
+    {
+        for (long long i = 0; i < loop_size; ++i)
+        {
+            boost::string_maker writer;
+            write_message(writer, i);
+            total += writer.finish().size();
+        }
+    });
+    bench("string_maker reset", [&]
+    {
+        boost::string_maker writer;
+        std::string str;
+        for (long long i = 0; i < loop_size; ++i)
+        {
+            writer.reset();
+            write_message(writer, i);
+            writer.finish(str);
+            total += str.size();
+        }
+    });
+
+    std::FILE* file = std::tmpfile();
+    std::setvbuf(file, nullptr, _IOFBF, 1 << 20);
+    bench("narrow_cfile_writer constructed", [&]
+    {
+        for (long long i = 0; i < loop_size; ++i)
+        {
+            boost::narrow_cfile_writer<char> writer(file, 4096);
+            write_message(writer, i);
+            writer.finish();
+        }
+    });
+    std::rewind(file);
+    bench("narrow_cfile_writer reset", [&]
+    {
+        boost::narrow_cfile_writer<char> writer(file, 4096);
+        for (long long i = 0; i < loop_size; ++i)
+        {
+            writer.reset();
+            write_message(writer, i);
+            writer.finish();
+        }
+    });
+    std::fclose(file);
+
+    null_streambuf sb;
+    bench("streambuf_writer constructed", [&]
+    {
+        for (long long i = 0; i < loop_size; ++i)
+        {
+            boost::streambuf_writer writer(sb);
+            write_message(writer, i);
+            writer.finish();
+        }
+    });
+    bench("streambuf_writer reset", [&]
+    {
+        boost::streambuf_writer writer(sb);
+        for (long long i = 0; i < loop_size; ++i)
+        {
+            writer.reset();
+            write_message(writer, i);
+            writer.finish();
+        }
+    });
+
+    std::cout << (total != 0 ? "" : " ") << std::flush;
+    return 0;
+}
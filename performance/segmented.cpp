@@ -0,0 +1,77 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/outbuf/segmented.hpp>
+#include <boost/outbuf/string.hpp>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+// Builds large JSON responses with string_maker, whose string is
+// reallocated and copied as it grows, and with segmented_writer,
+// that only appends segments. "memory" is the capacity of the
+// string, or the total size of the segments.
+
+void write_response(boost::outbuf& dest, int records)
+{
+    write(dest, "{\n  \"items\" : [\n");
+    for (int i = 0; i < records; ++i)
+    {
+        write(dest, "    { \"name\" : \"blah blah blah\", \"value\" : \"bleh bleh\" },\n");
+    }
+    write(dest, "  ]\n}\n");
+}
+
+template <typename Func>
+void bench(const char* label, int records, int loop_size, Func func)
+{
+    std::size_t memory = 0;
+    auto t1 = std::chrono::steady_clock::now();
+    for (int i = 0; i < loop_size; ++i)
+    {
+        memory = func(records);
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    std::chrono::duration<double, std::micro> dt = t2 - t1;
+    std::cout << std::setw(30) << std::left << label
+              << std::setw(12) << std::right << memory
+              << std::setw(14) << std::fixed << std::setprecision(1)
+              << dt.count() / loop_size << '\n';
+}
+
+int main()
+{
+    std::cout << std::setw(30) << std::left << "writer"
+              << std::setw(12) << std::right << "memory"
+              << std::setw(14) << "us / response" << '\n';
+
+    const int sizes[] = {1000, 20000, 300000};
+    for (int records : sizes)
+    {
+        const int loop_size = 20000000 / (records * 60) + 1;
+        std::cout << "\nresponse of " << records * 60 / 1000 << " KB\n";
+        bench("string_maker", records, loop_size, [](int r)
+        {
+            boost::string_maker maker;
+            write_response(maker, r);
+            return maker.finish().capacity();
+        });
+        bench("segmented_writer", records, loop_size, [](int r)
+        {
+            boost::segmented_writer writer;
+            write_response(writer, r);
+            writer.finish();
+            return writer.segments_count() * writer.segment_size();
+        });
+        bench("segmented_writer + to_string", records, loop_size, [](int r)
+        {
+            boost::segmented_writer writer;
+            write_response(writer, r);
+            writer.finish();
+            return writer.to_string().capacity();
+        });
+    }
+    return 0;
+}
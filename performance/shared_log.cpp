@@ -0,0 +1,127 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <boost/outbuf/shared_log.hpp>
+#include <boost/outbuf/cfile.hpp>
+#include <boost/outbuf/integer.hpp>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <iomanip>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Many threads write log records into the same file. The baseline
+// locks a mutex around a shared narrow_cfile_writer for each record,
+// while with shared_log_sink each thread builds its records in its
+// own shared_log_writer, and a single thread writes them into a
+// narrow_cfile_writer.
+
+constexpr std::size_t records_count = 2000000;
+
+using clock_type = std::chrono::steady_clock;
+
+template <typename Outbuf>
+void write_record(Outbuf& dest, unsigned thread_id, std::size_t i)
+{
+    write(dest, "2020-01-01 12:34:56.789 [info] thread ");
+    boost::write_uint(dest, thread_id);
+    write(dest, " request ");
+    boost::write_uint(dest, i);
+    write(dest, " handled in ");
+    boost::write_uint(dest, i % 997);
+    write(dest, " us\n");
+}
+
+template <typename Func>
+double bench(unsigned threads_count, Func func)
+{
+    std::FILE* file = std::tmpfile();
+    if (file == nullptr)
+    {
+        std::cerr << "could not create temporary file\n";
+        return 0;
+    }
+    auto t1 = clock_type::now();
+    func(file, threads_count);
+    auto t2 = clock_type::now();
+    std::fclose(file);
+    return std::chrono::duration<double, std::milli>(t2 - t1).count();
+}
+
+template <typename Func>
+void run_threads(unsigned threads_count, Func func)
+{
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < threads_count; ++t)
+    {
+        threads.emplace_back(func, t);
+    }
+    for (auto& th : threads)
+    {
+        th.join();
+    }
+}
+
+void mutex_and_cfile_writer(std::FILE* file, unsigned threads_count)
+{
+    boost::narrow_cfile_writer<char> writer(file);
+    std::mutex mtx;
+    const std::size_t n = records_count / threads_count;
+    run_threads(threads_count, [&](unsigned t)
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            write_record(writer, t, i);
+        }
+    });
+    writer.finish();
+}
+
+std::size_t full_waits = 0;
+
+void shared_log(std::FILE* file, unsigned threads_count)
+{
+    boost::narrow_cfile_writer<char> dest(file);
+    boost::shared_log_sink sink(dest);
+    const std::size_t n = records_count / threads_count;
+    run_threads(threads_count, [&](unsigned t)
+    {
+        boost::shared_log_writer writer(sink);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            write_record(writer, t, i);
+            writer.commit();
+        }
+    });
+    sink.finish();
+    dest.finish();
+    full_waits = sink.full_waits();
+}
+
+int main()
+{
+    std::cout << "hardware threads: " << std::thread::hardware_concurrency()
+              << ", records: " << records_count << "\n\n"
+              << std::setw(8) << "threads"
+              << std::setw(16) << "mutex (ms)"
+              << std::setw(16) << "shared_log (ms)"
+              << std::setw(14) << "full waits" << '\n';
+    for (unsigned threads_count = 1; threads_count <= 64; threads_count *= 2)
+    {
+        double t1 = bench(threads_count, mutex_and_cfile_writer);
+        double t2 = bench(threads_count, shared_log);
+        std::cout << std::fixed << std::setprecision(1)
+                  << std::setw(8) << threads_count
+                  << std::setw(16) << t1
+                  << std::setw(16) << t2
+                  << std::setw(14) << full_waits << '\n';
+    }
+    return 0;
+}
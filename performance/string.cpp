@@ -0,0 +1,57 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/outbuf/string.hpp>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+// Builds JSON responses of about 30 KB with basic_string_maker, that
+// stages the content in a small buffer and appends it to the string,
+// and with basic_direct_string_maker, that writes it straight into
+// the string's capacity.
+
+void write_response(boost::outbuf& dest, int records)
+{
+    write(dest, "{\n  \"items\" : [\n");
+    for (int i = 0; i < records; ++i)
+    {
+        write(dest, "    { \"name\" : \"blah blah blah\", \"value\" : \"bleh bleh\" },\n");
+    }
+    write(dest, "  ]\n}\n");
+}
+
+template <typename StringMaker>
+void bench(const char* label, int records)
+{
+    constexpr int loop_size = 20000;
+    std::size_t total = 0;
+    auto t1 = std::chrono::steady_clock::now();
+    for (int i = 0; i < loop_size; ++i)
+    {
+        StringMaker maker;
+        write_response(maker, records);
+        total += maker.finish().size();
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    std::chrono::duration<double, std::micro> dt = t2 - t1;
+    std::cout << std::setw(28) << std::left << label
+              << std::setw(10) << std::right << total / loop_size
+              << std::setw(14) << std::fixed << std::setprecision(2)
+              << dt.count() / loop_size << '\n';
+}
+
+int main()
+{
+    std::cout << std::setw(28) << std::left << "writer"
+              << std::setw(10) << std::right << "bytes"
+              << std::setw(14) << "us / response" << '\n';
+
+    bench<boost::string_maker>("string_maker", 500);
+    bench<boost::direct_string_maker>("direct_string_maker", 500);
+    bench<boost::string_maker_noexcept>("string_maker_noexcept", 500);
+    bench<boost::direct_string_maker_noexcept>("direct_string_maker_noexcept", 500);
+    return 0;
+}
@@ -0,0 +1,112 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+// Requires Linux
+
+#include <boost/outbuf/uring.hpp>
+#include <boost/outbuf/fd.hpp>
+#include <boost/outbuf/cfile.hpp>
+#include <boost/outbuf/integer.hpp>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <iomanip>
+
+// Writes a 256 MiB CSV export of integers into a temporary file with
+// narrow_cfile_writer, fd_writer and uring_file_writer. With the latter,
+// the formatting overlaps with the writes. The "+ fsync" rows include
+// the time for the content to reach the storage device.
+
+constexpr std::size_t export_size = 256 * 1024 * 1024;
+constexpr int loop_size = 5;
+
+void write_export(boost::outbuf& dest)
+{
+    std::size_t count = 0;
+    unsigned long long x = 88172645463325252ULL;
+    while (count < export_size)
+    {
+        for (int i = 0; i < 1000; ++i)
+        {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+            boost::write_uint(dest, x >> 20);
+            put(dest, ',');
+            boost::write_uint(dest, x & 0xFFFF);
+            put(dest, '\n');
+        }
+        count += 1000 * 22;
+    }
+}
+
+template <typename Func>
+void bench(const char* label, bool sync, Func func)
+{
+    std::FILE* file = std::tmpfile();
+    if (file == nullptr)
+    {
+        std::cerr << "could not create temporary file\n";
+        return;
+    }
+    std::size_t bytes = 0;
+    auto t1 = std::chrono::steady_clock::now();
+    for (int i = 0; i < loop_size; ++i)
+    {
+        std::rewind(file);
+        ::ftruncate(fileno(file), 0);
+        bytes += func(file);
+        if (sync)
+        {
+            std::fflush(file);
+            ::fsync(fileno(file));
+        }
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    std::fclose(file);
+
+    std::chrono::duration<double> dt = t2 - t1;
+    std::cout << std::setw(40) << std::left << label
+              << std::setw(14) << std::right << std::fixed << std::setprecision(1)
+              << (bytes / (1024.0 * 1024.0)) / dt.count() << '\n';
+}
+
+int main()
+{
+    std::cout << std::setw(40) << std::left << "writer"
+              << std::setw(14) << std::right << "MB/s" << '\n';
+
+    for (bool sync: {false, true})
+    {
+        bench(sync ? "narrow_cfile_writer + fsync" : "narrow_cfile_writer", sync, [](std::FILE* f)
+        {
+            boost::narrow_cfile_writer<char> writer(f);
+            write_export(writer);
+            return writer.finish().count;
+        });
+        bench(sync ? "fd_writer + fsync" : "fd_writer", sync, [](std::FILE* f)
+        {
+            boost::fd_writer writer(fileno(f));
+            write_export(writer);
+            return writer.finish().count;
+        });
+        bench(sync ? "uring_file_writer + fsync" : "uring_file_writer", sync, [](std::FILE* f)
+        {
+            boost::uring_file_writer writer(fileno(f));
+            if ( ! writer.uses_io_uring())
+            {
+                std::cerr << "io_uring is not available\n";
+            }
+            write_export(writer);
+            return writer.finish().count;
+        });
+        bench(sync ? "uring_file_writer 1 MiB x 8 + fsync" : "uring_file_writer 1 MiB x 8", sync, [](std::FILE* f)
+        {
+            boost::uring_file_writer writer(fileno(f), 1024 * 1024, 8);
+            write_export(writer);
+            return writer.finish().count;
+        });
+    }
+    return 0;
+}
@@ -0,0 +1,162 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <boost/outbuf/cfile.hpp>
+#include <boost/outbuf/streambuf.hpp>
+#include <boost/outbuf/string.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <iomanip>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+// Writes blocks of several sizes. "staged" writes through as_underlying(),
+// which has no write_direct, so the blocks are copied through the buffer
+// of the writer, recycle() being called each time it gets full.
+// "direct" is the normal write function, that calls write_direct.
+
+// Copies everything into a ring of 64 KiB, like a socket buffer would
+class ring_streambuf: public std::streambuf
+{
+protected:
+
+    std::streamsize xsputn(const char* s, std::streamsize n) override
+    {
+        for (std::streamsize count = n; count != 0; )
+        {
+            std::size_t chunk = _ring.size() - _pos;
+            if (chunk > static_cast<std::size_t>(count))
+            {
+                chunk = static_cast<std::size_t>(count);
+            }
+            std::memcpy(&_ring[_pos], s, chunk);
+            _pos = (_pos + chunk) % _ring.size();
+            s += chunk;
+            count -= chunk;
+        }
+        return n;
+    }
+    int_type overflow(int_type ch) override
+    {
+        _ring[_pos] = static_cast<char>(ch);
+        _pos = (_pos + 1) % _ring.size();
+        return traits_type::not_eof(ch);
+    }
+
+private:
+
+    std::vector<char> _ring = std::vector<char>(64 * 1024);
+    std::size_t _pos = 0;
+};
+
+void write_staged(boost::outbuf& dest, const char* str, std::size_t len)
+{
+    write( dest.as_underlying()
+         , reinterpret_cast<const std::uint8_t*>(str)
+         , len );
+}
+
+void write_direct(boost::outbuf& dest, const char* str, std::size_t len)
+{
+    write(dest, str, len);
+}
+
+using write_func = void (*)(boost::outbuf&, const char*, std::size_t);
+
+template <typename MakeWriter>
+void bench( const char* label
+          , const std::string& payload
+          , write_func func
+          , MakeWriter make_writer )
+{
+    const std::size_t total = 64 * 1024 * 1024;
+    const std::size_t loop_size = total / payload.size();
+    auto t1 = std::chrono::steady_clock::now();
+    make_writer([&](boost::outbuf& dest)
+    {
+        for (std::size_t i = 0; i < loop_size; ++i)
+        {
+            func(dest, payload.data(), payload.size());
+        }
+    });
+    auto t2 = std::chrono::steady_clock::now();
+    std::chrono::duration<double> dt = t2 - t1;
+    std::cout << std::setw(36) << std::left << label << std::right
+              << std::setw(10) << std::fixed << std::setprecision(2)
+              << (static_cast<double>(payload.size()) * loop_size) / dt.count() / 1e9
+              << '\n';
+}
+
+int main()
+{
+    // the file is rewound after each measure, so that it does not grow
+    std::FILE* file = std::tmpfile();
+    ring_streambuf sb;
+
+    for (std::size_t size : { 64, 1024, 64 * 1024, 1024 * 1024, 10 * 1024 * 1024 })
+    {
+        const std::string payload(size, 'x');
+        std::cout << '\n' << std::setw(36) << std::left
+                  << ("payload of " + std::to_string(size) + " bytes")
+                  << std::setw(10) << std::right << "GB/s" << '\n';
+
+        for (auto func : { write_staged, write_direct })
+        {
+            const char* mode = func == write_staged ? "staged" : "direct";
+            bench( ("narrow_cfile_writer(64), " + std::string(mode)).c_str()
+                 , payload, func, [&](std::function<void(boost::outbuf&)> f)
+                 {
+                     boost::narrow_cfile_writer<char> writer(file, 64);
+                     f(writer);
+                     writer.finish();
+                     std::rewind(file);
+                 } );
+            bench( ("narrow_cfile_writer(64K), " + std::string(mode)).c_str()
+                 , payload, func, [&](std::function<void(boost::outbuf&)> f)
+                 {
+                     boost::narrow_cfile_writer<char> writer(file);
+                     f(writer);
+                     writer.finish();
+                     std::rewind(file);
+                 } );
+            bench( ("streambuf_writer, " + std::string(mode)).c_str()
+                 , payload, func, [&](std::function<void(boost::outbuf&)> f)
+                 {
+                     boost::streambuf_writer writer(sb);
+                     f(writer);
+                     writer.finish();
+                 } );
+        }
+    }
+
+    // The string writers are measured with less content, since it is all kept
+    for (std::size_t size : { 1024, 64 * 1024, 1024 * 1024 })
+    {
+        const std::string payload(size, 'x');
+        std::cout << '\n' << std::setw(36) << std::left
+                  << ("payload of " + std::to_string(size) + " bytes")
+                  << std::setw(10) << std::right << "GB/s" << '\n';
+        for (auto func : { write_staged, write_direct })
+        {
+            const char* mode = func == write_staged ? "staged" : "direct";
+            bench( ("string_maker, " + std::string(mode)).c_str()
+                 , payload, func, [&](std::function<void(boost::outbuf&)> f)
+                 {
+                     boost::string_maker writer;
+                     writer.reserve(64 * 1024 * 1024);
+                     f(writer);
+                     writer.finish();
+                 } );
+        }
+    }
+    std::fclose(file);
+    return 0;
+}
@@ -0,0 +1,84 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/outbuf/stream.hpp>
+#include <boost/outbuf/string.hpp>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+// Compares write and write_stream copying large payloads into a cstr_writer.
+// The first table is the copy bandwidth. The second one is the time taken
+// by a "concurrent" workload that traverses a hot working set of 1 MiB after
+// each copy: since the copy with normal stores evicts the working set from
+// the cache, while the one with non-temporal stores does not, the workload
+// is expected to run faster after write_stream.
+
+using write_func = void (*)(boost::outbuf&, const char*, std::size_t);
+
+void write_normal(boost::outbuf& dest, const char* str, std::size_t len)
+{
+    write(dest, str, len);
+}
+
+void write_nt(boost::outbuf& dest, const char* str, std::size_t len)
+{
+    boost::write_stream(dest, str, len, 0);
+}
+
+std::uint64_t traverse(const std::vector<std::uint64_t>& hot)
+{
+    std::uint64_t sum = 0;
+    for (std::size_t i = 0; i < hot.size(); i += 8) // one access per cache line
+    {
+        sum += hot[i];
+    }
+    return sum;
+}
+
+int main()
+{
+    std::vector<std::uint64_t> hot(1024 * 1024 / sizeof(std::uint64_t), 1);
+    std::uint64_t checksum = 0;
+    std::vector<char> dest_buff(64 * 1024 * 1024 + 1);
+
+    std::cout << std::setw(40) << std::left << "copy" << std::right
+              << std::setw(10) << "GB/s"
+              << std::setw(16) << "hot pass (us)" << '\n';
+    for (std::size_t size : { 1024 * 1024, 4 * 1024 * 1024, 16 * 1024 * 1024, 64 * 1024 * 1024 })
+    {
+        const std::string payload(size, 'x');
+        const std::size_t loop_size = 256 * 1024 * 1024 / size;
+        for (auto func : { write_normal, write_nt })
+        {
+            std::chrono::duration<double> copy_time{0};
+            std::chrono::duration<double> hot_time{0};
+            for (std::size_t i = 0; i < loop_size; ++i)
+            {
+                checksum += traverse(hot); // warm up the working set
+                auto t1 = std::chrono::steady_clock::now();
+                boost::cstr_writer writer(dest_buff.data(), dest_buff.size());
+                func(writer, payload.data(), payload.size());
+                writer.finish();
+                auto t2 = std::chrono::steady_clock::now();
+                checksum += traverse(hot);
+                auto t3 = std::chrono::steady_clock::now();
+                copy_time += t2 - t1;
+                hot_time += t3 - t2;
+            }
+            std::string label = (func == write_normal ? "write, " : "write_stream, ")
+                + std::to_string(size / 1024) + " KiB";
+            std::cout << std::setw(40) << std::left << label << std::right
+                      << std::setw(10) << std::fixed << std::setprecision(2)
+                      << static_cast<double>(size) * loop_size / copy_time.count() / 1e9
+                      << std::setw(16) << std::setprecision(1)
+                      << hot_time.count() / loop_size * 1e6 << '\n';
+        }
+    }
+    std::cout << "\n(checksum " << checksum << ")\n";
+    return 0;
+}
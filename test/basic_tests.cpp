@@ -24,10 +24,71 @@ void test_discarded_outbuf()
     BOOST_TEST(dob.end() == boost::outbuf_garbage_buf_end<CharT>());
 }
 
+template <typename CharT>
+void test_size_counting_outbuf()
+{
+    boost::size_counting_outbuf<CharT> ob;
+    BOOST_TEST(ob.good());
+    BOOST_TEST_EQ(ob.count(), 0);
+
+    auto tiny_str = test_utils::make_tiny_string<CharT>();
+    auto double_str = test_utils::make_double_string<CharT>();
+
+    write(ob, tiny_str.data(), tiny_str.size());
+    BOOST_TEST_EQ(ob.count(), tiny_str.size());
+    write(ob, double_str.data(), double_str.size());
+    BOOST_TEST_EQ(ob.count(), tiny_str.size() + double_str.size());
+
+    ob.recycle();
+    BOOST_TEST(ob.good());
+    BOOST_TEST(ob.pos() == boost::outbuf_garbage_buf<CharT>());
+    BOOST_TEST(ob.end() == boost::outbuf_garbage_buf_end<CharT>());
+    BOOST_TEST_EQ(ob.count(), tiny_str.size() + double_str.size());
+
+    ob.require(10);
+    ob.advance(3);
+    BOOST_TEST_EQ(ob.count(), tiny_str.size() + double_str.size() + 3);
+
+    auto size = boost::measure_size<CharT>([&](boost::basic_outbuf<CharT>& o) {
+            write(o, double_str.data(), double_str.size());
+            put(o, CharT('x'));
+        });
+    BOOST_TEST_EQ(size, double_str.size() + 1);
+
+    // a block larger than the buffer is not copied
+    boost::size_counting_outbuf<CharT> ob2;
+    auto big_str = test_utils::make_string<CharT>(1000);
+    write(ob2, tiny_str.data(), tiny_str.size());
+    auto pos = ob2.pos();
+    write(ob2, big_str.data(), big_str.size());
+    BOOST_TEST(ob2.pos() == pos);
+    BOOST_TEST_EQ(ob2.count(), tiny_str.size() + big_str.size());
+    BOOST_TEST(ob2.write_direct(big_str.data(), big_str.size()));
+    BOOST_TEST_EQ(ob2.count(), tiny_str.size() + 2 * big_str.size());
+}
+
+template <typename CharT>
+void test_reserve_contiguous_default()
+{
+    boost::discarded_outbuf<CharT> dob;
+    constexpr auto min_size = boost::min_size_after_recycle<CharT>();
+    BOOST_TEST_EQ(dob.max_contiguous(), min_size);
+
+    dob.advance(10);
+    BOOST_TEST(dob.reserve_contiguous(min_size));
+    BOOST_TEST_GE(dob.size(), min_size);
+    BOOST_TEST(! dob.reserve_contiguous(min_size + 1));
+    BOOST_TEST(dob.as_underlying().reserve_contiguous(min_size));
+}
+
 int main()
 {
     test_discarded_outbuf<char>();
     test_discarded_outbuf<char16_t>();
+    test_size_counting_outbuf<char>();
+    test_size_counting_outbuf<char32_t>();
+    test_reserve_contiguous_default<char>();
+    test_reserve_contiguous_default<char32_t>();
 
     return boost::report_errors();
 }
@@ -0,0 +1,227 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/core/lightweight_test.hpp>
+#include <boost/outbuf/async.hpp>
+#include <boost/outbuf/string.hpp>
+#include "test_utils.hpp"
+
+// A sink whose recycle() waits while the gate is closed,
+// like a slow device
+template <typename CharT>
+class gated_sink final: public boost::basic_outbuf<CharT>
+{
+public:
+
+    gated_sink()
+        : boost::basic_outbuf<CharT>(_buf, _buf_size)
+    {
+    }
+
+    void recycle() override
+    {
+        while ( ! open.load())
+        {
+            std::this_thread::yield();
+        }
+        if (this->good())
+        {
+            content.append(_buf, this->pos());
+            if (fail_after != 0 && content.size() >= fail_after)
+            {
+                this->set_good(false);
+            }
+        }
+        this->set_pos(_buf);
+    }
+
+    std::basic_string<CharT> finish()
+    {
+        recycle();
+        return content;
+    }
+
+    std::atomic<bool> open {true};
+    std::size_t fail_after = 0;
+    std::basic_string<CharT> content;
+
+private:
+
+    static constexpr std::size_t _buf_size = boost::min_size_after_recycle<CharT>();
+    CharT _buf[_buf_size];
+};
+
+template <typename CharT>
+void test_successfull_writing()
+{
+    auto tiny_str = test_utils::make_tiny_string<CharT>();
+    auto big_str = test_utils::make_string<CharT>(100000);
+    auto expected_content = tiny_str + big_str + tiny_str;
+
+    boost::basic_string_maker<CharT> sink;
+    boost::basic_async_writer<CharT> writer(sink, 1000);
+    BOOST_TEST_EQ(writer.buffer_size(), 1000);
+    BOOST_TEST_EQ(writer.max_contiguous(), 1000);
+    BOOST_TEST_EQ(writer.buffers_count(), 4);
+
+    write(writer, tiny_str.data(), tiny_str.size());
+    write(writer, big_str.data(), big_str.size());
+    writer.recycle();
+    writer.recycle(); // nothing to write
+    write(writer, tiny_str.data(), tiny_str.size());
+    auto status = writer.finish();
+
+    BOOST_TEST(status.success);
+    BOOST_TEST_EQ(status.count, expected_content.size());
+    BOOST_TEST(sink.finish() == expected_content);
+}
+
+void test_block()
+{
+    auto str = test_utils::make_string<char>(100);
+    gated_sink<char> sink;
+    sink.open = false;
+    boost::async_writer writer(sink, 100, 3);
+
+    // While the sink does not accept the content, the two free buffers
+    // are filled, and then recycle() blocks until the gate is opened
+    std::thread opener([&]{
+            while (writer.queue_depth() < 2)
+            {
+                std::this_thread::yield();
+            }
+            sink.open = true;
+        });
+    std::string expected_content;
+    for (int i = 0; i < 10; ++i)
+    {
+        write(writer, str.data(), str.size());
+        expected_content += str;
+    }
+    auto status = writer.finish();
+    opener.join();
+
+    BOOST_TEST(status.success);
+    BOOST_TEST_GE(writer.stalls(), 1);
+    BOOST_TEST_EQ(writer.dropped(), 0);
+    BOOST_TEST(sink.finish() == expected_content);
+}
+
+void test_drop()
+{
+    auto str = test_utils::make_string<char>(100);
+    gated_sink<char> sink;
+    sink.open = false;
+    boost::async_writer writer(sink, 100, 3, boost::async_writer_overflow::drop);
+
+    // The first buffer is being written, the second waits in the
+    // queue, and the content of the third is discarded on recycle()
+    for (int i = 0; i < 6; ++i)
+    {
+        write(writer, str.data(), str.size());
+    }
+    BOOST_TEST(writer.good());
+    BOOST_TEST_EQ(writer.stalls(), 0);
+    BOOST_TEST_GE(writer.dropped(), 300);
+    sink.open = true;
+    auto status = writer.finish();
+
+    BOOST_TEST(status.success);
+    auto content = sink.finish();
+    BOOST_TEST_EQ(content.size() + writer.dropped(), 600);
+    BOOST_TEST_EQ(content.size(), status.count);
+    BOOST_TEST_EQ(content.size() % str.size(), 0);
+    for (std::size_t i = 0; i < content.size(); i += str.size())
+    {
+        BOOST_TEST(content.compare(i, str.size(), str) == 0);
+    }
+}
+
+void test_grow()
+{
+    auto str = test_utils::make_string<char>(100);
+    gated_sink<char> sink;
+    sink.open = false;
+    boost::async_writer writer(sink, 100, 2, boost::async_writer_overflow::grow, 20);
+
+    std::string expected_content;
+    for (int i = 0; i < 15; ++i)
+    {
+        write(writer, str.data(), str.size());
+        expected_content += str;
+    }
+    BOOST_TEST_EQ(writer.stalls(), 0);
+    BOOST_TEST_GE(writer.buffers_count(), 14);
+    BOOST_TEST_LE(writer.buffers_count(), 20);
+    sink.open = true;
+    auto status = writer.finish();
+
+    BOOST_TEST(status.success);
+    BOOST_TEST_EQ(writer.dropped(), 0);
+    BOOST_TEST(sink.finish() == expected_content);
+}
+
+void test_failing_sink()
+{
+    auto str = test_utils::make_string<char>(100);
+    gated_sink<char> sink;
+    sink.fail_after = 250;
+    boost::async_writer writer(sink, 100, 2);
+    for (int i = 0; i < 100 && writer.good(); ++i)
+    {
+        write(writer, str.data(), str.size());
+    }
+    BOOST_TEST(! writer.good());
+    auto status = writer.finish();
+    BOOST_TEST(! status.success);
+    BOOST_TEST_LT(status.count, 10000);
+}
+
+template <typename CharT>
+void test_failing_to_finish()
+{
+    auto double_str = test_utils::make_double_string<CharT>();
+    auto half_str = test_utils::make_half_string<CharT>();
+
+    boost::basic_string_maker<CharT> sink;
+    boost::basic_async_writer<CharT> writer(sink);
+    write(writer, double_str.data(), double_str.size());
+    writer.recycle();
+    write(writer, half_str.data(), half_str.size());
+    test_utils::turn_into_bad(writer);
+
+    auto status = writer.finish();
+    BOOST_TEST(! status.success);
+    BOOST_TEST_EQ(status.count, double_str.size());
+    BOOST_TEST(sink.finish() == double_str);
+}
+
+void test_destroyed_without_finish()
+{
+    auto half_str = test_utils::make_half_string<char>();
+    boost::string_maker sink;
+    {
+        boost::async_writer writer(sink);
+        write(writer, half_str.data(), half_str.size());
+        writer.recycle();
+        write(writer, half_str.data(), half_str.size());
+    }
+    BOOST_TEST(sink.finish() == half_str);
+}
+
+int main()
+{
+    test_successfull_writing<char>();
+    test_successfull_writing<char16_t>();
+    test_successfull_writing<char32_t>();
+    test_block();
+    test_drop();
+    test_grow();
+    test_failing_sink();
+    test_failing_to_finish<char>();
+    test_failing_to_finish<wchar_t>();
+    test_destroyed_without_finish();
+
+    return boost::report_errors();
+}
@@ -0,0 +1,265 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/core/lightweight_test.hpp>
+#include <boost/outbuf/base64.hpp>
+#include <boost/outbuf/string.hpp>
+#include <cstdlib>
+#include <string>
+
+const boost::base64_kernel all_kernels[] =
+    { boost::base64_kernel::scalar
+    , boost::base64_kernel::ssse3
+    , boost::base64_kernel::avx2
+    , boost::base64_kernel::avx512vbmi };
+
+std::string reference_encode(const std::string& data)
+{
+    const char* alphabet =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string result;
+    std::size_t i = 0;
+    for (; i + 3 <= data.size(); i += 3)
+    {
+        unsigned v = ((unsigned char)data[i] << 16)
+                   | ((unsigned char)data[i + 1] << 8)
+                   | (unsigned char)data[i + 2];
+        result += alphabet[v >> 18];
+        result += alphabet[(v >> 12) & 63];
+        result += alphabet[(v >> 6) & 63];
+        result += alphabet[v & 63];
+    }
+    if (i + 1 == data.size())
+    {
+        unsigned v = (unsigned char)data[i] << 16;
+        result += alphabet[v >> 18];
+        result += alphabet[(v >> 12) & 63];
+        result += "==";
+    }
+    else if (i + 2 == data.size())
+    {
+        unsigned v = ((unsigned char)data[i] << 16)
+                   | ((unsigned char)data[i + 1] << 8);
+        result += alphabet[v >> 18];
+        result += alphabet[(v >> 12) & 63];
+        result += alphabet[(v >> 6) & 63];
+        result += '=';
+    }
+    return result;
+}
+
+std::string random_data(std::size_t size)
+{
+    std::string data(size, '\0');
+    for (auto& ch: data)
+    {
+        ch = static_cast<char>(std::rand());
+    }
+    return data;
+}
+
+std::string encode(const std::string& data, boost::base64_kernel k)
+{
+    boost::string_maker sm;
+    boost::base64_encode(sm, data.data(), data.size(), k);
+    return sm.finish();
+}
+
+bool decode(std::string& result, const std::string& str, boost::base64_kernel k)
+{
+    boost::string_maker sm;
+    bool success = boost::base64_decode(sm, str.data(), str.size(), k);
+    result = sm.finish();
+    return success;
+}
+
+void test_rfc4648_vectors()
+{
+    const char* const vectors[][2] =
+        { {"", ""}
+        , {"f", "Zg=="}
+        , {"fo", "Zm8="}
+        , {"foo", "Zm9v"}
+        , {"foob", "Zm9vYg=="}
+        , {"fooba", "Zm9vYmE="}
+        , {"foobar", "Zm9vYmFy"} };
+
+    for (auto k: all_kernels)
+    {
+        for (auto& v: vectors)
+        {
+            BOOST_TEST_EQ(encode(v[0], k), v[1]);
+            std::string decoded;
+            BOOST_TEST(decode(decoded, v[1], k));
+            BOOST_TEST_EQ(decoded, v[0]);
+        }
+    }
+}
+
+void test_kernels()
+{
+    for (std::size_t size = 0; size < 400; ++size)
+    {
+        auto data = random_data(size);
+        auto expected = reference_encode(data);
+        for (auto k: all_kernels)
+        {
+            auto encoded = encode(data, k);
+            BOOST_TEST(encoded == expected);
+            std::string decoded;
+            BOOST_TEST(decode(decoded, expected, k));
+            BOOST_TEST(decoded == data);
+        }
+    }
+    auto data = random_data(100000);
+    auto expected = reference_encode(data);
+    for (auto k: all_kernels)
+    {
+        BOOST_TEST(encode(data, k) == expected);
+        std::string decoded;
+        BOOST_TEST(decode(decoded, expected, k));
+        BOOST_TEST(decoded == data);
+    }
+}
+
+void test_invalid_input()
+{
+    const auto valid = reference_encode(random_data(300));
+    const char invalid_chars[] = { '*', ' ', '\n', '-', '_', '=', '\0', '\x80', '\xFF' };
+    for (auto k: all_kernels)
+    {
+        for (std::size_t i = 0; i < valid.size(); ++i)
+        {
+            for (char ch: invalid_chars)
+            {
+                if (ch == '=' && i + 1 == valid.size())
+                {
+                    continue; // that would be a valid padding
+                }
+                auto str = valid;
+                str[i] = ch;
+                std::string decoded;
+                BOOST_TEST(! decode(decoded, str, k));
+            }
+        }
+        std::string decoded;
+        BOOST_TEST(! decode(decoded, "Zm9vY", k));
+        BOOST_TEST(! decode(decoded, "Zg=a", k));
+        BOOST_TEST(! decode(decoded, "Z===", k));
+        BOOST_TEST(! decode(decoded, "Zg==Zm9v", k));
+        BOOST_TEST(! decode(decoded, "====", k));
+    }
+}
+
+void test_all_byte_values()
+{
+    for (auto k: all_kernels)
+    {
+        for (int i = 0; i < 256; ++i)
+        {
+            std::string str(64, 'A');
+            str[20] = static_cast<char>(i);
+            std::string decoded;
+            bool valid = ( (i >= 'A' && i <= 'Z') || (i >= 'a' && i <= 'z')
+                        || (i >= '0' && i <= '9') || i == '+' || i == '/' );
+            BOOST_TEST_EQ(decode(decoded, str, k), valid);
+        }
+    }
+}
+
+void test_encoder()
+{
+    auto data = random_data(10000);
+    auto expected = reference_encode(data);
+    for (auto k: all_kernels)
+    {
+        boost::string_maker sm;
+        boost::base64_encoder encoder(sm, k);
+        std::size_t i = 0;
+        while (i < data.size())
+        {
+            std::size_t n = std::rand() % 700;
+            n = n < data.size() - i ? n : data.size() - i;
+            write(encoder, data.data() + i, n);
+            i += n;
+        }
+        encoder.finish();
+        BOOST_TEST(sm.finish() == expected);
+    }
+    {
+        boost::string_maker sm;
+        boost::base64_encoder encoder(sm);
+        write(encoder, "fooba");
+        encoder.finish();
+        BOOST_TEST_EQ(sm.finish(), "Zm9vYmE=");
+    }
+}
+
+void test_decoder()
+{
+    auto data = random_data(10000);
+    auto encoded = reference_encode(data);
+    for (auto k: all_kernels)
+    {
+        boost::string_maker sm;
+        boost::base64_decoder decoder(sm, k);
+        std::size_t i = 0;
+        while (i < encoded.size())
+        {
+            std::size_t n = std::rand() % 700;
+            n = n < encoded.size() - i ? n : encoded.size() - i;
+            write(decoder, encoded.data() + i, n);
+            i += n;
+        }
+        BOOST_TEST(decoder.finish());
+        BOOST_TEST(sm.finish() == data);
+    }
+    {
+        boost::string_maker sm;
+        boost::base64_decoder decoder(sm);
+        write(decoder, "Zm9vYmE=");
+        BOOST_TEST(decoder.finish());
+        BOOST_TEST_EQ(sm.finish(), "fooba");
+    }
+    {   // padding is only allowed at the end
+        boost::string_maker sm;
+        boost::base64_decoder decoder(sm);
+        write(decoder, "Zm9vYmE=");
+        decoder.recycle();
+        write(decoder, "Zm9v");
+        BOOST_TEST(! decoder.finish());
+    }
+    {   // incomplete group
+        boost::string_maker sm;
+        boost::base64_decoder decoder(sm);
+        write(decoder, "Zm9vYmE");
+        BOOST_TEST(! decoder.finish());
+    }
+    {   // invalid character
+        boost::string_maker sm;
+        boost::base64_decoder decoder(sm);
+        write(decoder, encoded.data(), 1000);
+        write(decoder, "Zm9*");
+        write(decoder, encoded.data(), 1000);
+        BOOST_TEST(! decoder.finish());
+    }
+}
+
+void test_kernel_selection()
+{
+    BOOST_TEST(boost::base64_kernel_supported(boost::base64_kernel::scalar));
+    BOOST_TEST(boost::base64_kernel_supported(boost::base64_best_kernel()));
+}
+
+int main()
+{
+    test_rfc4648_vectors();
+    test_kernels();
+    test_invalid_input();
+    test_all_byte_values();
+    test_encoder();
+    test_decoder();
+    test_kernel_selection();
+    return boost::report_errors();
+}
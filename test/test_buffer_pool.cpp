@@ -0,0 +1,175 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/core/lightweight_test.hpp>
+#include <boost/outbuf/buffer_pool.hpp>
+#include <thread>
+#include <vector>
+
+bool is_aligned(void* p, std::size_t alignment)
+{
+    return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+}
+
+void test_rounded_size()
+{
+    using pool = boost::outbuf_buffer_pool;
+    BOOST_TEST_EQ(pool::rounded_size(0), 1024);
+    BOOST_TEST_EQ(pool::rounded_size(1), 1024);
+    BOOST_TEST_EQ(pool::rounded_size(1024), 1024);
+    BOOST_TEST_EQ(pool::rounded_size(1025), 2048);
+    BOOST_TEST_EQ(pool::rounded_size(64 * 1024 * 1024), 64 * 1024 * 1024);
+    BOOST_TEST_EQ(pool::rounded_size(64 * 1024 * 1024 + 1), 64 * 1024 * 1024 + 64);
+}
+
+void test_thread_cache()
+{
+    boost::outbuf_buffer_pool pool;
+    void* p1 = pool.allocate(5000);
+    BOOST_TEST(p1 != nullptr);
+    BOOST_TEST(is_aligned(p1, 64));
+    pool.deallocate(p1, 5000);
+
+    void* p2 = pool.allocate(8000); // same size class
+    BOOST_TEST_EQ(p2, p1);
+    pool.deallocate(p2, 8000);
+
+    auto stats = pool.statistics();
+    BOOST_TEST_EQ(stats.misses, 1);
+    BOOST_TEST_EQ(stats.thread_cache_hits, 1);
+    BOOST_TEST_EQ(stats.shared_hits, 0);
+    BOOST_TEST_EQ(stats.shared_cached_bytes, 0);
+}
+
+void test_shared_lists()
+{
+    // When the thread cache is full, the blocks go to the shared lists,
+    // from where other threads take them
+    boost::outbuf_buffer_pool pool;
+    std::vector<void*> blocks;
+    for (int i = 0; i < 10; ++i)
+    {
+        blocks.push_back(pool.allocate(1000));
+    }
+    for (void* p : blocks)
+    {
+        pool.deallocate(p, 1000);
+    }
+    BOOST_TEST_EQ(pool.statistics().shared_cached_bytes, 2 * 1024);
+
+    std::thread th([&]{
+            void* p = pool.allocate(1000);
+            BOOST_TEST(p == blocks[8] || p == blocks[9]);
+            pool.deallocate(p, 1000);
+            // and at the exit of the thread, its cache is moved to the shared lists
+        });
+    th.join();
+
+    auto stats = pool.statistics();
+    BOOST_TEST_EQ(stats.misses, 10);
+    BOOST_TEST_EQ(stats.shared_hits, 1);
+    BOOST_TEST_EQ(stats.shared_cached_bytes, 2 * 1024);
+}
+
+void test_max_cached_bytes()
+{
+    boost::outbuf_buffer_pool pool(4096);
+    std::vector<void*> blocks;
+    for (int i = 0; i < 20; ++i)
+    {
+        blocks.push_back(pool.allocate(2048));
+    }
+    for (void* p : blocks)
+    {
+        pool.deallocate(p, 2048);
+    }
+    BOOST_TEST_EQ(pool.statistics().shared_cached_bytes, 4096);
+}
+
+void test_large_classes_bypass_thread_cache()
+{
+    // Blocks of 1 MiB or more go directly to the shared lists,
+    // so that max_cached_bytes bounds them
+    const std::size_t size = 1024 * 1024;
+    boost::outbuf_buffer_pool pool(2 * size);
+    std::vector<void*> blocks;
+    for (int i = 0; i < 3; ++i)
+    {
+        blocks.push_back(pool.allocate(size));
+    }
+    for (void* p : blocks)
+    {
+        pool.deallocate(p, size);
+    }
+    BOOST_TEST_EQ(pool.statistics().shared_cached_bytes, 2 * size);
+
+    void* p = pool.allocate(size);
+    BOOST_TEST(p == blocks[0] || p == blocks[1]);
+    pool.deallocate(p, size);
+
+    auto stats = pool.statistics();
+    BOOST_TEST_EQ(stats.misses, 3);
+    BOOST_TEST_EQ(stats.shared_hits, 1);
+    BOOST_TEST_EQ(stats.thread_cache_hits, 0);
+}
+
+void test_big_blocks()
+{
+    // Blocks larger than the biggest size class are not cached
+    const std::size_t size = 64 * 1024 * 1024 + 10;
+    boost::outbuf_buffer_pool pool;
+    void* p = pool.allocate(size);
+    BOOST_TEST(p != nullptr);
+    BOOST_TEST(is_aligned(p, 64));
+    pool.deallocate(p, size);
+    pool.deallocate(nullptr, size);
+    p = pool.allocate(size);
+    pool.deallocate(p, size);
+    BOOST_TEST_EQ(pool.statistics().misses, 2);
+}
+
+void test_huge_pages()
+{
+    boost::outbuf_buffer_pool pool(64 * 1024 * 1024, true);
+    void* p = pool.allocate(3 * 1024 * 1024);
+    BOOST_TEST(p != nullptr);
+    BOOST_TEST(is_aligned(p, 2 * 1024 * 1024));
+    pool.deallocate(p, 3 * 1024 * 1024);
+
+    p = pool.allocate(1000);
+    BOOST_TEST(is_aligned(p, 64));
+    pool.deallocate(p, 1000);
+}
+
+void test_pool_destroyed_before_thread_exit()
+{
+    // The thread cache of a destroyed pool is not used
+    // by another pool created at the same address
+    {
+        boost::outbuf_buffer_pool pool;
+        pool.deallocate(pool.allocate(1000), 1000);
+    }
+    {
+        boost::outbuf_buffer_pool pool;
+        void* p = pool.allocate(1000);
+        BOOST_TEST(p != nullptr);
+        pool.deallocate(p, 1000);
+        BOOST_TEST_EQ(pool.statistics().misses, 1);
+        BOOST_TEST_EQ(pool.statistics().thread_cache_hits, 0);
+    }
+}
+
+int main()
+{
+    test_rounded_size();
+    test_thread_cache();
+    test_shared_lists();
+    test_max_cached_bytes();
+    test_large_classes_bypass_thread_cache();
+    test_big_blocks();
+    test_huge_pages();
+    test_pool_destroyed_before_thread_exit();
+
+    return boost::report_errors();
+}
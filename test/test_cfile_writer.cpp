@@ -6,6 +6,7 @@
 
 #include <boost/core/lightweight_test.hpp>
 #include <boost/outbuf/cfile.hpp>
+#include <clocale>
 #include <ctime>
 #include <cstdlib>
 #include "test_utils.hpp"
@@ -34,22 +35,228 @@ void test_narrow_successfull_writing()
     BOOST_TEST(obtained_content == expected_content);
 }
 
+template <typename CharT>
+void test_narrow_buffer_size()
+{
+    const std::size_t buf_size = boost::min_size_after_recycle<CharT>();
+    auto tiny_str = test_utils::make_tiny_string<CharT>();
+    auto big_str = test_utils::make_string<CharT>(buf_size * 5 + 3);
+
+    std::FILE* file = std::tmpfile();
+    boost::narrow_cfile_writer<CharT> writer(file, buf_size);
+    BOOST_TEST_EQ(writer.buffer_size(), buf_size);
+    BOOST_TEST_EQ(writer.size(), buf_size);
+    auto expected_content = tiny_str + big_str;
+
+    write(writer, tiny_str.data(), tiny_str.size());
+    write(writer, big_str.data(), big_str.size());
+    auto status = writer.finish();
+    std::fflush(file);
+    std::rewind(file);
+    auto obtained_content = test_utils::read_file<CharT>(file);
+    std::fclose(file);
+
+    BOOST_TEST(status.success);
+    BOOST_TEST_EQ(status.count, obtained_content.size());
+    BOOST_TEST(obtained_content == expected_content);
+}
+
+template <typename CharT>
+void test_narrow_caller_supplied_buffer()
+{
+    CharT buf[100];
+    auto tiny_str = test_utils::make_tiny_string<CharT>();
+    auto big_str = test_utils::make_string<CharT>(350);
+
+    std::FILE* file = std::tmpfile();
+    boost::narrow_cfile_writer<CharT> writer(file, buf, 100);
+    BOOST_TEST(writer.pos() == buf);
+    BOOST_TEST(writer.end() == buf + 100);
+    auto expected_content = tiny_str + big_str;
+
+    write(writer, tiny_str.data(), tiny_str.size());
+    write(writer, big_str.data(), big_str.size());
+    auto status = writer.finish();
+    std::fflush(file);
+    std::rewind(file);
+    auto obtained_content = test_utils::read_file<CharT>(file);
+    std::fclose(file);
+
+    BOOST_TEST(status.success);
+    BOOST_TEST_EQ(status.count, obtained_content.size());
+    BOOST_TEST(obtained_content == expected_content);
+}
+
+template <typename CharT>
+void test_narrow_default_buffer_size()
+{
+    std::FILE* file = std::tmpfile();
+    boost::narrow_cfile_writer<CharT> writer(file);
+    BOOST_TEST_EQ( writer.buffer_size()
+                 , boost::narrow_cfile_writer_default_buffer_size<CharT>() );
+    BOOST_TEST_EQ(writer.size(), writer.buffer_size());
+    writer.finish();
+    std::fclose(file);
+}
+
+template <typename CharT>
+void test_narrow_reserve_contiguous()
+{
+    auto half_str = test_utils::make_half_string<CharT>();
+
+    std::FILE* file = std::tmpfile();
+    boost::narrow_cfile_writer<CharT> writer(file, 1000);
+    BOOST_TEST_EQ(writer.max_contiguous(), 1000);
+    write(writer, half_str.data(), half_str.size());
+    BOOST_TEST(! writer.reserve_contiguous(1001));
+    BOOST_TEST(writer.reserve_contiguous(1000));
+    BOOST_TEST_EQ(writer.size(), 1000);
+    auto status = writer.finish();
+    std::fflush(file);
+    std::rewind(file);
+    auto obtained_content = test_utils::read_file<CharT>(file);
+    std::fclose(file);
+
+    BOOST_TEST(status.success);
+    BOOST_TEST(obtained_content == half_str);
+}
+
+template <typename CharT>
+void test_narrow_reset()
+{
+    auto tiny_str = test_utils::make_tiny_string<CharT>();
+    auto double_str = test_utils::make_double_string<CharT>();
+
+    std::FILE* file1 = std::tmpfile();
+    std::FILE* file2 = std::tmpfile();
+    boost::narrow_cfile_writer<CharT> writer(file1);
+    write(writer, double_str.data(), double_str.size());
+    writer.finish();
+
+    writer.reset(file2);
+    BOOST_TEST(writer.good());
+    BOOST_TEST_EQ(writer.size(), writer.buffer_size());
+    write(writer, tiny_str.data(), tiny_str.size());
+    auto status = writer.finish();
+    BOOST_TEST(status.success);
+    BOOST_TEST_EQ(status.count, tiny_str.size());
+
+    writer.reset();
+    write(writer, double_str.data(), double_str.size());
+    status = writer.finish();
+    BOOST_TEST(status.success);
+    BOOST_TEST_EQ(status.count, double_str.size());
+
+    std::fflush(file1);
+    std::fflush(file2);
+    std::rewind(file1);
+    std::rewind(file2);
+    auto content1 = test_utils::read_file<CharT>(file1);
+    auto content2 = test_utils::read_file<CharT>(file2);
+    std::fclose(file1);
+    std::fclose(file2);
+    BOOST_TEST(content1 == double_str);
+    BOOST_TEST(content2 == tiny_str + double_str);
+}
+
+template <typename CharT>
+void test_narrow_buffer_from_pool()
+{
+    auto double_str = test_utils::make_double_string<CharT>();
+    auto big_str = test_utils::make_string<CharT>(3000);
+    auto expected_content = double_str + big_str;
+
+    boost::outbuf_buffer_pool pool;
+    std::FILE* file = std::tmpfile();
+    {
+        boost::narrow_cfile_writer<CharT> writer(file, pool, 1000);
+        BOOST_TEST_EQ(writer.buffer_size(), 1024);
+        write(writer, double_str.data(), double_str.size());
+        writer.finish();
+    }
+    {
+        // the buffer returned by the first writer is reused
+        boost::narrow_cfile_writer<CharT> writer(file, pool, 1000);
+        write(writer, big_str.data(), big_str.size());
+        writer.finish();
+    }
+    std::fflush(file);
+    std::rewind(file);
+    auto obtained_content = test_utils::read_file<CharT>(file);
+    std::fclose(file);
+
+    BOOST_TEST(obtained_content == expected_content);
+    auto stats = pool.statistics();
+    BOOST_TEST_EQ(stats.misses, 1);
+    BOOST_TEST_EQ(stats.thread_cache_hits, 1);
+}
+
+template <typename CharT>
+void test_narrow_write_direct()
+{
+    auto tiny_str = test_utils::make_tiny_string<CharT>();
+    auto big_str = test_utils::make_string<CharT>(1000);
+    auto expected_content = tiny_str + big_str + tiny_str;
+
+    std::FILE* file = std::tmpfile();
+    boost::narrow_cfile_writer<CharT> writer(file, 100);
+    BOOST_TEST(! writer.write_direct(tiny_str.data(), tiny_str.size()));
+    write(writer, tiny_str.data(), tiny_str.size());
+    BOOST_TEST(writer.write_direct(big_str.data(), big_str.size()));
+    BOOST_TEST(writer.pos() == writer.end() - 100);
+    write(writer, tiny_str.data(), tiny_str.size());
+    write(writer, big_str.data(), big_str.size());
+    auto status = writer.finish();
+    std::fflush(file);
+    std::rewind(file);
+    auto obtained_content = test_utils::read_file<CharT>(file);
+    std::fclose(file);
+
+    BOOST_TEST(status.success);
+    BOOST_TEST_EQ(status.count, expected_content.size() + big_str.size());
+    BOOST_TEST(obtained_content == expected_content + big_str);
+}
+
+void test_wide_write_direct()
+{
+    auto tiny_str = test_utils::make_tiny_string<wchar_t>();
+    auto big_str = test_utils::make_string<wchar_t>(1000);
+    auto expected_content = tiny_str + big_str + tiny_str;
+
+    auto path = test_utils::unique_tmp_file_name();
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    std::fwide(file, -1);
+    boost::wide_cfile_writer writer(file, 100);
+    BOOST_TEST(! writer.write_direct(tiny_str.data(), tiny_str.size()));
+    write(writer, tiny_str.data(), tiny_str.size());
+    write(writer, big_str.data(), big_str.size());
+    write(writer, tiny_str.data(), tiny_str.size());
+    auto status = writer.finish();
+    std::fclose(file);
+    auto obtained_content = test_utils::read_wfile(path.c_str());
+    std::remove(path.c_str());
+
+    BOOST_TEST(status.success);
+    BOOST_TEST_EQ(status.count, expected_content.size());
+    BOOST_TEST(obtained_content == expected_content);
+}
+
 void test_wide_successfull_writing()
 {
     auto tiny_str = test_utils::make_tiny_string<wchar_t>();
     auto double_str = test_utils::make_double_string<wchar_t>();
 
-    std::FILE* file = std::tmpfile();
+    auto path = test_utils::unique_tmp_file_name();
+    std::FILE* file = std::fopen(path.c_str(), "w");
     boost::wide_cfile_writer writer(file);
     auto expected_content = tiny_str + double_str;
 
     write(writer, tiny_str.data(), tiny_str.size());
     write(writer, double_str.data(), double_str.size());
     auto status = writer.finish();
-    std::fflush(file);
-    std::rewind(file);
-    auto obtained_content = test_utils::read_wfile(file);
     std::fclose(file);
+    auto obtained_content = test_utils::read_wfile(path.c_str());
+    std::remove(path.c_str());
 
     BOOST_TEST(status.success);
     BOOST_TEST_EQ(status.count, obtained_content.size());
@@ -159,6 +366,122 @@ void test_wide_failing_to_finish()
     BOOST_TEST(obtained_content == expected_content);
 }
 
+void test_wide_wide_oriented_stream()
+{
+    auto double_str = test_utils::make_double_string<wchar_t>();
+
+    auto path = test_utils::unique_tmp_file_name();
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    std::fwide(file, 1);
+    boost::wide_cfile_writer writer(file);
+    write(writer, double_str.data(), double_str.size());
+    auto status = writer.finish();
+    BOOST_TEST(std::fwide(file, 0) > 0);
+    std::fclose(file);
+    auto obtained_content = test_utils::read_wfile(path.c_str());
+    std::remove(path.c_str());
+
+    BOOST_TEST(status.success);
+    BOOST_TEST_EQ(status.count, double_str.size());
+    BOOST_TEST(obtained_content == double_str);
+}
+
+void test_wide_unoriented_stream()
+{
+    // the stream becomes wide-oriented, so that it
+    // can still be written with fputws afterwards
+    auto double_str = test_utils::make_double_string<wchar_t>();
+
+    auto path = test_utils::unique_tmp_file_name();
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    boost::wide_cfile_writer writer(file);
+    write(writer, double_str.data(), double_str.size());
+    auto status = writer.finish();
+    BOOST_TEST(std::fwide(file, 0) > 0);
+    BOOST_TEST(std::fputws(L"end", file) >= 0);
+    std::fclose(file);
+    auto obtained_content = test_utils::read_wfile(path.c_str());
+    std::remove(path.c_str());
+
+    BOOST_TEST(status.success);
+    BOOST_TEST_EQ(status.count, double_str.size());
+    BOOST_TEST(obtained_content == double_str + L"end");
+}
+
+void test_wide_byte_oriented_stream()
+{
+    auto double_str = test_utils::make_double_string<wchar_t>();
+
+    auto path = test_utils::unique_tmp_file_name();
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    std::fwide(file, -1);
+    boost::wide_cfile_writer writer(file);
+    write(writer, double_str.data(), double_str.size());
+    auto status = writer.finish();
+    BOOST_TEST(std::fwide(file, 0) < 0);
+    std::fclose(file);
+    auto obtained_content = test_utils::read_wfile(path.c_str());
+    std::remove(path.c_str());
+
+    BOOST_TEST(status.success);
+    BOOST_TEST_EQ(status.count, double_str.size());
+    BOOST_TEST(obtained_content == double_str);
+}
+
+void test_wide_utf8()
+{
+    if ( std::setlocale(LC_CTYPE, "C.UTF-8") == nullptr
+      && std::setlocale(LC_CTYPE, "en_US.UTF-8") == nullptr )
+    {
+        return;
+    }
+    std::wstring input;
+    std::string expected;
+    for (int i = 0; i < 100; ++i)
+    {
+        input += L"ab\u00E9\u20AC";
+        expected += "ab\xC3\xA9\xE2\x82\xAC";
+        if (sizeof(wchar_t) == 4)
+        {
+            input += static_cast<wchar_t>(0x1F600);
+            expected += "\xF0\x9F\x98\x80";
+        }
+    }
+    {
+        auto path = test_utils::unique_tmp_file_name();
+        std::FILE* file = std::fopen(path.c_str(), "w");
+        std::fwide(file, -1);
+        boost::wide_cfile_writer writer(file, 100);
+        write(writer, input.data(), input.size());
+        auto status = writer.finish();
+        std::fclose(file);
+        auto obtained_content = test_utils::read_file<char>(path.c_str());
+        std::remove(path.c_str());
+
+        BOOST_TEST(status.success);
+        BOOST_TEST_EQ(status.count, input.size());
+        BOOST_TEST(obtained_content == expected);
+    }
+    {   // invalid code point
+        auto path = test_utils::unique_tmp_file_name();
+        std::FILE* file = std::fopen(path.c_str(), "w");
+        std::fwide(file, -1);
+        boost::wide_cfile_writer writer(file);
+        write(writer, input.data(), input.size());
+        put(writer, static_cast<wchar_t>(0xD800));
+        write(writer, L"blah");
+        auto status = writer.finish();
+        std::fclose(file);
+        auto obtained_content = test_utils::read_file<char>(path.c_str());
+        std::remove(path.c_str());
+
+        BOOST_TEST(! status.success);
+        BOOST_TEST_EQ(status.count, input.size());
+        BOOST_TEST(obtained_content == expected);
+    }
+    std::setlocale(LC_CTYPE, "C");
+}
+
 int main()
 {
     std::srand(static_cast<unsigned>(std::time(nullptr)));
@@ -178,9 +501,37 @@ int main()
     test_narrow_failing_to_finish<char32_t>();
     test_narrow_failing_to_finish<wchar_t>();
 
+    test_narrow_buffer_size<char>();
+    test_narrow_buffer_size<char16_t>();
+    test_narrow_buffer_size<char32_t>();
+    test_narrow_buffer_size<wchar_t>();
+
+    test_narrow_caller_supplied_buffer<char>();
+    test_narrow_caller_supplied_buffer<char16_t>();
+
+    test_narrow_default_buffer_size<char>();
+    test_narrow_default_buffer_size<char32_t>();
+
+    test_narrow_reserve_contiguous<char>();
+    test_narrow_reserve_contiguous<char32_t>();
+
+    test_narrow_reset<char>();
+    test_narrow_reset<char16_t>();
+
+    test_narrow_buffer_from_pool<char>();
+    test_narrow_buffer_from_pool<char32_t>();
+
+    test_narrow_write_direct<char>();
+    test_narrow_write_direct<char16_t>();
+
     test_wide_successfull_writing();
     test_wide_failing_to_recycle();
     test_wide_failing_to_finish();
+    test_wide_wide_oriented_stream();
+    test_wide_unoriented_stream();
+    test_wide_byte_oriented_stream();
+    test_wide_utf8();
+    test_wide_write_direct();
 
     return boost::report_errors();
 }
@@ -4,6 +4,7 @@
 
 #include <boost/core/lightweight_test.hpp>
 #include <boost/outbuf.hpp>
+#include <string>
 
 int main()
 {
@@ -50,5 +51,103 @@ int main()
         BOOST_TEST_CSTR_EQ(buff, "Hello W");
     }
 
+    {
+        char buff[100];
+        boost::basic_cstr_writer<char> sw(buff);
+        BOOST_TEST_EQ(sw.max_contiguous(), 99);
+        write(sw, "Hello World");
+        BOOST_TEST_EQ(sw.max_contiguous(), 88);
+        BOOST_TEST(sw.reserve_contiguous(88));
+        BOOST_TEST(! sw.reserve_contiguous(89));
+        BOOST_TEST(sw.good());
+        BOOST_TEST(sw.pos() == &buff[11]);
+        auto r = sw.finish();
+        BOOST_TEST(! r.truncated);
+        BOOST_TEST_CSTR_EQ(buff, "Hello World");
+    }
+
+    {
+        char buff[8];
+        char buff2[100];
+        boost::basic_cstr_writer<char> sw(buff);
+        write(sw, "Hello World");
+        BOOST_TEST(sw.finish().truncated);
+
+        sw.reset(buff);
+        BOOST_TEST(sw.good());
+        write(sw, "Hello");
+        auto r1 = sw.finish();
+        BOOST_TEST(! r1.truncated);
+        BOOST_TEST_CSTR_EQ(buff, "Hello");
+
+        sw.reset(buff2, sizeof(buff2));
+        BOOST_TEST_EQ(sw.max_contiguous(), 99);
+        write(sw, "Hello World");
+        auto r2 = sw.finish();
+        BOOST_TEST(! r2.truncated);
+        BOOST_TEST_EQ(r2.ptr, &buff2[11]);
+        BOOST_TEST_CSTR_EQ(buff2, "Hello World");
+
+        sw.reset(buff, buff + 4);
+        write(sw, "Hello");
+        auto r3 = sw.finish();
+        BOOST_TEST(r3.truncated);
+        BOOST_TEST_CSTR_EQ(buff, "Hel");
+    }
+
+    {
+        static_assert(decltype(boost::lit("Hello"))::size() == 5, "");
+        static_assert(decltype(boost::lit(u"Hello"))::size() == 5, "");
+
+        char buff[100];
+        boost::basic_cstr_writer<char> sw(buff);
+        write(sw, boost::lit("Hello"));
+        write(sw, boost::lit(""));
+        write(sw, boost::lit(" World"));
+        auto r = sw.finish();
+        BOOST_TEST(! r.truncated);
+        BOOST_TEST_EQ(r.ptr, &buff[11]);
+        BOOST_TEST_CSTR_EQ(buff, "Hello World");
+
+        char buff2[8];
+        sw.reset(buff2);
+        write(sw, boost::lit("Hello World"));
+        auto r2 = sw.finish();
+        BOOST_TEST(r2.truncated);
+        BOOST_TEST_CSTR_EQ(buff2, "Hello W");
+
+        char16_t u16buff[100];
+        boost::basic_cstr_writer<char16_t> u16sw(u16buff);
+        write(u16sw, boost::lit(u"Hello"));
+        BOOST_TEST(! u16sw.finish().truncated);
+        BOOST_TEST(std::u16string(u16buff) == u"Hello");
+    }
+
+    {
+        const std::string world = "World";
+        const char* cstr = "cstr";
+        char buff[100];
+        boost::basic_cstr_writer<char> sw(buff);
+        write_all(sw, boost::lit("Hello"), ' ', world, '/', cstr, "/literal");
+        auto r = sw.finish();
+        BOOST_TEST(! r.truncated);
+        BOOST_TEST_CSTR_EQ(buff, "Hello World/cstr/literal");
+
+        // the pieces that don't fit altogether are written one by one
+        char buff2[10];
+        sw.reset(buff2);
+        write_all(sw, boost::lit("Hello"), ' ', world);
+        auto r2 = sw.finish();
+        BOOST_TEST(r2.truncated);
+        BOOST_TEST_CSTR_EQ(buff2, "Hello Wor");
+
+        char16_t u16buff[100];
+        const std::u16string u16world = u"World";
+        boost::basic_cstr_writer<char16_t> u16sw(u16buff);
+        write_all(u16sw, u"Hello", char16_t(' '), u16world);
+        BOOST_TEST(! u16sw.finish().truncated);
+        BOOST_TEST(std::u16string(u16buff) == u"Hello World");
+    }
+
     return boost::report_errors();
 }
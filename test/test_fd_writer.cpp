@@ -0,0 +1,176 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/core/lightweight_test.hpp>
+#include <boost/outbuf/fd.hpp>
+#include <cstdio>
+#include "test_utils.hpp"
+
+template <typename CharT>
+void test_successfull_writing()
+{
+    auto tiny_str = test_utils::make_tiny_string<CharT>();
+    auto double_str = test_utils::make_double_string<CharT>();
+
+    std::FILE* file = std::tmpfile();
+    boost::basic_fd_writer<CharT> writer(fileno(file));
+    auto expected_content = tiny_str + double_str;
+
+    write(writer, tiny_str.data(), tiny_str.size());
+    write(writer, double_str.data(), double_str.size());
+    auto status = writer.finish();
+    std::rewind(file);
+    auto obtained_content = test_utils::read_file<CharT>(file);
+    std::fclose(file);
+
+    BOOST_TEST(status.success);
+    BOOST_TEST_EQ(status.errnum, 0);
+    BOOST_TEST_EQ(status.count, obtained_content.size() * sizeof(CharT));
+    BOOST_TEST(obtained_content == expected_content);
+}
+
+template <typename CharT>
+void test_buffer_from_pool()
+{
+    auto big_str = test_utils::make_string<CharT>(5000);
+
+    boost::outbuf_buffer_pool pool;
+    std::FILE* file = std::tmpfile();
+    boost::basic_fd_writer<CharT> writer(fileno(file), pool, 1000);
+    BOOST_TEST_EQ(writer.buffer_size(), pool.rounded_size(1000 * sizeof(CharT)) / sizeof(CharT));
+    BOOST_TEST_EQ(reinterpret_cast<std::uintptr_t>(writer.pos()) % pool.alignment, 0);
+    write(writer, big_str.data(), big_str.size());
+    auto status = writer.finish();
+    std::rewind(file);
+    auto obtained_content = test_utils::read_file<CharT>(file);
+    std::fclose(file);
+
+    BOOST_TEST(status.success);
+    BOOST_TEST(obtained_content == big_str);
+}
+
+template <typename CharT>
+void test_small_buffer()
+{
+    const std::size_t buf_size = boost::min_size_after_recycle<CharT>();
+    auto tiny_str = test_utils::make_tiny_string<CharT>();
+    auto half_str = test_utils::make_half_string<CharT>();
+    auto big_str = test_utils::make_string<CharT>(buf_size * 5 + 3);
+
+    std::FILE* file = std::tmpfile();
+    boost::basic_fd_writer<CharT> writer(fileno(file), buf_size);
+    BOOST_TEST_EQ(writer.buffer_size(), buf_size);
+    auto expected_content = tiny_str + half_str + big_str + tiny_str
+                          + big_str.substr(0, buf_size) + tiny_str;
+
+    write(writer, tiny_str.data(), tiny_str.size());
+    write(writer, half_str.data(), half_str.size());
+    write(writer, big_str.data(), big_str.size());   // passthrough
+    BOOST_TEST(writer.pos() + buf_size == writer.end());
+    write(writer, tiny_str.data(), tiny_str.size());
+    write(writer, big_str.data(), buf_size);         // passthrough too
+    BOOST_TEST(writer.pos() + buf_size == writer.end());
+    write(writer, tiny_str.data(), tiny_str.size());
+    auto status = writer.finish();
+    std::rewind(file);
+    auto obtained_content = test_utils::read_file<CharT>(file);
+    std::fclose(file);
+
+    BOOST_TEST(status.success);
+    BOOST_TEST_EQ(status.count, obtained_content.size() * sizeof(CharT));
+    BOOST_TEST(obtained_content == expected_content);
+}
+
+template <typename CharT>
+void test_failing_to_recycle()
+{
+    auto half_str = test_utils::make_half_string<CharT>();
+    auto double_str = test_utils::make_double_string<CharT>();
+    auto expected_content = half_str;
+
+    std::FILE* file = std::tmpfile();
+    boost::basic_fd_writer<CharT> writer(fileno(file));
+
+    write(writer, half_str.data(), half_str.size());
+    writer.recycle(); // first recycle shall work
+    test_utils::turn_into_bad(writer);
+    write(writer, double_str.data(), double_str.size());
+
+    auto status = writer.finish();
+    std::rewind(file);
+    auto obtained_content = test_utils::read_file<CharT>(file);
+    std::fclose(file);
+
+    BOOST_TEST(! status.success);
+    BOOST_TEST_EQ(status.count, obtained_content.size() * sizeof(CharT));
+    BOOST_TEST(obtained_content == expected_content);
+}
+
+template <typename CharT>
+void test_failing_to_finish()
+{
+    auto double_str = test_utils::make_double_string<CharT>();
+    auto half_str = test_utils::make_half_string<CharT>();
+    auto expected_content = double_str;
+
+    std::FILE* file = std::tmpfile();
+    boost::basic_fd_writer<CharT> writer(fileno(file));
+
+    write(writer, double_str.data(), double_str.size());
+    writer.recycle();
+    write(writer, half_str.data(), half_str.size());
+    test_utils::turn_into_bad(writer);
+
+    auto status = writer.finish();
+    std::rewind(file);
+    auto obtained_content = test_utils::read_file<CharT>(file);
+    std::fclose(file);
+
+    BOOST_TEST(! status.success);
+    BOOST_TEST_EQ(status.count, obtained_content.size() * sizeof(CharT));
+    BOOST_TEST(obtained_content == expected_content);
+}
+
+void test_invalid_fd()
+{
+    std::FILE* file = std::tmpfile();
+    int fd = dup(fileno(file));
+    std::fclose(file);
+    close(fd);
+
+    auto str = test_utils::make_double_string<char>();
+    boost::fd_writer writer(fd, boost::min_size_after_recycle<char>());
+    write(writer, str.data(), str.size());
+    BOOST_TEST(! writer.good());
+    auto status = writer.finish();
+
+    BOOST_TEST(! status.success);
+    BOOST_TEST_EQ(status.errnum, EBADF);
+    BOOST_TEST_EQ(status.count, 0);
+}
+
+int main()
+{
+    test_successfull_writing<char>();
+    test_successfull_writing<char16_t>();
+    test_successfull_writing<char32_t>();
+    test_successfull_writing<wchar_t>();
+
+    test_small_buffer<char>();
+    test_small_buffer<char16_t>();
+    test_small_buffer<char32_t>();
+
+    test_buffer_from_pool<char>();
+    test_buffer_from_pool<char32_t>();
+
+    test_failing_to_recycle<char>();
+    test_failing_to_recycle<char32_t>();
+
+    test_failing_to_finish<char>();
+    test_failing_to_finish<char32_t>();
+
+    test_invalid_fd();
+
+    return boost::report_errors();
+}
@@ -0,0 +1,315 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <boost/core/lightweight_test.hpp>
+#include <boost/outbuf/floating_point.hpp>
+#include <boost/outbuf/string.hpp>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+#if defined(__has_include)
+#if __has_include(<charconv>) && __cplusplus >= 201703L
+#include <charconv>
+#if defined(__cpp_lib_to_chars)
+#define HAS_FLOAT_TO_CHARS
+#endif
+#endif
+#endif
+
+std::uint64_t random_bits()
+{
+    std::uint64_t x = 0;
+    for (int i = 0; i < 5; ++i)
+    {
+        x = (x << 15) ^ static_cast<std::uint64_t>(std::rand());
+    }
+    return x;
+}
+
+double random_double()
+{
+    double d;
+    do
+    {
+        std::uint64_t bits = random_bits();
+        std::memcpy(&d, &bits, sizeof(d));
+    }
+    while (d != d || d - d != 0); // not nan nor inf
+    return d;
+}
+
+float random_float()
+{
+    float f;
+    do
+    {
+        auto bits = static_cast<std::uint32_t>(random_bits());
+        std::memcpy(&f, &bits, sizeof(f));
+    }
+    while (f != f || f - f != 0);
+    return f;
+}
+
+template <typename Float>
+std::string shortest(Float value)
+{
+    boost::string_maker sm;
+    boost::detail::write_float_shortest(sm, value);
+    return sm.finish();
+}
+
+// The significant digits of a number in fixed or scientific notation
+std::string significant_digits(const std::string& str)
+{
+    std::string digits;
+    for (char ch: str)
+    {
+        if (ch == 'e')
+        {
+            break;
+        }
+        if (ch >= '0' && ch <= '9' && (ch != '0' || ! digits.empty()))
+        {
+            digits += ch;
+        }
+    }
+    while (! digits.empty() && digits.back() == '0')
+    {
+        digits.pop_back();
+    }
+    return digits;
+}
+
+// Checks that str rounds back to value, and that it is not longer than
+// the shortest correctly rounded value given by printf("%.*e") that rounds
+// back. When they have the same length, they must have the same digits,
+// unless value is a power of two, whose rounding interval is asymmetric.
+template <typename Float>
+void check_shortest(Float value, const std::string& str)
+{
+    const bool is_float = sizeof(Float) == sizeof(float);
+    Float parsed = is_float
+        ? static_cast<Float>(std::strtof(str.c_str(), nullptr))
+        : static_cast<Float>(std::strtod(str.c_str(), nullptr));
+    BOOST_TEST(std::memcmp(&parsed, &value, sizeof(Float)) == 0);
+
+    char buf[64];
+    std::size_t n = 1;
+    for ( ; n < 17; ++n)
+    {
+        std::sprintf(buf, "%.*e", static_cast<int>(n - 1), static_cast<double>(value));
+        Float f = is_float
+            ? static_cast<Float>(std::strtof(buf, nullptr))
+            : static_cast<Float>(std::strtod(buf, nullptr));
+        if (f == value)
+        {
+            break;
+        }
+    }
+    std::sprintf(buf, "%.*e", static_cast<int>(n - 1), static_cast<double>(value));
+    const std::string digits = significant_digits(str);
+    const std::string expected = significant_digits(buf);
+    const boost::detail::float_bits<Float> bits(value);
+    BOOST_TEST(digits.size() <= expected.size());
+    if (bits.significand != 0 && ! BOOST_TEST_EQ(digits, expected))
+    {
+        std::printf("    value: %.17g\n", static_cast<double>(value));
+    }
+
+#if defined(HAS_FLOAT_TO_CHARS)
+
+    // std::to_chars writes the exact digits of large integers in
+    // fixed notation, while the shortest ones are followed by zeros
+    char buf2[64];
+    auto res = std::to_chars(buf2, buf2 + sizeof(buf2), value);
+    const std::string str2(buf2, res.ptr);
+    if (str.find_first_of(".e") == std::string::npos && str.back() == '0')
+    {
+        BOOST_TEST_EQ(str.size(), str2.size());
+    }
+    else
+    {
+        BOOST_TEST_EQ(str, str2);
+    }
+
+#endif
+}
+
+void test_shortest_special_values()
+{
+    const double inf = std::numeric_limits<double>::infinity();
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    BOOST_TEST_EQ(shortest(0.0), "0");
+    BOOST_TEST_EQ(shortest(-0.0), "-0");
+    BOOST_TEST_EQ(shortest(inf), "inf");
+    BOOST_TEST_EQ(shortest(-inf), "-inf");
+    BOOST_TEST_EQ(shortest(nan), "nan");
+    BOOST_TEST_EQ(shortest(1.0), "1");
+    BOOST_TEST_EQ(shortest(-2.5), "-2.5");
+    BOOST_TEST_EQ(shortest(0.1), "0.1");
+    BOOST_TEST_EQ(shortest(0.3), "0.3");
+    BOOST_TEST_EQ(shortest(100.0), "100");
+    BOOST_TEST_EQ(shortest(123456.0), "123456");
+    BOOST_TEST_EQ(shortest(1e5), "1e+05");
+    BOOST_TEST_EQ(shortest(1e-5), "1e-05");
+    BOOST_TEST_EQ(shortest(0.001), "0.001");
+    BOOST_TEST_EQ(shortest(1.5e-4), "0.00015");
+    BOOST_TEST_EQ(shortest(1e23), "1e+23");
+    BOOST_TEST_EQ(shortest(123456789012.0), "123456789012");
+    BOOST_TEST_EQ(shortest(9007199254740993.0), "9007199254740992");
+    BOOST_TEST_EQ(shortest(5e-324), "5e-324");
+    BOOST_TEST_EQ(shortest(2.2250738585072014e-308), "2.2250738585072014e-308");
+    BOOST_TEST_EQ(shortest(1.7976931348623157e308), "1.7976931348623157e+308");
+
+    BOOST_TEST_EQ(shortest(0.0f), "0");
+    BOOST_TEST_EQ(shortest(0.1f), "0.1");
+    BOOST_TEST_EQ(shortest(16777216.0f), "16777216");
+    BOOST_TEST_EQ(shortest(3.4028235e38f), "3.4028235e+38");
+    BOOST_TEST_EQ(shortest(1e-45f), "1e-45");
+    BOOST_TEST_EQ(shortest(-std::numeric_limits<float>::infinity()), "-inf");
+}
+
+void test_shortest_double()
+{
+    for (int i = 0; i < 100000; ++i)
+    {
+        double d = random_double();
+        check_shortest(d, shortest(d));
+    }
+    // powers of two and ten
+    for (int e = -1074; e < 1024; ++e)
+    {
+        double d = std::ldexp(1.0, e);
+        check_shortest(d, shortest(d));
+    }
+    for (int e = -323; e < 309; ++e)
+    {
+        char buf[16];
+        std::sprintf(buf, "1e%d", e);
+        double d = std::strtod(buf, nullptr);
+        check_shortest(d, shortest(d));
+    }
+    // integers
+    for (int i = 0; i < 10000; ++i)
+    {
+        double d = static_cast<double>(random_bits() >> (std::rand() % 64));
+        check_shortest(d, shortest(d));
+    }
+}
+
+void test_shortest_float()
+{
+    for (int i = 0; i < 100000; ++i)
+    {
+        float f = random_float();
+        check_shortest(f, shortest(f));
+    }
+    for (int e = -149; e < 128; ++e)
+    {
+        float f = std::ldexp(1.0f, e);
+        check_shortest(f, shortest(f));
+    }
+}
+
+std::string with_precision(double value, boost::float_notation notation, std::size_t precision)
+{
+    boost::string_maker sm;
+    boost::write_double(sm, value, notation, precision);
+    return sm.finish();
+}
+
+void check_precision(double value, int precision)
+{
+    std::vector<char> buf(2000);
+    std::snprintf(buf.data(), buf.size(), "%.*f", precision, value);
+    BOOST_TEST_EQ(with_precision(value, boost::float_notation::fixed, precision), buf.data());
+    std::snprintf(buf.data(), buf.size(), "%.*e", precision, value);
+    BOOST_TEST_EQ(with_precision(value, boost::float_notation::scientific, precision), buf.data());
+}
+
+void test_precision()
+{
+    const double values[] =
+        { 0.0, -0.0, 1.0, 0.5, 1.5, 2.5, 0.125, 0.375, 9.5, 99.5, 999.9996
+        , 0.1, 0.05, 0.0001, 1e23, 1e-5, 9.999999e-5, 123456.789, 5e-324
+        , 2.2250738585072014e-308, 1.7976931348623157e308, 4503599627370497.5 };
+    for (double d: values)
+    {
+        for (int p = 0; p < 30; ++p)
+        {
+            check_precision(d, p);
+            check_precision(-d, p);
+        }
+        check_precision(d, 400);
+        check_precision(d, 1100);
+    }
+    for (int i = 0; i < 20000; ++i)
+    {
+        double d = random_double();
+        check_precision(d, std::rand() % 40);
+        d = static_cast<double>(std::rand() % 2000000) / 1000.0;
+        check_precision(d, std::rand() % 6);
+    }
+
+    const double inf = std::numeric_limits<double>::infinity();
+    BOOST_TEST_EQ(with_precision(inf, boost::float_notation::fixed, 2), "inf");
+    BOOST_TEST_EQ(with_precision(-inf, boost::float_notation::scientific, 2), "-inf");
+
+    boost::string_maker sm;
+    boost::write_float(sm, 0.1f, boost::float_notation::fixed, 10);
+    BOOST_TEST_EQ(sm.finish(), "0.1000000015");
+}
+
+void test_across_recycle()
+{
+    // string_maker has a buffer of 64 characters
+    for (std::size_t prefix = 30; prefix < 70; ++prefix)
+    {
+        std::string expected(prefix, 'x');
+        expected += "-2.2250738585072014e-308 0.001 3.14159 1.0000e+100";
+        boost::string_maker sm;
+        write(sm, expected.data(), prefix);
+        boost::write_double(sm, -2.2250738585072014e-308);
+        put(sm, ' ');
+        boost::write_double(sm, 0.001);
+        put(sm, ' ');
+        boost::write_double(sm, 3.14159, boost::float_notation::fixed, 5);
+        put(sm, ' ');
+        boost::write_double(sm, 1e100, boost::float_notation::scientific, 4);
+        BOOST_TEST(sm.finish() == expected);
+    }
+}
+
+void test_other_char_types()
+{
+    boost::u16string_maker sm16;
+    boost::write_double(sm16, -1.5e-10);
+    put(sm16, u' ');
+    boost::write_double(sm16, 2.0 / 3.0, boost::float_notation::fixed, 3);
+    BOOST_TEST(sm16.finish() == u"-1.5e-10 0.667");
+
+    boost::u32string_maker sm32;
+    boost::write_float(sm32, 0.25f);
+    put(sm32, U' ');
+    boost::write_double(sm32, 1234.5, boost::float_notation::scientific, 2);
+    BOOST_TEST(sm32.finish() == U"0.25 1.23e+03");
+}
+
+int main()
+{
+    test_shortest_special_values();
+    test_shortest_double();
+    test_shortest_float();
+    test_precision();
+    test_across_recycle();
+    test_other_char_types();
+    return boost::report_errors();
+}
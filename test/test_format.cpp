@@ -0,0 +1,134 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/core/lightweight_test.hpp>
+#include <boost/outbuf/format.hpp>
+#include <boost/outbuf/string.hpp>
+
+#if defined(BOOST_OUTBUF_HAS_FORMAT)
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+
+struct point
+{
+    int x;
+    int y;
+};
+
+template <typename CharT>
+struct boost::formatter<point, CharT>
+{
+    static constexpr bool supports(char spec) noexcept
+    {
+        return spec == '\0';
+    }
+    static std::size_t size(const point&, char) noexcept
+    {
+        return 2 * boost::formatter<int, CharT>::size(0, '\0') + 3;
+    }
+    static CharT* write(CharT* dest, const point& p, char)
+    {
+        *dest++ = static_cast<CharT>('(');
+        dest = boost::formatter<int, CharT>::write(dest, p.x, '\0');
+        *dest++ = static_cast<CharT>(',');
+        dest = boost::formatter<int, CharT>::write(dest, p.y, '\0');
+        *dest++ = static_cast<CharT>(')');
+        return dest;
+    }
+};
+
+void test_basic()
+{
+    {
+        boost::string_maker sm;
+        boost::write_formatted<"id={} name={}\n">(sm, 42, "bob");
+        BOOST_TEST_EQ(sm.finish(), "id=42 name=bob\n");
+    }
+    {
+        boost::string_maker sm;
+        boost::write_formatted<"no fields">(sm);
+        boost::write_formatted<"">(sm);
+        boost::write_formatted<"{}">(sm, '!');
+        boost::write_formatted<"{{}}{{{}}}">(sm, 1);
+        BOOST_TEST_EQ(sm.finish(), "no fields!{}{1}");
+    }
+    {
+        boost::string_maker sm;
+        boost::write_formatted<"{} {} {:x} {:X} {:o} {} {}">
+            ( sm, -5, 0u, 255, 0xABCDu, 8, std::numeric_limits<std::int64_t>::min()
+            , std::numeric_limits<std::uint64_t>::max() );
+        BOOST_TEST_EQ( sm.finish()
+                     , "-5 0 ff ABCD 10 -9223372036854775808 18446744073709551615" );
+    }
+    {
+        boost::string_maker sm;
+        const std::string str = "string";
+        const std::string_view sv = "view";
+        const char* cstr = "cstr";
+        boost::write_formatted<"{}|{}|{}|{}|{}|{}|{}|{}">
+            ( sm, true, false, 0.1, -1.5e-10, 2.5f, str, sv, cstr );
+        BOOST_TEST_EQ(sm.finish(), "true|false|0.1|-1.5e-10|2.5|string|view|cstr");
+    }
+    {
+        boost::string_maker sm;
+        boost::write_formatted<"p = {}, q = {}">(sm, point{1, -2}, point{30, 40});
+        BOOST_TEST_EQ(sm.finish(), "p = (1,-2), q = (30,40)");
+    }
+}
+
+void test_not_enough_space()
+{
+    // string_maker has a buffer of 64 characters,
+    // so some calls take the slower path
+    const std::string long_str(150, 'a');
+    const std::string long_literal =
+        "................................................................"
+        "................................................................";
+    for (std::size_t prefix = 0; prefix < 70; ++prefix)
+    {
+        std::string expected(prefix, 'x');
+        expected += "[123456789:" + long_str + ":3.25:ffffffff]" + long_literal;
+        expected += "<-1>";
+
+        boost::string_maker sm;
+        write(sm, expected.data(), prefix);
+        boost::write_formatted<"[{}:{}:{}:{:x}]">(sm, 123456789, long_str, 3.25, 0xFFFFFFFFu);
+        boost::write_formatted
+            < "................................................................"
+              "................................................................"
+              "<{}>" >(sm, -1);
+        BOOST_TEST(sm.finish() == expected);
+    }
+}
+
+void test_other_char_types()
+{
+    boost::u16string_maker sm16;
+    boost::write_formatted<"{} {:x} {} {}">(sm16, 10, 255, u'c', std::u16string(u"str"));
+    BOOST_TEST(sm16.finish() == u"10 ff c str");
+
+    boost::u32string_maker sm32;
+    boost::write_formatted<"{{{}}} {}">(sm32, 1.0, point{5, 6});
+    BOOST_TEST(sm32.finish() == U"{1} (5,6)");
+}
+
+int main()
+{
+    test_basic();
+    test_not_enough_space();
+    test_other_char_types();
+    return boost::report_errors();
+}
+
+#else
+
+int main()
+{
+    return boost::report_errors();
+}
+
+#endif
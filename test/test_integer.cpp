@@ -0,0 +1,206 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <boost/core/lightweight_test.hpp>
+#include <boost/outbuf/integer.hpp>
+#include <boost/outbuf/string.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <string>
+
+template <typename Int>
+std::string reference_dec(Int value)
+{
+    char buf[40];
+    if (std::numeric_limits<Int>::is_signed)
+    {
+        std::sprintf(buf, "%lld", static_cast<long long>(value));
+    }
+    else
+    {
+        std::sprintf(buf, "%llu", static_cast<unsigned long long>(value));
+    }
+    return buf;
+}
+
+template <typename Int>
+std::string dec(Int value)
+{
+    boost::string_maker sm;
+    boost::write_int(sm, value);
+    return sm.finish();
+}
+
+template <typename UInt>
+std::string udec(UInt value)
+{
+    boost::string_maker sm;
+    boost::write_uint(sm, value);
+    return sm.finish();
+}
+
+template <typename Int>
+void test_int_type()
+{
+    using lim = std::numeric_limits<Int>;
+    const Int values[] = { lim::min(), lim::max(), Int(0), Int(1), Int(9), Int(10)
+                         , Int(99), Int(100), Int(lim::max() / 10)
+                         , Int(lim::max() / 10 + 1), Int(lim::min() + 1) };
+    for (Int v: values)
+    {
+        BOOST_TEST_EQ(dec(v), reference_dec(v));
+    }
+    for (int i = 0; i < 1000; ++i)
+    {
+        auto v = static_cast<Int>( (static_cast<unsigned long long>(std::rand()) << 33)
+                                 ^ (static_cast<unsigned long long>(std::rand()) << 16)
+                                 ^ static_cast<unsigned long long>(std::rand()) );
+        BOOST_TEST_EQ(dec(v), reference_dec(v));
+        // with fewer digits
+        v = static_cast<Int>(v / static_cast<Int>(1 + std::rand() % 100));
+        BOOST_TEST_EQ(dec(v), reference_dec(v));
+    }
+}
+
+template <typename UInt>
+void test_uint_type()
+{
+    using lim = std::numeric_limits<UInt>;
+    UInt v = 1;
+    for (int i = 0; i < lim::digits10; ++i, v = static_cast<UInt>(v * 10))
+    {
+        BOOST_TEST_EQ(udec(v), reference_dec(v));
+        BOOST_TEST_EQ(udec(static_cast<UInt>(v - 1)), reference_dec(static_cast<UInt>(v - 1)));
+    }
+    BOOST_TEST_EQ(udec(lim::max()), reference_dec(lim::max()));
+}
+
+void test_all_widths()
+{
+    test_int_type<signed char>();
+    test_int_type<short>();
+    test_int_type<int>();
+    test_int_type<long>();
+    test_int_type<long long>();
+    test_int_type<unsigned char>();
+    test_int_type<unsigned short>();
+    test_int_type<unsigned>();
+    test_int_type<unsigned long>();
+    test_int_type<unsigned long long>();
+
+    test_uint_type<unsigned char>();
+    test_uint_type<unsigned short>();
+    test_uint_type<unsigned>();
+    test_uint_type<unsigned long>();
+    test_uint_type<unsigned long long>();
+}
+
+void test_width_and_fill()
+{
+    boost::string_maker sm;
+    boost::write_int(sm, 42, 6);
+    put(sm, '|');
+    boost::write_int(sm, -42, 6);
+    put(sm, '|');
+    boost::write_int(sm, -42, 6, '0');
+    put(sm, '|');
+    boost::write_int(sm, -42, 6, '*');
+    put(sm, '|');
+    boost::write_int(sm, 123456, 3);
+    put(sm, '|');
+    boost::write_uint(sm, 7u, 3, '0');
+    put(sm, '|');
+    boost::write_uint(sm, 12345u, 2, '0');
+    BOOST_TEST_EQ(sm.finish(), "    42|   -42|-00042|***-42|123456|007|12345");
+
+    // padding larger than the buffer
+    boost::string_maker sm2;
+    boost::write_int(sm2, -5, 200, '0');
+    boost::write_uint(sm2, 5u, 150);
+    BOOST_TEST(sm2.finish() == "-" + std::string(198, '0') + "5" + std::string(149, ' ') + "5");
+}
+
+void test_hex_and_oct()
+{
+    boost::string_maker sm;
+    boost::write_hex(sm, 0xbeefu);
+    put(sm, ' ');
+    boost::write_hex_upper(sm, 0xbeefu);
+    put(sm, ' ');
+    boost::write_hex(sm, 0);
+    put(sm, ' ');
+    boost::write_hex(sm, 0xAu, 4);
+    put(sm, ' ');
+    boost::write_hex(sm, -1);
+    put(sm, ' ');
+    boost::write_hex(sm, static_cast<signed char>(-1));
+    put(sm, ' ');
+    boost::write_hex(sm, 0xFFFFFFFFFFFFFFFFULL);
+    put(sm, ' ');
+    boost::write_oct(sm, 8);
+    put(sm, ' ');
+    boost::write_oct(sm, 0755u, 5);
+    put(sm, ' ');
+    boost::write_oct(sm, 0xFFFFFFFFFFFFFFFFULL);
+    put(sm, ' ');
+    boost::write_hex(sm, 0x1Fu, 4, ' ');
+    BOOST_TEST_EQ( sm.finish()
+                 , "beef BEEF 0 000a ffffffff ff ffffffffffffffff 10 00755 "
+                   "1777777777777777777777   1f" );
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        unsigned long long v = ( static_cast<unsigned long long>(std::rand()) << 40 )
+                             ^ static_cast<unsigned long long>(std::rand());
+        char buf[40];
+        std::sprintf(buf, "%llx %llo", v, v);
+        boost::string_maker sm2;
+        boost::write_hex(sm2, v);
+        put(sm2, ' ');
+        boost::write_oct(sm2, v);
+        BOOST_TEST_EQ(sm2.finish(), buf);
+    }
+}
+
+void test_across_recycle()
+{
+    // string_maker has a buffer of 64 characters
+    for (std::size_t prefix = 40; prefix < 70; ++prefix)
+    {
+        std::string expected(prefix, 'x');
+        expected += "-9223372036854775808 18446744073709551615";
+        boost::string_maker sm;
+        write(sm, expected.data(), prefix);
+        boost::write_int(sm, std::numeric_limits<long long>::min());
+        put(sm, ' ');
+        boost::write_uint(sm, std::numeric_limits<unsigned long long>::max());
+        BOOST_TEST(sm.finish() == expected);
+    }
+}
+
+void test_other_char_types()
+{
+    boost::u16string_maker sm16;
+    boost::write_int(sm16, -1234567);
+    put(sm16, u' ');
+    boost::write_hex(sm16, 0xABCu, 5, u' ');
+    BOOST_TEST(sm16.finish() == u"-1234567   abc");
+
+    boost::u32string_maker sm32;
+    boost::write_uint(sm32, 4294967295u, 12, U'0');
+    BOOST_TEST(sm32.finish() == U"004294967295");
+}
+
+int main()
+{
+    test_all_widths();
+    test_width_and_fill();
+    test_hex_and_oct();
+    test_across_recycle();
+    test_other_char_types();
+    return boost::report_errors();
+}
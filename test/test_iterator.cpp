@@ -0,0 +1,150 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/core/lightweight_test.hpp>
+#include <boost/outbuf/iterator.hpp>
+#include <boost/outbuf/string.hpp>
+#include <algorithm>
+#include <cctype>
+#include <string>
+#include <vector>
+
+template <typename OutIt>
+OutIt write_pieces(OutIt it, const std::string& str)
+{
+    // Copies str one piece at a time, as formatting
+    // libraries do with their internal buffers.
+    std::size_t i = 0;
+    while (i < str.size())
+    {
+        std::size_t n = std::min<std::size_t>(7, str.size() - i);
+        it = std::copy(str.data() + i, str.data() + i + n, it);
+        i += n;
+    }
+    return it;
+}
+
+void test_std_copy()
+{
+    std::string input(1000, 'x');
+    for (std::size_t i = 0; i < input.size(); ++i)
+    {
+        input[i] = static_cast<char>('a' + i % 26);
+    }
+    boost::string_maker sm;
+    {
+        boost::outbuf_iterator<char> it{sm};
+        std::copy(input.begin(), input.end(), it);
+    }
+    BOOST_TEST(sm.finish() == input);
+}
+
+void test_std_transform()
+{
+    std::string input(500, 'a');
+    std::string expected(500, 'A');
+    boost::string_maker sm;
+    write(sm, "<");
+    {
+        boost::outbuf_iterator<char> it{sm};
+        std::transform
+            ( input.begin(), input.end(), it
+            , [](char ch){ return static_cast<char>(std::toupper(ch)); } );
+    }
+    write(sm, ">");
+    BOOST_TEST(sm.finish() == "<" + expected + ">");
+}
+
+void test_copied_iterators()
+{
+    std::string input(300, 'x');
+    for (std::size_t i = 0; i < input.size(); ++i)
+    {
+        input[i] = static_cast<char>('0' + i % 10);
+    }
+    boost::string_maker sm;
+    {
+        boost::outbuf_iterator<char> it{sm};
+        it = 'a';
+        boost::outbuf_iterator<char> it2 = it;
+        it2 = 'b';
+        it = it2;
+        it = 'c';
+        auto it3 = write_pieces(it, input);
+        it3 = 'd';
+        it = it3;
+        it = 'e';
+    }
+    BOOST_TEST(sm.finish() == "abc" + input + "de");
+}
+
+void test_boost_copy()
+{
+    std::string input(200, 'x');
+    for (std::size_t i = 0; i < input.size(); ++i)
+    {
+        input[i] = static_cast<char>('A' + i % 26);
+    }
+    std::vector<char> vec(input.begin(), input.end());
+    const char* cstr = input.c_str();
+    boost::string_maker sm;
+    {
+        boost::outbuf_iterator<char> it{sm};
+        using std::copy;
+        it = copy(cstr, cstr + input.size(), it);
+        it = copy(&vec[0], &vec[0] + vec.size(), it);
+        it = copy(vec.begin(), vec.end(), it);
+        it = copy(input.rbegin(), input.rend(), it);
+    }
+    std::string reversed(input.rbegin(), input.rend());
+    BOOST_TEST(sm.finish() == input + input + input + reversed);
+}
+
+void test_underlying_outbuf_iterator()
+{
+    std::u16string input(200, u'x');
+    for (std::size_t i = 0; i < input.size(); ++i)
+    {
+        input[i] = static_cast<char16_t>(u'a' + i % 26);
+    }
+    boost::u16string_maker sm;
+    {
+        boost::underlying_outbuf_iterator<2> it{sm.as_underlying()};
+        std::copy(input.begin(), input.end(), it);
+        std::fill_n(it, 100, u'z');
+    }
+    BOOST_TEST(sm.finish() == input + std::u16string(100, u'z'));
+}
+
+#if defined(__cpp_lib_ranges)
+
+static_assert(std::output_iterator<boost::outbuf_iterator<char>, char>, "");
+static_assert(std::output_iterator<boost::underlying_outbuf_iterator<2>, char16_t>, "");
+
+void test_ranges_copy()
+{
+    std::string input(200, 'x');
+    for (std::size_t i = 0; i < input.size(); ++i)
+    {
+        input[i] = static_cast<char>('A' + i % 26);
+    }
+    boost::string_maker sm;
+    std::ranges::copy(input, boost::outbuf_iterator<char>{sm});
+    BOOST_TEST(sm.finish() == input);
+}
+
+#endif // defined(__cpp_lib_ranges)
+
+int main()
+{
+    test_std_copy();
+    test_std_transform();
+    test_copied_iterators();
+    test_boost_copy();
+    test_underlying_outbuf_iterator();
+#if defined(__cpp_lib_ranges)
+    test_ranges_copy();
+#endif
+    return boost::report_errors();
+}
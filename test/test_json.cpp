@@ -0,0 +1,116 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/core/lightweight_test.hpp>
+#include <boost/outbuf/json.hpp>
+#include <boost/outbuf/string.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+std::string reference_escape(const std::string& str)
+{
+    std::string result;
+    for (char c: str)
+    {
+        unsigned char ch = static_cast<unsigned char>(c);
+        switch (ch)
+        {
+            case '"':  result += "\\\""; break;
+            case '\\': result += "\\\\"; break;
+            case '\b': result += "\\b"; break;
+            case '\f': result += "\\f"; break;
+            case '\n': result += "\\n"; break;
+            case '\r': result += "\\r"; break;
+            case '\t': result += "\\t"; break;
+            default:
+                if (ch < 0x20)
+                {
+                    char buf[8];
+                    std::sprintf(buf, "\\u%04x", ch);
+                    result += buf;
+                }
+                else
+                {
+                    result += c;
+                }
+        }
+    }
+    return result;
+}
+
+std::string escape(const std::string& str)
+{
+    boost::string_maker sm;
+    boost::write_json_escaped(sm, str.data(), str.size());
+    return sm.finish();
+}
+
+void test_simple_strings()
+{
+    BOOST_TEST_EQ(escape(""), "");
+    BOOST_TEST_EQ(escape("abc"), "abc");
+    BOOST_TEST_EQ(escape("\"quoted\""), "\\\"quoted\\\"");
+    BOOST_TEST_EQ(escape("a\\b"), "a\\\\b");
+    BOOST_TEST_EQ(escape("line 1\nline 2\r\n\ttab"), "line 1\\nline 2\\r\\n\\ttab");
+    BOOST_TEST_EQ(escape(std::string("\0\x01\x1F\x7F", 4)), "\\u0000\\u0001\\u001f\x7F");
+    BOOST_TEST_EQ(escape("\b\f"), "\\b\\f");
+    BOOST_TEST_EQ(escape("ol\xC3\xA1"), "ol\xC3\xA1");
+
+    boost::string_maker sm;
+    boost::write_json_escaped(sm, "say \"hi\"");
+    BOOST_TEST_EQ(sm.finish(), "say \\\"hi\\\"");
+}
+
+void test_all_characters()
+{
+    for (int i = 0; i < 256; ++i)
+    {
+        for (std::size_t pos = 0; pos < 70; ++pos)
+        {
+            std::string str(70, 'x');
+            str[pos] = static_cast<char>(i);
+            BOOST_TEST(escape(str) == reference_escape(str));
+        }
+    }
+}
+
+void test_escapes_across_recycle()
+{
+    // string_maker has a buffer of 64 characters, so
+    // the escape sequences straddle the recycle boundary
+    for (std::size_t prefix = 55; prefix < 70; ++prefix)
+    {
+        std::string str(prefix, 'a');
+        str += "\x01\"\x02\\\x03";
+        str += std::string(100, 'b');
+        BOOST_TEST(escape(str) == reference_escape(str));
+    }
+}
+
+void test_random_strings()
+{
+    const char chars[] = "abcdefgh \"\\\n\t\x01\x1F\x80\xFF";
+    for (int i = 0; i < 500; ++i)
+    {
+        std::string str(std::rand() % 300, 'x');
+        for (auto& ch: str)
+        {
+            if (std::rand() % 8 == 0)
+            {
+                ch = chars[std::rand() % (sizeof(chars) - 1)];
+            }
+        }
+        BOOST_TEST(escape(str) == reference_escape(str));
+    }
+}
+
+int main()
+{
+    test_simple_strings();
+    test_all_characters();
+    test_escapes_across_recycle();
+    test_random_strings();
+    return boost::report_errors();
+}
@@ -0,0 +1,217 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/core/lightweight_test.hpp>
+#include <boost/outbuf/mmap.hpp>
+#include <cstdio>
+#include "test_utils.hpp"
+
+template <typename CharT>
+void test_successfull_writing()
+{
+    auto tiny_str = test_utils::make_tiny_string<CharT>();
+    auto double_str = test_utils::make_double_string<CharT>();
+
+    std::FILE* file = std::tmpfile();
+    boost::basic_mmap_file_writer<CharT> writer(fileno(file));
+    auto expected_content = tiny_str + double_str;
+
+    write(writer, tiny_str.data(), tiny_str.size());
+    write(writer, double_str.data(), double_str.size());
+    auto status = writer.finish();
+    const auto file_offset = ::lseek(fileno(file), 0, SEEK_CUR);
+    std::rewind(file);
+    auto obtained_content = test_utils::read_file<CharT>(file);
+    std::fclose(file);
+
+    BOOST_TEST(status.success);
+    BOOST_TEST_EQ(status.errnum, 0);
+    BOOST_TEST_EQ(status.count, expected_content.size() * sizeof(CharT));
+    BOOST_TEST_EQ(file_offset, static_cast<::off_t>(status.count));
+    BOOST_TEST(obtained_content == expected_content);
+}
+
+template <typename CharT>
+void test_small_window()
+{
+    std::FILE* file = std::tmpfile();
+    boost::basic_mmap_file_writer<CharT> writer(fileno(file), 1);
+    const std::size_t window_size = writer.window_size();
+    BOOST_TEST_GE(window_size * sizeof(CharT), 2 * 4096);
+    BOOST_TEST_GE(writer.max_contiguous(), boost::min_size_after_recycle<CharT>());
+    BOOST_TEST_LT(writer.max_contiguous(), window_size);
+
+    auto half_str = test_utils::make_half_string<CharT>();
+    auto big_str = test_utils::make_string<CharT>(window_size * 3 + 7);
+    auto expected_content = half_str + big_str + half_str;
+
+    write(writer, half_str.data(), half_str.size());
+    write(writer, big_str.data(), big_str.size());
+    BOOST_TEST(writer.reserve_contiguous(writer.max_contiguous()));
+    write(writer, half_str.data(), half_str.size());
+    auto status = writer.finish();
+    std::rewind(file);
+    auto obtained_content = test_utils::read_file<CharT>(file);
+    std::fclose(file);
+
+    BOOST_TEST(status.success);
+    BOOST_TEST_EQ(status.count, expected_content.size() * sizeof(CharT));
+    BOOST_TEST(obtained_content == expected_content);
+}
+
+void test_writing_at_offset()
+{
+    auto initial_content = test_utils::make_string<char>(10000);
+    auto str = test_utils::make_string<char>(300);
+    {
+        // overwrites part of the content
+        std::FILE* file = std::tmpfile();
+        std::fwrite(initial_content.data(), 1, initial_content.size(), file);
+        std::fflush(file);
+        ::lseek(fileno(file), 5000, SEEK_SET);
+        boost::mmap_file_writer writer(fileno(file));
+        write(writer, str.data(), str.size());
+        auto status = writer.finish();
+        std::rewind(file);
+        auto obtained_content = test_utils::read_file<char>(file);
+        std::fclose(file);
+
+        auto expected_content = initial_content;
+        expected_content.replace(5000, str.size(), str);
+        BOOST_TEST(status.success);
+        BOOST_TEST_EQ(status.count, str.size());
+        BOOST_TEST(obtained_content == expected_content);
+    }
+    {
+        // goes beyond the end
+        std::FILE* file = std::tmpfile();
+        std::fwrite(initial_content.data(), 1, initial_content.size(), file);
+        std::fflush(file);
+        ::lseek(fileno(file), 9900, SEEK_SET);
+        boost::mmap_file_writer writer(fileno(file));
+        write(writer, str.data(), str.size());
+        auto status = writer.finish();
+        std::rewind(file);
+        auto obtained_content = test_utils::read_file<char>(file);
+        std::fclose(file);
+
+        auto expected_content = initial_content.substr(0, 9900) + str;
+        BOOST_TEST(status.success);
+        BOOST_TEST(obtained_content == expected_content);
+    }
+}
+
+void test_destroyed_without_finish()
+{
+    auto half_str = test_utils::make_half_string<char>();
+    std::FILE* file = std::tmpfile();
+    {
+        boost::mmap_file_writer writer(fileno(file));
+        write(writer, half_str.data(), half_str.size());
+        writer.recycle();
+        write(writer, half_str.data(), half_str.size());
+    }
+    std::rewind(file);
+    auto obtained_content = test_utils::read_file<char>(file);
+    std::fclose(file);
+
+    // the content written after the last recycle() is discarded,
+    // and the file is not left extended
+    BOOST_TEST(obtained_content == half_str);
+}
+
+template <typename CharT>
+void test_failing_to_recycle()
+{
+    auto half_str = test_utils::make_half_string<CharT>();
+    auto double_str = test_utils::make_double_string<CharT>();
+    auto expected_content = half_str;
+
+    std::FILE* file = std::tmpfile();
+    boost::basic_mmap_file_writer<CharT> writer(fileno(file));
+
+    write(writer, half_str.data(), half_str.size());
+    writer.recycle(); // first recycle shall work
+    test_utils::turn_into_bad(writer);
+    write(writer, double_str.data(), double_str.size());
+    writer.recycle();
+    write(writer, double_str.data(), double_str.size());
+
+    auto status = writer.finish();
+    std::rewind(file);
+    auto obtained_content = test_utils::read_file<CharT>(file);
+    std::fclose(file);
+
+    BOOST_TEST(! status.success);
+    BOOST_TEST_EQ(status.count, obtained_content.size() * sizeof(CharT));
+    BOOST_TEST(obtained_content == expected_content);
+}
+
+template <typename CharT>
+void test_failing_to_finish()
+{
+    auto double_str = test_utils::make_double_string<CharT>();
+    auto half_str = test_utils::make_half_string<CharT>();
+    auto expected_content = double_str;
+
+    std::FILE* file = std::tmpfile();
+    boost::basic_mmap_file_writer<CharT> writer(fileno(file));
+
+    write(writer, double_str.data(), double_str.size());
+    writer.recycle();
+    write(writer, half_str.data(), half_str.size());
+    test_utils::turn_into_bad(writer);
+
+    auto status = writer.finish();
+    std::rewind(file);
+    auto obtained_content = test_utils::read_file<CharT>(file);
+    std::fclose(file);
+
+    BOOST_TEST(! status.success);
+    BOOST_TEST_EQ(status.count, obtained_content.size() * sizeof(CharT));
+    BOOST_TEST(obtained_content == expected_content);
+}
+
+void test_invalid_fd()
+{
+    std::FILE* file = std::tmpfile();
+    int fd = dup(fileno(file));
+    std::fclose(file);
+    close(fd);
+
+    auto str = test_utils::make_double_string<char>();
+    boost::mmap_file_writer writer(fd);
+    BOOST_TEST(! writer.good());
+    write(writer, str.data(), str.size());
+    auto status = writer.finish();
+
+    BOOST_TEST(! status.success);
+    BOOST_TEST_EQ(status.errnum, EBADF);
+    BOOST_TEST_EQ(status.count, 0);
+}
+
+int main()
+{
+    test_successfull_writing<char>();
+    test_successfull_writing<char16_t>();
+    test_successfull_writing<char32_t>();
+    test_successfull_writing<wchar_t>();
+
+    test_small_window<char>();
+    test_small_window<char16_t>();
+    test_small_window<char32_t>();
+
+    test_writing_at_offset();
+    test_destroyed_without_finish();
+
+    test_failing_to_recycle<char>();
+    test_failing_to_recycle<char32_t>();
+
+    test_failing_to_finish<char>();
+    test_failing_to_finish<char32_t>();
+
+    test_invalid_fd();
+
+    return boost::report_errors();
+}
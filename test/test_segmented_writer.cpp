@@ -0,0 +1,134 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/core/lightweight_test.hpp>
+#include <boost/outbuf/segmented.hpp>
+#include <boost/outbuf/string.hpp>
+#include <cstdio>
+#include "test_utils.hpp"
+
+template <typename CharT>
+void test_successfull_writing()
+{
+    auto tiny_str = test_utils::make_tiny_string<CharT>();
+    auto big_str = test_utils::make_string<CharT>(1000);
+    auto expected_content = tiny_str + big_str + tiny_str;
+
+    boost::basic_segmented_writer<CharT> writer(100);
+    BOOST_TEST_EQ(writer.segment_size(), 100);
+    BOOST_TEST_EQ(writer.max_contiguous(), 100);
+    BOOST_TEST_EQ(writer.segments_count(), 1);
+
+    write(writer, tiny_str.data(), tiny_str.size());
+    write(writer, big_str.data(), big_str.size());
+    writer.recycle();
+    writer.recycle(); // the current segment is empty, so it is kept
+    write(writer, tiny_str.data(), tiny_str.size());
+    auto status = writer.finish();
+
+    BOOST_TEST(status.success);
+    BOOST_TEST_EQ(status.count, expected_content.size());
+    BOOST_TEST_EQ(writer.count(), expected_content.size());
+    BOOST_TEST_EQ(writer.segments_count(), 12);
+    BOOST_TEST(writer.to_string() == expected_content);
+
+    boost::basic_string_maker<CharT> copy;
+    writer.copy_to(copy);
+    BOOST_TEST(copy.finish() == expected_content);
+}
+
+void test_small_segment_size()
+{
+    boost::segmented_writer writer(1);
+    BOOST_TEST_EQ(writer.segment_size(), boost::min_size_after_recycle<char>());
+}
+
+void test_clear()
+{
+    auto str1 = test_utils::make_string<char>(500);
+    auto str2 = test_utils::make_string<char>(250);
+
+    boost::segmented_writer writer(100);
+    write(writer, str1.data(), str1.size());
+    writer.finish();
+    BOOST_TEST_EQ(writer.segments_count(), 5);
+
+    writer.clear();
+    BOOST_TEST(writer.good());
+    BOOST_TEST_EQ(writer.count(), 0);
+    BOOST_TEST_EQ(writer.segments_count(), 1);
+    BOOST_TEST(writer.to_string().empty());
+
+    write(writer, str2.data(), str2.size());
+    auto status = writer.finish();
+    BOOST_TEST(status.success);
+    BOOST_TEST_EQ(status.count, str2.size());
+    BOOST_TEST_EQ(writer.segments_count(), 3);
+    BOOST_TEST(writer.to_string() == str2);
+}
+
+template <typename CharT>
+void test_failing_to_finish()
+{
+    auto double_str = test_utils::make_double_string<CharT>();
+    auto half_str = test_utils::make_half_string<CharT>();
+
+    boost::basic_segmented_writer<CharT> writer;
+    write(writer, double_str.data(), double_str.size());
+    writer.recycle();
+    write(writer, half_str.data(), half_str.size());
+    test_utils::turn_into_bad(writer);
+
+    auto status = writer.finish();
+    BOOST_TEST(! status.success);
+    BOOST_TEST_EQ(status.count, double_str.size());
+    BOOST_TEST(writer.to_string() == double_str);
+}
+
+#if defined(BOOST_OUTBUF_HAS_IOVEC)
+
+template <typename CharT>
+void test_iovecs()
+{
+    auto str = test_utils::make_string<CharT>(1000);
+
+    boost::basic_segmented_writer<CharT> writer(300);
+    write(writer, str.data(), str.size());
+    writer.recycle(); // the last segment is empty
+    writer.finish();
+
+    auto iov = writer.iovecs();
+    BOOST_TEST_EQ(iov.size(), 4);
+    std::FILE* file = std::tmpfile();
+    auto n = ::writev(fileno(file), iov.data(), static_cast<int>(iov.size()));
+    std::rewind(file);
+    auto obtained_content = test_utils::read_file<CharT>(file);
+    std::fclose(file);
+
+    BOOST_TEST_EQ(n, static_cast<::ssize_t>(str.size() * sizeof(CharT)));
+    BOOST_TEST(obtained_content == str);
+}
+
+#endif // defined(BOOST_OUTBUF_HAS_IOVEC)
+
+int main()
+{
+    test_successfull_writing<char>();
+    test_successfull_writing<char16_t>();
+    test_successfull_writing<char32_t>();
+    test_successfull_writing<wchar_t>();
+    test_small_segment_size();
+    test_clear();
+    test_failing_to_finish<char>();
+    test_failing_to_finish<char32_t>();
+
+#if defined(BOOST_OUTBUF_HAS_IOVEC)
+
+    test_iovecs<char>();
+    test_iovecs<char16_t>();
+
+#endif
+
+    return boost::report_errors();
+}
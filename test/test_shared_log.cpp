@@ -0,0 +1,204 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/core/lightweight_test.hpp>
+#include <boost/outbuf/shared_log.hpp>
+#include <boost/outbuf/string.hpp>
+#include <vector>
+#include "test_utils.hpp"
+
+void test_single_thread()
+{
+    auto tiny_str = test_utils::make_tiny_string<char>();
+    auto double_str = test_utils::make_double_string<char>();
+    auto expected_content = tiny_str + double_str + tiny_str;
+
+    boost::string_maker dest;
+    boost::shared_log_sink sink(dest, 4096);
+    BOOST_TEST_EQ(sink.max_record_size(), 2048);
+    {
+        boost::shared_log_writer writer(sink, 100);
+        BOOST_TEST_EQ(writer.buffer_size(), 100);
+        write(writer, tiny_str.data(), tiny_str.size());
+        writer.commit();
+        write(writer, double_str.data(), double_str.size());
+        writer.commit();
+        writer.commit(); // nothing to push
+        write(writer, tiny_str.data(), tiny_str.size());
+        writer.commit();
+        write(writer, tiny_str.data(), tiny_str.size()); // not committed
+    }
+    auto status = sink.finish();
+
+    BOOST_TEST(status.success);
+    BOOST_TEST_EQ(status.count, expected_content.size());
+    BOOST_TEST_EQ(sink.records_count(), 3);
+    BOOST_TEST(dest.finish() == expected_content);
+}
+
+void test_records_never_interleave()
+{
+    // Many threads write records of different sizes into a small ring,
+    // so that it wraps around and gets full many times.
+    const unsigned threads_count = 8;
+    const unsigned records_per_thread = 500;
+
+    boost::string_maker dest;
+    boost::shared_log_sink sink(dest, 4096);
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < threads_count; ++t)
+    {
+        threads.emplace_back([&sink, t]{
+                boost::shared_log_writer writer(sink, 64);
+                for (unsigned i = 0; i < records_per_thread; ++i)
+                {
+                    const std::size_t filler_size = (i * 37 + t * 11) % 300;
+                    put(writer, static_cast<char>('A' + t));
+                    write(writer, std::to_string(i).c_str());
+                    put(writer, ':');
+                    for (std::size_t j = 0; j < filler_size; ++j)
+                    {
+                        put(writer, static_cast<char>('A' + t));
+                    }
+                    put(writer, '\n');
+                    writer.commit();
+                }
+            });
+    }
+    for (auto& th : threads)
+    {
+        th.join();
+    }
+    auto status = sink.finish();
+    auto content = dest.finish();
+
+    BOOST_TEST(status.success);
+    BOOST_TEST_EQ(status.count, content.size());
+    BOOST_TEST_EQ(sink.records_count(), threads_count * records_per_thread);
+
+    std::vector<unsigned> next_index(threads_count, 0);
+    std::size_t line_begin = 0;
+    while (line_begin < content.size())
+    {
+        const auto line_end = content.find('\n', line_begin);
+        if ( ! BOOST_TEST_NE(line_end, std::string::npos))
+        {
+            break;
+        }
+        const unsigned t = static_cast<unsigned>(content[line_begin] - 'A');
+        if ( ! BOOST_TEST_LT(t, threads_count))
+        {
+            break;
+        }
+        const unsigned i = next_index[t]++;
+        const std::size_t filler_size = (i * 37 + t * 11) % 300;
+        std::string expected_line(1, static_cast<char>('A' + t));
+        expected_line += std::to_string(i);
+        expected_line += ':';
+        expected_line.append(filler_size, static_cast<char>('A' + t));
+        BOOST_TEST(content.compare(line_begin, line_end - line_begin, expected_line) == 0);
+        line_begin = line_end + 1;
+    }
+    for (unsigned t = 0; t < threads_count; ++t)
+    {
+        BOOST_TEST_EQ(next_index[t], records_per_thread);
+    }
+}
+
+void test_large_records()
+{
+    // A record that does not fit in the writer's buffer is moved into
+    // a larger one, unless it is longer than max_record_size(),
+    // in which case it is split.
+    auto str1 = test_utils::make_string<char>(1500);
+    auto str2 = test_utils::make_string<char>(5000);
+
+    boost::string_maker dest;
+    boost::shared_log_sink sink(dest, 4096);
+    boost::shared_log_writer writer(sink, 100);
+    write(writer, str1.data(), str1.size());
+    writer.commit();
+    BOOST_TEST_EQ(writer.buffer_size(), 1600);
+    write(writer, str2.data(), str2.size());
+    writer.commit();
+    BOOST_TEST_EQ(writer.buffer_size(), sink.max_record_size());
+    auto status = sink.finish();
+
+    BOOST_TEST(status.success);
+    BOOST_TEST_EQ(sink.records_count(), 1 + 3);
+    BOOST_TEST(dest.finish() == str1 + str2);
+}
+
+// An outbuf that fails on the first recycle()
+class failing_dest final: public boost::basic_outbuf<char>
+{
+public:
+
+    failing_dest()
+        : boost::basic_outbuf<char>(_buf, sizeof(_buf))
+    {
+    }
+
+    void recycle() override
+    {
+        this->set_good(false);
+        this->set_pos(boost::outbuf_garbage_buf<char>());
+        this->set_end(boost::outbuf_garbage_buf_end<char>());
+    }
+
+private:
+
+    char _buf[boost::min_size_after_recycle<char>()];
+};
+
+void test_failing_dest()
+{
+    auto str = test_utils::make_string<char>(50);
+    failing_dest dest;
+    boost::shared_log_sink sink(dest);
+    boost::shared_log_writer writer(sink);
+    for (int i = 0; i < 4; ++i)
+    {
+        write(writer, str.data(), str.size());
+        writer.commit();
+    }
+    auto status = sink.finish();
+
+    BOOST_TEST(! status.success);
+    BOOST_TEST_EQ(status.count, str.size());
+    BOOST_TEST_EQ(sink.records_count(), 4);
+}
+
+void test_commit_after_finish()
+{
+    auto str = test_utils::make_string<char>(100);
+    boost::string_maker dest;
+    boost::shared_log_sink sink(dest);
+    boost::shared_log_writer writer(sink);
+    write(writer, str.data(), str.size());
+    writer.commit();
+    auto status = sink.finish();
+    BOOST_TEST(writer.good());
+
+    write(writer, str.data(), str.size());
+    writer.commit();
+    BOOST_TEST(! writer.good());
+    write(writer, str.data(), str.size());
+    writer.commit();
+
+    BOOST_TEST(status.success);
+    BOOST_TEST_EQ(status.count, str.size());
+    BOOST_TEST(dest.finish() == str);
+}
+
+int main()
+{
+    test_single_thread();
+    test_records_never_interleave();
+    test_large_records();
+    test_failing_dest();
+    test_commit_after_finish();
+
+    return boost::report_errors();
+}
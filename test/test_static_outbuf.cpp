@@ -0,0 +1,304 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/core/lightweight_test.hpp>
+#include <boost/outbuf/static.hpp>
+#include <boost/outbuf/string.hpp>
+#include "test_utils.hpp"
+
+// Appends to a string through a small buffer
+template <typename CharT>
+class small_static_string_writer final
+    : public boost::static_outbuf<small_static_string_writer<CharT>, CharT>
+{
+    using _base = boost::static_outbuf<small_static_string_writer<CharT>, CharT>;
+
+public:
+
+    small_static_string_writer()
+        : _base(_buf, _buf_size)
+    {
+    }
+
+    void recycle()
+    {
+        _str.append(_buf, this->pos());
+        ++_recycle_count;
+        this->set_pos(_buf);
+    }
+
+    std::basic_string<CharT> finish()
+    {
+        _str.append(_buf, this->pos());
+        this->set_pos(_buf);
+        this->set_good(false);
+        return _str;
+    }
+
+    int recycle_count() const
+    {
+        return _recycle_count;
+    }
+
+private:
+
+    static constexpr std::size_t _buf_size
+        = boost::min_size_after_recycle<CharT>();
+    CharT _buf[_buf_size];
+    std::basic_string<CharT> _str;
+    int _recycle_count = 0;
+};
+
+template <typename CharT>
+constexpr std::size_t small_static_string_writer<CharT>::_buf_size;
+
+// A serializer that is template on the output buffer type
+template <typename Outbuf, typename CharT>
+void write_twice( Outbuf& dest
+                , const std::basic_string<CharT>& str
+                , CharT separator )
+{
+    write(dest, str.data(), str.size());
+    put(dest, separator);
+    write(dest, str.data(), str.data() + str.size());
+}
+
+void write_hello(boost::outbuf& dest)
+{
+    write(dest, "Hello");
+}
+
+template <typename CharT>
+void test_crtp_writer()
+{
+    auto str = test_utils::make_string<CharT>(200);
+    auto expected = str + CharT('/') + str;
+
+    small_static_string_writer<CharT> writer;
+    BOOST_TEST(writer.good());
+    BOOST_TEST_EQ(writer.size(), boost::min_size_after_recycle<CharT>());
+    write_twice(writer, str, CharT('/'));
+    writer.require(10);
+    BOOST_TEST(writer.size() >= 10);
+    BOOST_TEST(writer.recycle_count() > 0);
+    BOOST_TEST(writer.finish() == expected);
+}
+
+template <typename CharT>
+void test_cstr_writer_ref()
+{
+    auto str = test_utils::make_string<CharT>(20);
+    auto expected = str + CharT('/') + str;
+    CharT buff[100];
+    boost::basic_cstr_writer<CharT> writer(buff);
+    write(writer, str.data(), 5);
+    {
+        boost::static_outbuf_ref<boost::basic_cstr_writer<CharT>> ref(writer);
+        BOOST_TEST(ref.pos() == buff + 5);
+        BOOST_TEST(&ref.writer() == &writer);
+        write(ref, str.data() + 5, str.size() - 5);
+        put(ref, CharT('/'));
+        write(ref, str.data(), str.size());
+        BOOST_TEST(ref.good());
+    }
+    // the position is passed back to the writer
+    BOOST_TEST(writer.pos() == buff + expected.size());
+    auto res = writer.finish();
+    BOOST_TEST(! res.truncated);
+    BOOST_TEST(std::basic_string<CharT>(buff, res.ptr) == expected);
+}
+
+template <typename CharT>
+void test_cstr_writer_ref_truncated()
+{
+    auto str = test_utils::make_string<CharT>(200);
+    CharT buff[50];
+    boost::basic_cstr_writer<CharT> writer(buff);
+    {
+        boost::static_outbuf_ref<boost::basic_cstr_writer<CharT>> ref(writer);
+        write_twice(ref, str, CharT('/'));
+        BOOST_TEST(! ref.good());
+    }
+    auto res = writer.finish();
+    BOOST_TEST(res.truncated);
+    BOOST_TEST(std::basic_string<CharT>(buff, res.ptr) == str.substr(0, 49));
+}
+
+template <typename CharT>
+void test_string_maker_ref()
+{
+    auto str = test_utils::make_string<CharT>(500);
+    auto expected = str + CharT('/') + str;
+    boost::basic_string_maker<CharT> writer;
+    {
+        boost::static_outbuf_ref<boost::basic_string_maker<CharT>> ref(writer);
+        write_twice(ref, str, CharT('/'));
+    }
+    BOOST_TEST(writer.finish() == expected);
+}
+
+template <typename CharT>
+void test_abstract_ref()
+{
+    // recycle() is called through virtual dispatch
+    auto str = test_utils::make_string<CharT>(500);
+    auto expected = str + CharT('/') + str;
+    boost::basic_string_maker<CharT> writer;
+    boost::basic_outbuf<CharT>& ob = writer;
+    {
+        boost::static_outbuf_ref<boost::basic_outbuf<CharT>> ref(ob);
+        write_twice(ref, str, CharT('/'));
+    }
+    BOOST_TEST(writer.finish() == expected);
+}
+
+template <typename CharT>
+void test_write_all()
+{
+    // small_static_string_writer recycles several times
+    auto str = test_utils::make_string<CharT>(50);
+    std::basic_string<CharT> expected;
+    small_static_string_writer<CharT> writer;
+    for (int i = 0; i < 10; ++i)
+    {
+        write_all(writer, str, CharT('/'), str, CharT('\n'));
+        expected += str + CharT('/') + str + CharT('\n');
+    }
+    BOOST_TEST(writer.recycle_count() > 0);
+    BOOST_TEST(writer.finish() == expected);
+}
+
+// A concrete writer that is not final
+class base_string_writer: public boost::outbuf
+{
+public:
+
+    base_string_writer()
+        : boost::outbuf(_buf, sizeof(_buf))
+    {
+    }
+
+    void recycle() override
+    {
+        _str.append(_buf, this->pos());
+        this->set_pos(_buf);
+    }
+
+    std::string finish()
+    {
+        recycle();
+        return _str;
+    }
+
+private:
+
+    char _buf[boost::min_size_after_recycle<char>()];
+    std::string _str;
+};
+
+class derived_string_writer final: public base_string_writer
+{
+public:
+
+    void recycle() override
+    {
+        ++_recycle_count;
+        base_string_writer::recycle();
+    }
+
+    int recycle_count() const
+    {
+        return _recycle_count;
+    }
+
+private:
+
+    int _recycle_count = 0;
+};
+
+void test_ref_to_derived()
+{
+    // the override in the dynamic type is called
+    auto str = test_utils::make_string<char>(200);
+    derived_string_writer writer;
+    {
+        boost::static_outbuf_ref<base_string_writer> ref(writer);
+        write(ref, str.data(), str.size());
+    }
+    BOOST_TEST(writer.recycle_count() > 0);
+    BOOST_TEST_EQ(writer.finish(), str);
+}
+
+void test_dynamic_ref()
+{
+    small_static_string_writer<char> writer;
+    write(writer, "[");
+    {
+        boost::dynamic_outbuf_ref<small_static_string_writer<char>> ref(writer);
+        for (int i = 0; i < 20; ++i)
+        {
+            write_hello(ref);
+        }
+        BOOST_TEST(ref.good());
+    }
+    write(writer, "]");
+    std::string expected = "[";
+    for (int i = 0; i < 20; ++i)
+    {
+        expected += "Hello";
+    }
+    expected += "]";
+    BOOST_TEST_EQ(writer.finish(), expected);
+}
+
+void test_dynamic_ref_of_static_ref()
+{
+    char buff[200];
+    boost::cstr_writer writer(buff);
+    {
+        boost::static_outbuf_ref<boost::cstr_writer> sref(writer);
+        write(sref, boost::lit("<"));
+        {
+            boost::dynamic_outbuf_ref<boost::static_outbuf_ref<boost::cstr_writer>> dref(sref);
+            write_hello(dref);
+        }
+        write(sref, ">");
+    }
+    writer.finish();
+    BOOST_TEST_CSTR_EQ(buff, "<Hello>");
+}
+
+int main()
+{
+    test_crtp_writer<char>();
+    test_crtp_writer<char16_t>();
+    test_crtp_writer<char32_t>();
+    test_crtp_writer<wchar_t>();
+
+    test_cstr_writer_ref<char>();
+    test_cstr_writer_ref<char16_t>();
+    test_cstr_writer_ref<char32_t>();
+    test_cstr_writer_ref<wchar_t>();
+
+    test_cstr_writer_ref_truncated<char>();
+    test_cstr_writer_ref_truncated<char16_t>();
+
+    test_string_maker_ref<char>();
+    test_string_maker_ref<char16_t>();
+    test_string_maker_ref<char32_t>();
+    test_string_maker_ref<wchar_t>();
+
+    test_abstract_ref<char>();
+    test_abstract_ref<wchar_t>();
+
+    test_write_all<char>();
+    test_write_all<char16_t>();
+    test_write_all<wchar_t>();
+
+    test_ref_to_derived();
+    test_dynamic_ref();
+    test_dynamic_ref_of_static_ref();
+
+    return boost::report_errors();
+}
@@ -6,6 +6,7 @@
 #include <boost/outbuf/streambuf.hpp>
 #include <boost/core/lightweight_test.hpp>
 #include <sstream>
+#include <vector>
 
 template <typename CharT>
 void test_successfull_writing()
@@ -30,6 +31,74 @@ void test_successfull_writing()
     BOOST_TEST(obtained_content == expected_content);
 }
 
+template <typename CharT>
+void test_reset()
+{
+    auto tiny_str = test_utils::make_tiny_string<CharT>();
+    auto double_str = test_utils::make_double_string<CharT>();
+
+    std::basic_ostringstream<CharT> dest1;
+    std::basic_ostringstream<CharT> dest2;
+    boost::basic_streambuf_writer<CharT> writer(*dest1.rdbuf());
+    write(writer, double_str.data(), double_str.size());
+    writer.finish();
+
+    writer.reset(*dest2.rdbuf());
+    BOOST_TEST(writer.good());
+    write(writer, tiny_str.data(), tiny_str.size());
+    auto status = writer.finish();
+    BOOST_TEST(status.success);
+    BOOST_TEST_EQ(status.count, tiny_str.size());
+
+    writer.reset();
+    write(writer, double_str.data(), double_str.size());
+    status = writer.finish();
+    BOOST_TEST(status.success);
+    BOOST_TEST_EQ(status.count, double_str.size());
+
+    BOOST_TEST(dest1.str() == double_str);
+    BOOST_TEST(dest2.str() == tiny_str + double_str);
+}
+
+// Records the size of each block passed to sputn
+template <typename CharT>
+class recording_streambuf: public std::basic_stringbuf<CharT>
+{
+public:
+
+    std::vector<std::streamsize> blocks;
+
+protected:
+
+    std::streamsize xsputn(const CharT* s, std::streamsize n) override
+    {
+        blocks.push_back(n);
+        return std::basic_stringbuf<CharT>::xsputn(s, n);
+    }
+};
+
+template <typename CharT>
+void test_write_direct()
+{
+    auto tiny_str = test_utils::make_tiny_string<CharT>();
+    auto big_str = test_utils::make_string<CharT>(10000);
+
+    recording_streambuf<CharT> dest;
+    boost::basic_streambuf_writer<CharT> writer(dest);
+    BOOST_TEST(! writer.write_direct(tiny_str.data(), tiny_str.size()));
+    write(writer, tiny_str.data(), tiny_str.size());
+    write(writer, big_str.data(), big_str.size());
+    write(writer, tiny_str.data(), tiny_str.size());
+    auto status = writer.finish();
+
+    BOOST_TEST(status.success);
+    BOOST_TEST_EQ(status.count, 2 * tiny_str.size() + big_str.size());
+    BOOST_TEST(dest.str() == tiny_str + big_str + tiny_str);
+    // the big string is not copied into the buffer
+    BOOST_TEST_EQ(dest.blocks.size(), 3);
+    BOOST_TEST_EQ(dest.blocks[1], 10000);
+}
+
 template <typename CharT>
 void test_failing_to_recycle()
 {
@@ -86,6 +155,12 @@ int main()
     test_successfull_writing<char32_t>();
     test_successfull_writing<wchar_t>();
 
+    test_reset<char>();
+    test_reset<char32_t>();
+
+    test_write_direct<char>();
+    test_write_direct<char16_t>();
+
     test_failing_to_recycle<char>();
     test_failing_to_recycle<char16_t>();
     test_failing_to_recycle<char32_t>();
@@ -20,6 +20,20 @@ using string_appender = typename std::conditional
     , boost::basic_string_appender<CharT> >
     :: type;
 
+template <bool NoExcept, typename CharT >
+using direct_string_maker = typename std::conditional
+    < NoExcept
+    , boost::basic_direct_string_maker_noexcept<CharT>
+    , boost::basic_direct_string_maker<CharT> >
+    :: type;
+
+template <bool NoExcept, typename CharT >
+using direct_string_appender = typename std::conditional
+    < NoExcept
+    , boost::basic_direct_string_appender_noexcept<CharT>
+    , boost::basic_direct_string_appender<CharT> >
+    :: type;
+
 template <bool NoExcept, typename CharT>
 void test_successfull_append()
 {
@@ -48,6 +62,63 @@ void test_successfull_make()
     BOOST_TEST(ob.finish() == expected_content);
 }
 
+template <bool NoExcept, typename CharT>
+void test_make_with_reset()
+{
+    auto tiny_str = test_utils::make_tiny_string<CharT>();
+    auto big_str = test_utils::make_string<CharT>(1000);
+
+    string_maker<NoExcept, CharT> ob;
+    write(ob, big_str.c_str(), big_str.size());
+    std::basic_string<CharT> result;
+    ob.finish(result);
+    BOOST_TEST(result == big_str);
+
+    // the content written after reset() goes into
+    // the capacity of the string passed to finish
+    std::basic_string<CharT> other;
+    other.reserve(2000);
+    const CharT* data = other.data();
+    ob.reset();
+    ob.finish(other);
+    BOOST_TEST(other.empty());
+    ob.reset();
+    BOOST_TEST(ob.good());
+    write(ob, tiny_str.c_str(), tiny_str.size());
+    write(ob, big_str.c_str(), big_str.size());
+    ob.finish(other);
+    BOOST_TEST(other == tiny_str + big_str);
+    BOOST_TEST(other.data() == data);
+
+    ob.reset();
+    write(ob, tiny_str.c_str(), tiny_str.size());
+    BOOST_TEST(ob.finish() == tiny_str);
+}
+
+template <bool NoExcept, typename CharT>
+void test_write_direct()
+{
+    auto tiny_str = test_utils::make_tiny_string<CharT>();
+    auto big_str = test_utils::make_string<CharT>(1000);
+    auto expected_content = tiny_str + big_str + tiny_str;
+    {
+        string_maker<NoExcept, CharT> ob;
+        BOOST_TEST(! ob.write_direct(tiny_str.data(), tiny_str.size()));
+        write(ob, tiny_str.data(), tiny_str.size());
+        BOOST_TEST(ob.write_direct(big_str.data(), big_str.size()));
+        write(ob, tiny_str.data(), tiny_str.size());
+        BOOST_TEST(ob.finish() == expected_content);
+    }
+    {
+        std::basic_string<CharT> str = tiny_str;
+        string_appender<NoExcept, CharT> ob(str);
+        write(ob, big_str.data(), big_str.size());
+        write(ob, tiny_str.data(), tiny_str.size());
+        ob.finish();
+        BOOST_TEST(str == expected_content);
+    }
+}
+
 template <bool NoExcept, typename CharT>
 void test_corrupted_pos_too_small_on_recycle()
 {
@@ -227,6 +298,364 @@ void test_recycle_that_throws()
 }
 
 
+template <bool NoExcept, typename CharT>
+void test_direct_append()
+{
+    auto initial_str = test_utils::make_string<CharT>(10);
+    auto tiny_str = test_utils::make_tiny_string<CharT>();
+    auto big_str = test_utils::make_string<CharT>(1000);
+    auto expected_content = initial_str + tiny_str + big_str + tiny_str;
+
+    std::basic_string<CharT> str = initial_str;
+    {
+        direct_string_appender<NoExcept, CharT> ob(str);
+        BOOST_TEST(ob.pos() == &str[0] + initial_str.size());
+        write(ob, tiny_str.c_str(), tiny_str.size());
+        write(ob, big_str.c_str(), big_str.size());
+        BOOST_TEST(ob.end() == &str[0] + str.size());
+        write(ob, tiny_str.c_str(), tiny_str.size());
+        ob.finish();
+        BOOST_TEST(str == expected_content);
+        str.push_back(CharT('x'));
+    }
+    BOOST_TEST(str == expected_content + CharT('x'));
+}
+
+template <bool NoExcept, typename CharT>
+void test_direct_append_without_finish()
+{
+    auto initial_str = test_utils::make_string<CharT>(10);
+    auto half_str = test_utils::make_half_string<CharT>();
+    std::basic_string<CharT> str = initial_str;
+    {
+        direct_string_appender<NoExcept, CharT> ob(str);
+        write(ob, half_str.c_str(), half_str.size());
+        ob.recycle();
+        write(ob, half_str.c_str(), half_str.size());
+    }
+    BOOST_TEST(str == initial_str + half_str);
+}
+
+template <bool NoExcept, typename CharT>
+void test_direct_make()
+{
+    auto tiny_str = test_utils::make_tiny_string<CharT>();
+    auto big_str = test_utils::make_string<CharT>(5000);
+    auto expected_content = tiny_str + big_str + tiny_str;
+
+    direct_string_maker<NoExcept, CharT> ob;
+    write(ob, tiny_str.c_str(), tiny_str.size());
+    write(ob, big_str.c_str(), big_str.size());
+    write(ob, tiny_str.c_str(), tiny_str.size());
+    auto result = ob.finish();
+    BOOST_TEST(result == expected_content);
+    BOOST_TEST(! ob.good());
+}
+
+template <bool NoExcept, typename CharT>
+void test_direct_reserve()
+{
+    auto half_str = test_utils::make_half_string<CharT>();
+    auto big_str = test_utils::make_string<CharT>(300);
+    auto expected_content = half_str + big_str;
+    {
+        direct_string_maker<NoExcept, CharT> ob;
+        write(ob, half_str.c_str(), half_str.size());
+        ob.reserve(1000);
+        BOOST_TEST_GE(ob.size(), 1000 - half_str.size());
+        write(ob, big_str.c_str(), big_str.size());
+        auto result = ob.finish();
+        BOOST_TEST(result == expected_content);
+        BOOST_TEST_GE(result.capacity(), 1000);
+    }
+    {
+        std::basic_string<CharT> str = big_str;
+        direct_string_appender<NoExcept, CharT> ob(str);
+        write(ob, half_str.c_str(), half_str.size());
+        ob.reserve(1000);
+        BOOST_TEST_GE(ob.size(), 1000);
+        write(ob, big_str.c_str(), big_str.size());
+        ob.finish();
+        BOOST_TEST(str == big_str + half_str + big_str);
+        BOOST_TEST_GE(str.capacity(), big_str.size() + half_str.size() + 1000);
+    }
+}
+
+template <bool NoExcept, typename CharT>
+void test_direct_corrupted_pos()
+{
+    {
+        direct_string_maker<NoExcept, CharT> ob;
+        auto str = test_utils::make_string<CharT>(ob.size());
+        std::char_traits<CharT>::copy(ob.pos(), str.data(), str.size());
+        test_utils::force_set_pos(ob, ob.end() + 1);
+        ob.recycle();
+        BOOST_TEST(ob.finish() == str);
+    }
+    {
+        direct_string_maker<NoExcept, CharT> ob;
+        auto half_str = test_utils::make_half_string<CharT>();
+        write(ob, half_str.c_str(), half_str.size());
+        ob.recycle();
+        test_utils::force_set_pos(ob, ob.pos() - 1);
+        BOOST_TEST(ob.finish() == half_str);
+    }
+}
+
+template <typename T>
+class allocator_that_throws
+{
+public:
+    using value_type = T;
+
+    allocator_that_throws(bool* throw_flag)
+        : _throw_flag(throw_flag)
+    {
+    }
+    template <typename U>
+    allocator_that_throws(const allocator_that_throws<U>& other)
+        : _throw_flag(other._throw_flag)
+    {
+    }
+
+    T* allocate(std::size_t n)
+    {
+        if (*_throw_flag)
+        {
+            throw std::bad_alloc();
+        }
+        return std::allocator<T>().allocate(n);
+    }
+    void deallocate(T* p, std::size_t n)
+    {
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    bool operator==(const allocator_that_throws& other) const
+    {
+        return _throw_flag == other._throw_flag;
+    }
+    bool operator!=(const allocator_that_throws& other) const
+    {
+        return _throw_flag != other._throw_flag;
+    }
+
+    bool* _throw_flag;
+};
+
+template <typename CharT>
+void test_direct_recycle_catches_exception()
+{
+    using allocator = allocator_that_throws<CharT>;
+    using string_type
+        = std::basic_string<CharT, std::char_traits<CharT>, allocator>;
+    using appender_type = boost::basic_direct_string_appender_noexcept
+        < CharT, std::char_traits<CharT>, allocator >;
+
+    bool throw_flag = false;
+    auto half_str = test_utils::make_half_string<CharT>();
+    auto big_str = test_utils::make_string<CharT>(1000);
+
+    string_type str{allocator{&throw_flag}};
+    appender_type ob(str);
+    write(ob, half_str.c_str(), half_str.size());
+    ob.recycle();
+    BOOST_TEST(ob.good());
+
+    throw_flag = true;
+    write(ob, big_str.c_str(), big_str.size());
+    BOOST_TEST(!ob.good());
+    BOOST_TEST_THROWS(ob.finish(), std::bad_alloc);
+    BOOST_TEST(!ob.good());
+
+    // content written before the failure is kept
+    throw_flag = false;
+    auto expected = half_str + big_str;
+    BOOST_TEST_GE(str.size(), half_str.size());
+    BOOST_TEST_LT(str.size(), expected.size());
+    BOOST_TEST(std::equal(str.begin(), str.end(), expected.begin()));
+}
+
+template <typename CharT>
+void test_direct_recycle_that_throws()
+{
+    using allocator = allocator_that_throws<CharT>;
+    using string_type
+        = std::basic_string<CharT, std::char_traits<CharT>, allocator>;
+    using appender_type = boost::basic_direct_string_appender
+        < CharT, std::char_traits<CharT>, allocator >;
+
+    bool throw_flag = false;
+    auto half_str = test_utils::make_half_string<CharT>();
+    auto big_str = test_utils::make_string<CharT>(1000);
+
+    string_type str{allocator{&throw_flag}};
+    appender_type ob(str);
+    write(ob, half_str.c_str(), half_str.size());
+    ob.recycle();
+
+    throw_flag = true;
+    BOOST_TEST_THROWS(write(ob, big_str.c_str(), big_str.size()), std::bad_alloc);
+    BOOST_TEST(!ob.good());
+    throw_flag = false;
+
+    write(ob, half_str.c_str(), half_str.size());
+    ob.recycle(); // must be no-op
+    BOOST_TEST(!ob.good());
+    ob.finish();
+    auto expected = half_str + big_str;
+    BOOST_TEST_GE(str.size(), half_str.size());
+    BOOST_TEST_LT(str.size(), expected.size());
+    BOOST_TEST(std::equal(str.begin(), str.end(), expected.begin()));
+}
+
+
+template <bool NoExcept, typename CharT>
+void test_allocator_is_used()
+{
+    using allocator = allocator_that_throws<CharT>;
+    using traits = std::char_traits<CharT>;
+    using maker_type = typename std::conditional
+        < NoExcept
+        , boost::basic_string_maker_noexcept<CharT, traits, allocator>
+        , boost::basic_string_maker<CharT, traits, allocator> >
+        :: type;
+    using appender_type = typename std::conditional
+        < NoExcept
+        , boost::basic_string_appender_noexcept<CharT, traits, allocator>
+        , boost::basic_string_appender<CharT, traits, allocator> >
+        :: type;
+    using direct_maker_type = typename std::conditional
+        < NoExcept
+        , boost::basic_direct_string_maker_noexcept<CharT, traits, allocator>
+        , boost::basic_direct_string_maker<CharT, traits, allocator> >
+        :: type;
+
+    static_assert( std::is_same
+                     < typename maker_type::string_type
+                     , std::basic_string<CharT, traits, allocator> >
+                     :: value
+                 , "Allocator ignored" );
+    static_assert( std::is_same
+                     < typename appender_type::string_type
+                     , std::basic_string<CharT, traits, allocator> >
+                     :: value
+                 , "Allocator ignored" );
+
+    bool throw_flag = false;
+    auto double_str = test_utils::make_double_string<CharT>();
+    {
+        maker_type ob{allocator{&throw_flag}};
+        write(ob, double_str.c_str(), double_str.size());
+        auto result = ob.finish();
+        BOOST_TEST(result.get_allocator()._throw_flag == &throw_flag);
+        BOOST_TEST(std::equal(result.begin(), result.end(), double_str.begin()));
+        BOOST_TEST_EQ(result.size(), double_str.size());
+    }
+    {
+        direct_maker_type ob{allocator{&throw_flag}};
+        write(ob, double_str.c_str(), double_str.size());
+        auto result = ob.finish();
+        BOOST_TEST(result.get_allocator()._throw_flag == &throw_flag);
+        BOOST_TEST(std::equal(result.begin(), result.end(), double_str.begin()));
+        BOOST_TEST_EQ(result.size(), double_str.size());
+    }
+    {
+        std::basic_string<CharT, traits, allocator> str{allocator{&throw_flag}};
+        appender_type ob(str);
+        write(ob, double_str.c_str(), double_str.size());
+        ob.finish();
+        BOOST_TEST(std::equal(str.begin(), str.end(), double_str.begin()));
+        BOOST_TEST_EQ(str.size(), double_str.size());
+    }
+}
+
+#if defined(__cpp_lib_memory_resource)
+
+template <typename StringMaker>
+void test_pmr_string_maker()
+{
+    auto double_str = test_utils::make_string<char>(1000);
+    char arena_buf[4096];
+    std::pmr::monotonic_buffer_resource arena
+        ( arena_buf, sizeof(arena_buf), std::pmr::null_memory_resource() );
+
+    StringMaker ob(&arena);
+    write(ob, double_str.c_str(), double_str.size());
+    std::pmr::string result = ob.finish();
+    BOOST_TEST(result.get_allocator().resource() == &arena);
+    BOOST_TEST(result == double_str.c_str());
+}
+
+template <typename StringAppender>
+void test_pmr_string_appender()
+{
+    auto double_str = test_utils::make_string<char>(1000);
+    char arena_buf[4096];
+    std::pmr::monotonic_buffer_resource arena
+        ( arena_buf, sizeof(arena_buf), std::pmr::null_memory_resource() );
+
+    std::pmr::string str(&arena);
+    StringAppender ob(str);
+    write(ob, double_str.c_str(), double_str.size());
+    ob.finish();
+    BOOST_TEST(str == double_str.c_str());
+}
+
+#endif // defined(__cpp_lib_memory_resource)
+
+template <bool NoExcept, typename CharT>
+void test_reserve_contiguous()
+{
+    auto half_str = test_utils::make_half_string<CharT>();
+    auto big_str = test_utils::make_string<CharT>(10000);
+    constexpr auto min_size = boost::min_size_after_recycle<CharT>();
+    {
+        string_maker<NoExcept, CharT> ob;
+        BOOST_TEST_EQ(ob.max_contiguous(), min_size);
+        write(ob, half_str.c_str(), half_str.size());
+        BOOST_TEST(! ob.reserve_contiguous(min_size + 1));
+        BOOST_TEST(ob.reserve_contiguous(min_size));
+        BOOST_TEST(ob.finish() == half_str);
+    }
+    {
+        direct_string_maker<NoExcept, CharT> ob;
+        BOOST_TEST_GE(ob.max_contiguous(), big_str.size());
+        write(ob, half_str.c_str(), half_str.size());
+        BOOST_TEST(ob.reserve_contiguous(big_str.size()));
+        BOOST_TEST_GE(ob.size(), big_str.size());
+        std::char_traits<CharT>::copy(ob.pos(), big_str.data(), big_str.size());
+        ob.advance(big_str.size());
+        BOOST_TEST(ob.finish() == half_str + big_str);
+        BOOST_TEST_EQ(ob.max_contiguous(), min_size);
+    }
+}
+
+template <typename CharT>
+void test_make_string_two_pass()
+{
+    auto half_str = test_utils::make_half_string<CharT>();
+    auto big_str = test_utils::make_string<CharT>(10000);
+    const auto min_size = boost::min_size_after_recycle<CharT>();
+    int calls = 0;
+    auto result = boost::make_string_two_pass<CharT>
+        ( [&](boost::basic_outbuf<CharT>& ob) {
+              ++calls;
+              write(ob, half_str.c_str(), half_str.size());
+              write(ob, big_str.c_str(), big_str.size());
+              // requires more than it writes
+              ob.require(min_size);
+              put(ob, CharT('x'));
+          } );
+    BOOST_TEST_EQ(calls, 2);
+    BOOST_TEST(result == half_str + big_str + CharT('x'));
+    // No reallocation happened, which would at least double the capacity
+    BOOST_TEST_LT(result.capacity(), result.size() + 2 * min_size);
+
+    auto empty = boost::make_string_two_pass<CharT>([](boost::basic_outbuf<CharT>&){});
+    BOOST_TEST(empty.empty());
+}
+
 int main()
 {
     test_successfull_append<true, char>();
@@ -239,6 +668,13 @@ int main()
     test_successfull_make<false, char>();
     test_successfull_make<false, char16_t>();
 
+    test_make_with_reset<true, char>();
+    test_make_with_reset<false, char32_t>();
+    test_write_direct<true, char>();
+    test_write_direct<false, char>();
+    test_write_direct<true, char16_t>();
+    test_write_direct<false, wchar_t>();
+
     test_corrupted_pos_too_small_on_recycle<true, char>();
     test_corrupted_pos_too_small_on_recycle<true, char16_t>();
     test_corrupted_pos_too_small_on_recycle<false, char>();
@@ -264,5 +700,53 @@ int main()
     test_recycle_that_throws<char>();
     test_recycle_that_throws<char16_t>();
 
+    test_direct_append<true, char>();
+    test_direct_append<true, char16_t>();
+    test_direct_append<false, char>();
+    test_direct_append<false, char32_t>();
+
+    test_direct_append_without_finish<true, char>();
+    test_direct_append_without_finish<false, wchar_t>();
+
+    test_direct_make<true, char>();
+    test_direct_make<true, char16_t>();
+    test_direct_make<false, char>();
+    test_direct_make<false, char32_t>();
+
+    test_direct_reserve<true, char>();
+    test_direct_reserve<false, char16_t>();
+
+    test_direct_corrupted_pos<true, char>();
+    test_direct_corrupted_pos<false, char16_t>();
+
+    test_direct_recycle_catches_exception<char>();
+    test_direct_recycle_catches_exception<char16_t>();
+    test_direct_recycle_that_throws<char>();
+    test_direct_recycle_that_throws<wchar_t>();
+
+    test_reserve_contiguous<true, char>();
+    test_reserve_contiguous<false, char16_t>();
+
+    test_allocator_is_used<true, char>();
+    test_allocator_is_used<false, char>();
+    test_allocator_is_used<false, char16_t>();
+
+    test_make_string_two_pass<char>();
+    test_make_string_two_pass<char16_t>();
+
+#if defined(__cpp_lib_memory_resource)
+
+    test_pmr_string_maker<boost::pmr_string_maker>();
+    test_pmr_string_maker<boost::pmr_string_maker_noexcept>();
+    test_pmr_string_maker<boost::pmr_direct_string_maker>();
+    test_pmr_string_maker<boost::pmr_direct_string_maker_noexcept>();
+
+    test_pmr_string_appender<boost::pmr_string_appender>();
+    test_pmr_string_appender<boost::pmr_string_appender_noexcept>();
+    test_pmr_string_appender<boost::pmr_direct_string_appender>();
+    test_pmr_string_appender<boost::pmr_direct_string_appender_noexcept>();
+
+#endif // defined(__cpp_lib_memory_resource)
+
     return boost::report_errors();
 }
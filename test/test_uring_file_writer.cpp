@@ -0,0 +1,218 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/core/lightweight_test.hpp>
+#include <boost/outbuf/uring.hpp>
+
+#if defined(BOOST_OUTBUF_HAS_URING)
+
+#include <cstdio>
+#include <fcntl.h>
+#include "test_utils.hpp"
+
+template <typename CharT>
+void test_successfull_writing()
+{
+    auto tiny_str = test_utils::make_tiny_string<CharT>();
+    auto double_str = test_utils::make_double_string<CharT>();
+
+    std::FILE* file = std::tmpfile();
+    boost::basic_uring_file_writer<CharT> writer(fileno(file));
+    auto expected_content = tiny_str + double_str;
+
+    write(writer, tiny_str.data(), tiny_str.size());
+    write(writer, double_str.data(), double_str.size());
+    auto status = writer.finish();
+    const auto file_offset = ::lseek(fileno(file), 0, SEEK_CUR);
+    std::rewind(file);
+    auto obtained_content = test_utils::read_file<CharT>(file);
+    std::fclose(file);
+
+    BOOST_TEST(status.success);
+    BOOST_TEST_EQ(status.errnum, 0);
+    BOOST_TEST_EQ(status.count, expected_content.size() * sizeof(CharT));
+    BOOST_TEST_EQ(file_offset, static_cast<::off_t>(status.count));
+    BOOST_TEST(obtained_content == expected_content);
+}
+
+template <typename CharT>
+void test_many_buffers(unsigned buffers_count)
+{
+    const std::size_t buf_size = boost::min_size_after_recycle<CharT>();
+    auto half_str = test_utils::make_half_string<CharT>();
+    auto big_str = test_utils::make_string<CharT>(buf_size * 100 + 3);
+
+    std::FILE* file = std::tmpfile();
+    boost::basic_uring_file_writer<CharT> writer(fileno(file), buf_size, buffers_count);
+    BOOST_TEST_EQ(writer.buffer_size(), buf_size);
+    BOOST_TEST_EQ(writer.buffers_count(), buffers_count);
+    BOOST_TEST_EQ(writer.max_contiguous(), buf_size);
+    if (buffers_count == 1)
+    {
+        BOOST_TEST(! writer.uses_io_uring());
+    }
+    auto expected_content = half_str + big_str + half_str;
+
+    write(writer, half_str.data(), half_str.size());
+    write(writer, big_str.data(), big_str.size());
+    writer.recycle();
+    writer.recycle(); // nothing to write
+    write(writer, half_str.data(), half_str.size());
+    auto status = writer.finish();
+    std::rewind(file);
+    auto obtained_content = test_utils::read_file<CharT>(file);
+    std::fclose(file);
+
+    BOOST_TEST(status.success);
+    BOOST_TEST_EQ(status.count, expected_content.size() * sizeof(CharT));
+    BOOST_TEST(obtained_content == expected_content);
+}
+
+void test_writing_at_offset()
+{
+    auto initial_content = test_utils::make_string<char>(10000);
+    auto str = test_utils::make_string<char>(3000);
+
+    std::FILE* file = std::tmpfile();
+    std::fwrite(initial_content.data(), 1, initial_content.size(), file);
+    std::fflush(file);
+    ::lseek(fileno(file), 5000, SEEK_SET);
+    boost::uring_file_writer writer(fileno(file), 1000, 3);
+    write(writer, str.data(), str.size());
+    auto status = writer.finish();
+    std::rewind(file);
+    auto obtained_content = test_utils::read_file<char>(file);
+    std::fclose(file);
+
+    auto expected_content = initial_content;
+    expected_content.replace(5000, str.size(), str);
+    BOOST_TEST(status.success);
+    BOOST_TEST_EQ(status.count, str.size());
+    BOOST_TEST(obtained_content == expected_content);
+}
+
+template <typename CharT>
+void test_failing_to_recycle()
+{
+    auto half_str = test_utils::make_half_string<CharT>();
+    auto double_str = test_utils::make_double_string<CharT>();
+    auto expected_content = half_str;
+
+    std::FILE* file = std::tmpfile();
+    boost::basic_uring_file_writer<CharT> writer(fileno(file));
+
+    write(writer, half_str.data(), half_str.size());
+    writer.recycle(); // first recycle shall work
+    test_utils::turn_into_bad(writer);
+    write(writer, double_str.data(), double_str.size());
+
+    auto status = writer.finish();
+    std::rewind(file);
+    auto obtained_content = test_utils::read_file<CharT>(file);
+    std::fclose(file);
+
+    BOOST_TEST(! status.success);
+    BOOST_TEST_EQ(status.count, obtained_content.size() * sizeof(CharT));
+    BOOST_TEST(obtained_content == expected_content);
+}
+
+template <typename CharT>
+void test_failing_to_finish()
+{
+    auto double_str = test_utils::make_double_string<CharT>();
+    auto half_str = test_utils::make_half_string<CharT>();
+    auto expected_content = double_str;
+
+    std::FILE* file = std::tmpfile();
+    boost::basic_uring_file_writer<CharT> writer(fileno(file));
+
+    write(writer, double_str.data(), double_str.size());
+    writer.recycle();
+    write(writer, half_str.data(), half_str.size());
+    test_utils::turn_into_bad(writer);
+
+    auto status = writer.finish();
+    std::rewind(file);
+    auto obtained_content = test_utils::read_file<CharT>(file);
+    std::fclose(file);
+
+    BOOST_TEST(! status.success);
+    BOOST_TEST_EQ(status.count, obtained_content.size() * sizeof(CharT));
+    BOOST_TEST(obtained_content == expected_content);
+}
+
+void test_write_error(unsigned buffers_count)
+{
+    // The error is reported by the completion, or by ::pwrite
+    std::string filename = test_utils::unique_tmp_file_name();
+    std::FILE* file = std::fopen(filename.c_str(), "w");
+    std::fclose(file);
+    int fd = ::open(filename.c_str(), O_RDONLY);
+
+    auto str = test_utils::make_string<char>(5000);
+    boost::uring_file_writer writer(fd, 1000, buffers_count);
+    write(writer, str.data(), str.size());
+    auto status = writer.finish();
+    ::close(fd);
+    std::remove(filename.c_str());
+
+    BOOST_TEST(! status.success);
+    BOOST_TEST_EQ(status.errnum, EBADF);
+    BOOST_TEST_EQ(status.count, 0);
+}
+
+void test_invalid_fd()
+{
+    std::FILE* file = std::tmpfile();
+    int fd = dup(fileno(file));
+    std::fclose(file);
+    close(fd);
+
+    auto str = test_utils::make_double_string<char>();
+    boost::uring_file_writer writer(fd);
+    BOOST_TEST(! writer.good());
+    write(writer, str.data(), str.size());
+    auto status = writer.finish();
+
+    BOOST_TEST(! status.success);
+    BOOST_TEST_EQ(status.errnum, EBADF);
+    BOOST_TEST_EQ(status.count, 0);
+}
+
+int main()
+{
+    test_successfull_writing<char>();
+    test_successfull_writing<char16_t>();
+    test_successfull_writing<char32_t>();
+    test_successfull_writing<wchar_t>();
+
+    test_many_buffers<char>(1);
+    test_many_buffers<char>(2);
+    test_many_buffers<char>(4);
+    test_many_buffers<char16_t>(3);
+    test_many_buffers<char32_t>(8);
+
+    test_writing_at_offset();
+
+    test_failing_to_recycle<char>();
+    test_failing_to_recycle<char32_t>();
+
+    test_failing_to_finish<char>();
+    test_failing_to_finish<char32_t>();
+
+    test_write_error(1);
+    test_write_error(4);
+    test_invalid_fd();
+
+    return boost::report_errors();
+}
+
+#else
+
+int main()
+{
+    return boost::report_errors();
+}
+
+#endif
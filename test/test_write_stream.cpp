@@ -0,0 +1,113 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/core/lightweight_test.hpp>
+#include <boost/outbuf/stream.hpp>
+#include <boost/outbuf/string.hpp>
+#include <vector>
+#include "test_utils.hpp"
+
+const boost::stream_copy_kernel kernels[] =
+    { boost::stream_copy_kernel::plain
+    , boost::stream_copy_kernel::avx2
+    , boost::stream_copy_kernel::avx512 };
+
+void test_kernels()
+{
+    // All alignments of the destination, and sizes that
+    // are and are not multiple of the vector size
+    std::vector<std::uint8_t> src(5000);
+    for (std::size_t i = 0; i < src.size(); ++i)
+    {
+        src[i] = static_cast<std::uint8_t>(i * 7);
+    }
+    std::vector<std::uint8_t> dest(src.size() + 64);
+    for (auto k: kernels)
+    {
+        auto copy = boost::detail::stream_copy_function_of(k);
+        for (std::size_t offset = 0; offset < 64; offset += 7)
+        {
+            for (std::size_t len : {256, 1000, 4096, 4099, 4931})
+            {
+                std::fill(dest.begin(), dest.end(), 0);
+                copy(&dest[offset], &src[offset], len);
+                BOOST_TEST(std::equal(src.begin() + offset, src.begin() + offset + len, &dest[offset]));
+                BOOST_TEST_EQ(dest[offset + len], 0);
+                if (offset != 0)
+                {
+                    BOOST_TEST_EQ(dest[offset - 1], 0);
+                }
+            }
+        }
+    }
+}
+
+void test_kernel_supported()
+{
+    BOOST_TEST(boost::stream_copy_kernel_supported(boost::stream_copy_kernel::plain));
+    BOOST_TEST(boost::stream_copy_kernel_supported(boost::stream_copy_best_kernel()));
+}
+
+template <typename CharT>
+void test_cstr_writer()
+{
+    auto tiny_str = test_utils::make_tiny_string<CharT>();
+    auto big_str = test_utils::make_string<CharT>(3000);
+    auto expected = tiny_str + big_str + tiny_str;
+    std::vector<CharT> buff(expected.size() + 1);
+    for (auto k: kernels)
+    {
+        boost::basic_cstr_writer<CharT> writer(buff.data(), buff.size());
+        boost::write_stream(writer, tiny_str.data(), tiny_str.size(), 512, k);
+        boost::write_stream(writer, big_str.data(), big_str.size(), 512, k);
+        boost::write_stream(writer, tiny_str.data(), tiny_str.size(), 512, k);
+        auto res = writer.finish();
+        BOOST_TEST(! res.truncated);
+        BOOST_TEST(std::basic_string<CharT>(buff.data(), res.ptr) == expected);
+    }
+}
+
+template <typename CharT>
+void test_cstr_writer_truncated()
+{
+    auto big_str = test_utils::make_string<CharT>(3000);
+    std::vector<CharT> buff(1001);
+    boost::basic_cstr_writer<CharT> writer(buff.data(), buff.size());
+    boost::write_stream(writer, big_str.data(), big_str.size(), 512);
+    auto res = writer.finish();
+    BOOST_TEST(res.truncated);
+    BOOST_TEST(std::basic_string<CharT>(buff.data(), res.ptr) == big_str.substr(0, 1000));
+}
+
+template <typename CharT>
+void test_small_buffer_writer()
+{
+    // The first write goes through write_direct. The second one
+    // doesn't, since as_underlying() has no write_direct, so the
+    // string is copied in chunks of the size of the buffer
+    auto big_str = test_utils::make_string<CharT>(3000);
+    boost::basic_string_maker<CharT> writer;
+    boost::write_stream(writer, big_str.data(), big_str.size(), 512);
+    boost::write_stream(writer.as_underlying(), reinterpret_cast<const boost::underlying_outbuf_char_type<sizeof(CharT)>*>(big_str.data()), big_str.size(), 512);
+    BOOST_TEST(writer.finish() == big_str + big_str);
+}
+
+int main()
+{
+    test_kernels();
+    test_kernel_supported();
+
+    test_cstr_writer<char>();
+    test_cstr_writer<char16_t>();
+    test_cstr_writer<char32_t>();
+    test_cstr_writer<wchar_t>();
+
+    test_cstr_writer_truncated<char>();
+    test_cstr_writer_truncated<char32_t>();
+
+    test_small_buffer_writer<char>();
+    test_small_buffer_writer<char16_t>();
+
+    return boost::report_errors();
+}